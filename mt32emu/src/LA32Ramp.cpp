@@ -137,6 +137,36 @@ Bit32u LA32Ramp::nextValue() {
 	return current;
 }
 
+Bit32u LA32Ramp::nextValues(Bit32u *values, Bit32u length) {
+	Bit32u count = 0;
+	while (count < length) {
+		if (interruptCountdown > 0) {
+			// The target has been reached, the value stays the same until the interrupt is raised
+			Bit32u steadyCount = length - count;
+			if (steadyCount >= Bit32u(interruptCountdown)) {
+				steadyCount = Bit32u(interruptCountdown);
+				interruptRaised = true;
+			}
+			interruptCountdown -= steadyCount;
+			for (Bit32u i = 0; i < steadyCount; i++) {
+				values[count++] = current;
+			}
+			if (interruptRaised) break;
+		} else if (largeIncrement == 0) {
+			// The value never changes and no interrupt is going to happen
+			while (count < length) {
+				values[count++] = current;
+			}
+		} else {
+			// Ramping, continue until the target is reached which starts the countdown
+			while (count < length && interruptCountdown == 0) {
+				values[count++] = nextValue();
+			}
+		}
+	}
+	return count;
+}
+
 bool LA32Ramp::checkInterrupt() {
 	bool wasRaised = interruptRaised;
 	interruptRaised = false;
@@ -161,4 +191,8 @@ bool LA32Ramp::isBelowCurrent(Bit8u target) const {
 	return Bit32u(target << TARGET_SHIFTS) < current;
 }
 
+Bit32u LA32Ramp::getCurrentValue() const {
+	return current;
+}
+
 } // namespace MT32Emu
@@ -37,9 +37,14 @@ public:
 	LA32Ramp();
 	void startRamp(Bit8u target, Bit8u increment);
 	Bit32u nextValue();
+	// Same as invoking nextValue() up to length times, storing the values in the provided buffer. Stops early right after
+	// the value which raises an interrupt, so that the caller can check and handle it before advancing the ramp any further.
+	// Returns the number of values produced.
+	Bit32u nextValues(Bit32u *values, Bit32u length);
 	bool checkInterrupt();
 	void reset();
 	bool isBelowCurrent(Bit8u target) const;
+	Bit32u getCurrentValue() const;
 };
 
 } // namespace MT32Emu
@@ -216,6 +216,21 @@ void LA32WaveGenerator::pcmSampleToLogSample(LogSample &logSample, const Bit16s
 	logSample.sign = pcmSample < 0 ? LogSample::NEGATIVE : LogSample::POSITIVE;
 }
 
+Bit32u LA32WaveGenerator::getSecondPCMWaveTableIx(Bit32u pcmWaveTableIx, bool &silent) const {
+	silent = false;
+	if (pcmWaveInterpolated) {
+		pcmWaveTableIx++;
+		if (pcmWaveTableIx < pcmWaveLength) {
+			return pcmWaveTableIx;
+		}
+		if (pcmWaveLooped) {
+			return pcmWaveTableIx - pcmWaveLength;
+		}
+	}
+	silent = true;
+	return 0;
+}
+
 void LA32WaveGenerator::generateNextPCMWaveLogSamples() {
 	// This should emulate the ladder we see in the PCM captures for pitches 01, 02, 07, etc.
 	// The most probable cause is the factor in the interpolation formula is one bit less
@@ -223,28 +238,28 @@ void LA32WaveGenerator::generateNextPCMWaveLogSamples() {
 	pcmInterpolationFactor = (wavePosition & 255) >> 1;
 	Bit32u pcmWaveTableIx = wavePosition >> 8;
 	pcmSampleToLogSample(firstPCMLogSample, pcmWaveAddress[pcmWaveTableIx]);
-	if (pcmWaveInterpolated) {
-		pcmWaveTableIx++;
-		if (pcmWaveTableIx < pcmWaveLength) {
-			pcmSampleToLogSample(secondPCMLogSample, pcmWaveAddress[pcmWaveTableIx]);
-		} else {
-			if (pcmWaveLooped) {
-				pcmWaveTableIx -= pcmWaveLength;
-				pcmSampleToLogSample(secondPCMLogSample, pcmWaveAddress[pcmWaveTableIx]);
-			} else {
-				secondPCMLogSample = SILENCE;
-			}
-		}
-	} else {
+	bool secondSampleSilent;
+	pcmWaveTableIx = getSecondPCMWaveTableIx(pcmWaveTableIx, secondSampleSilent);
+	if (secondSampleSilent) {
 		secondPCMLogSample = SILENCE;
+	} else {
+		pcmSampleToLogSample(secondPCMLogSample, pcmWaveAddress[pcmWaveTableIx]);
 	}
+	advancePCMWavePosition();
+}
+
+Bit32u LA32WaveGenerator::getPCMSampleStep(const Bit16u pitch) {
 	// pcmSampleStep = (Bit32u)EXP2F(pitch / 4096.0f + 3.0f);
 	Bit32u pcmSampleStep = LA32Utilites::interpolateExp(~pitch & 4095);
 	pcmSampleStep <<= pitch >> 12;
 	// Seeing the actual lengths of the PCM wave for pitches 00..12,
 	// the pcmPosition counter can be assumed to have 8-bit fractions
 	pcmSampleStep >>= 9;
-	wavePosition += pcmSampleStep;
+	return pcmSampleStep;
+}
+
+void LA32WaveGenerator::advancePCMWavePosition() {
+	wavePosition += getPCMSampleStep(pitch);
 	if (wavePosition >= (pcmWaveLength << 8)) {
 		if (pcmWaveLooped) {
 			wavePosition -= pcmWaveLength << 8;
@@ -254,6 +269,60 @@ void LA32WaveGenerator::generateNextPCMWaveLogSamples() {
 	}
 }
 
+void LA32WaveGenerator::generateNextPCMWavePositions(const Bit32u useAmp, const Bit16u usePitch, LA32PCMWaveBlock &block, const Bit32u position) {
+	if (!active) {
+		block.amps[position] = 0;
+		block.firstSampleIndices[position] = 0;
+		block.secondSampleIndices[position] = 0;
+		block.firstSampleMasks[position] = 0;
+		block.secondSampleMasks[position] = 0;
+		block.interpolationFactors[position] = 0;
+		return;
+	}
+
+	amp = useAmp;
+	pitch = usePitch;
+
+	pcmInterpolationFactor = (wavePosition & 255) >> 1;
+	Bit32u pcmWaveTableIx = wavePosition >> 8;
+	bool secondSampleSilent;
+	Bit32u secondPCMWaveTableIx = getSecondPCMWaveTableIx(pcmWaveTableIx, secondSampleSilent);
+	MT32EMU_PREFETCH(pcmWaveAddress + pcmWaveTableIx);
+	block.amps[position] = amp;
+	block.firstSampleIndices[position] = pcmWaveTableIx;
+	block.secondSampleIndices[position] = secondPCMWaveTableIx;
+	block.interpolationFactors[position] = Bit16u(pcmInterpolationFactor);
+	advancePCMWavePosition();
+	// Note, the output of a WG is silent once it is deactivated, even though the log samples have been generated.
+	block.firstSampleMasks[position] = active ? -1 : 0;
+	block.secondSampleMasks[position] = (active && !secondSampleSilent) ? -1 : 0;
+}
+
+Bit32u LA32WaveGenerator::getPCMWaveSampleCount(const Bit16u usePitch, const Bit32u maxCount) const {
+	if (!active) return 0;
+	if (pcmWaveLooped) return maxCount;
+	Bit32u pcmSampleStep = getPCMSampleStep(usePitch);
+	if (pcmSampleStep == 0) return maxCount;
+	Bit32u remainingLength = (pcmWaveLength << 8) - wavePosition;
+	Bit32u sampleCount = (remainingLength + pcmSampleStep - 1) / pcmSampleStep;
+	return sampleCount < maxCount ? sampleCount : maxCount;
+}
+
+void LA32WaveGenerator::skipPCMWaveSamples(const Bit16u usePitch, const Bit32u count) {
+	if (!active || count == 0) return;
+	pitch = usePitch;
+	// Can't overflow, as the step doesn't exceed 2^19 and the count is limited by the rendering buffer size.
+	wavePosition += getPCMSampleStep(pitch) * count;
+	const Bit32u pcmWaveLengthWithFraction = pcmWaveLength << 8;
+	if (wavePosition >= pcmWaveLengthWithFraction) {
+		if (pcmWaveLooped) {
+			wavePosition %= pcmWaveLengthWithFraction;
+		} else {
+			deactivate();
+		}
+	}
+}
+
 void LA32WaveGenerator::initSynth(const bool useSawtoothWaveform, const Bit8u usePulseWidth, const Bit8u useResonance) {
 	sawtoothWaveform = useSawtoothWaveform;
 	pulseWidth = usePulseWidth;
@@ -337,6 +406,10 @@ Bit32u LA32WaveGenerator::getPCMInterpolationFactor() const {
 	return pcmInterpolationFactor;
 }
 
+const Bit16s *LA32WaveGenerator::getPCMWaveAddress() const {
+	return pcmWaveAddress;
+}
+
 void LA32IntPartialPair::init(const bool useRingModulated, const bool useMixed) {
 	ringModulated = useRingModulated;
 	mixed = useMixed;
@@ -408,6 +481,104 @@ Bit16s LA32IntPartialPair::nextOutSample() {
 	return mixed ? masterSample + ringModulatedSample : ringModulatedSample;
 }
 
+static inline void captureLogSample(LA32IntPartialPairOutputBlock &block, const int logSampleIx, const Bit32u position, const LogSample &logSample) {
+	block.logValues[logSampleIx][position] = logSample.logValue;
+	block.signMasks[logSampleIx][position] = logSample.sign == LogSample::POSITIVE ? 0 : -1;
+}
+
+void LA32IntPartialPair::captureOutputLogSamples(LA32IntPartialPairOutputBlock &block, const Bit32u position) const {
+	captureLogSample(block, LA32IntPartialPairOutputBlock::MASTER_FIRST, position, master.getOutputLogSample(true));
+	captureLogSample(block, LA32IntPartialPairOutputBlock::MASTER_SECOND, position, master.getOutputLogSample(false));
+	captureLogSample(block, LA32IntPartialPairOutputBlock::SLAVE_FIRST, position, slave.getOutputLogSample(true));
+	captureLogSample(block, LA32IntPartialPairOutputBlock::SLAVE_SECOND, position, slave.getOutputLogSample(false));
+	block.masterPCMInterpolationFactors[position] = master.isPCMWave() ? Bit16u(master.getPCMInterpolationFactor()) : 0;
+	block.slavePCMInterpolationFactors[position] = slave.isPCMWave() ? Bit16u(slave.getPCMInterpolationFactor()) : 0;
+}
+
+// Branchless equivalent of LA32Utilites::unlog() with the table lookups hoisted, suitable for vectorisation.
+// Note, a silent log sample (which is captured for an inactive WG) always yields 0.
+static inline Bit16s unlogSample(const Bit16u *exp9, const Bit16u logValue, const Bit16s signMask) {
+	Bit16u fract = logValue & 4095;
+	Bit16u expTabIndex = fract >> 3;
+	Bit16u extraBits = ~fract & 7;
+	Bit16u expTabEntry2 = 8191 - exp9[expTabIndex];
+	Bit16u expTabEntry1 = expTabIndex == 0 ? 8191 : (8191 - exp9[expTabIndex - (expTabIndex != 0)]);
+	Bit16u interpolatedExp = expTabEntry2 + (((expTabEntry1 - expTabEntry2) * extraBits) >> 3);
+	Bit16s sample = interpolatedExp >> (logValue >> 12);
+	return Bit16s((sample ^ signMask) - signMask);
+}
+
+static inline Bit16s mixWGOutput(const Bit16s firstSample, const Bit16s secondSample, const bool pcmWave, const Bit16u pcmInterpolationFactor) {
+	if (pcmWave) {
+		return Bit16s(firstSample + (((Bit32s(secondSample) - Bit32s(firstSample)) * pcmInterpolationFactor) >> 7));
+	}
+	return firstSample + secondSample;
+}
+
+void LA32IntPartialPair::produceOutputBlock(const LA32IntPartialPairOutputBlock &block, Bit16s *outSamples, const Bit32u length) const {
+	typedef LA32IntPartialPairOutputBlock Block;
+
+	const Bit16u *exp9 = Tables::getInstance().exp9;
+	const bool masterPCMWave = master.isPCMWave();
+	const bool slavePCMWave = slave.isPCMWave();
+
+	if (!ringModulated) {
+		for (Bit32u i = 0; i < length; i++) {
+			Bit16s masterSample = mixWGOutput(unlogSample(exp9, block.logValues[Block::MASTER_FIRST][i], block.signMasks[Block::MASTER_FIRST][i]),
+				unlogSample(exp9, block.logValues[Block::MASTER_SECOND][i], block.signMasks[Block::MASTER_SECOND][i]),
+				masterPCMWave, block.masterPCMInterpolationFactors[i]);
+			Bit16s slaveSample = mixWGOutput(unlogSample(exp9, block.logValues[Block::SLAVE_FIRST][i], block.signMasks[Block::SLAVE_FIRST][i]),
+				unlogSample(exp9, block.logValues[Block::SLAVE_SECOND][i], block.signMasks[Block::SLAVE_SECOND][i]),
+				slavePCMWave, block.slavePCMInterpolationFactors[i]);
+			outSamples[i] = masterSample + slaveSample;
+		}
+		return;
+	}
+
+	for (Bit32u i = 0; i < length; i++) {
+		Bit16s masterSample = mixWGOutput(unlogSample(exp9, block.logValues[Block::MASTER_FIRST][i], block.signMasks[Block::MASTER_FIRST][i]),
+			unlogSample(exp9, block.logValues[Block::MASTER_SECOND][i], block.signMasks[Block::MASTER_SECOND][i]),
+			masterPCMWave, block.masterPCMInterpolationFactors[i]);
+		// No interpolation is applied to the slave PCM partial, see nextOutSample().
+		Bit16s slaveFirstSample = unlogSample(exp9, block.logValues[Block::SLAVE_FIRST][i], block.signMasks[Block::SLAVE_FIRST][i]);
+		Bit16s slaveSample = slavePCMWave ? slaveFirstSample : Bit16s(slaveFirstSample + unlogSample(exp9, block.logValues[Block::SLAVE_SECOND][i], block.signMasks[Block::SLAVE_SECOND][i]));
+		Bit16s ringModulatedSample = Bit16s((Bit32s(produceDistortedSample(masterSample)) * Bit32s(produceDistortedSample(slaveSample))) >> 13);
+		outSamples[i] = mixed ? masterSample + ringModulatedSample : ringModulatedSample;
+	}
+}
+
+void LA32IntPartialPair::generateNextPCMWavePositions(const Bit32u amp, const Bit16u pitch, LA32PCMWaveBlock &block, const Bit32u position) {
+	master.generateNextPCMWavePositions(amp, pitch, block, position);
+}
+
+Bit32u LA32IntPartialPair::getPCMWaveSampleCount(const Bit16u pitch, const Bit32u maxCount) const {
+	return master.getPCMWaveSampleCount(pitch, maxCount);
+}
+
+void LA32IntPartialPair::skipPCMWaveSamples(const Bit16u pitch, const Bit32u count) {
+	master.skipPCMWaveSamples(pitch, count);
+}
+
+// Same as LA32WaveGenerator::pcmSampleToLogSample() but only yields the log value.
+static inline Bit16u pcmSampleToLogValue(const Bit16s pcmSample, const Bit32u amp) {
+	Bit32u logSampleValue = (32787 - (pcmSample & 32767)) << 1;
+	logSampleValue += amp >> 10;
+	return logSampleValue < 65536 ? Bit16u(logSampleValue) : 65535;
+}
+
+void LA32IntPartialPair::producePCMOutputBlock(const LA32PCMWaveBlock &block, Bit16s *outSamples, const Bit32u length) const {
+	const Bit16u *exp9 = Tables::getInstance().exp9;
+	const Bit16s *pcmWaveAddress = master.getPCMWaveAddress();
+	for (Bit32u i = 0; i < length; i++) {
+		const Bit32u amp = block.amps[i];
+		const Bit16s firstPCMSample = pcmWaveAddress[block.firstSampleIndices[i]];
+		const Bit16s secondPCMSample = pcmWaveAddress[block.secondSampleIndices[i]];
+		Bit16s firstSample = unlogSample(exp9, pcmSampleToLogValue(firstPCMSample, amp), firstPCMSample < 0 ? -1 : 0) & block.firstSampleMasks[i];
+		Bit16s secondSample = unlogSample(exp9, pcmSampleToLogValue(secondPCMSample, amp), secondPCMSample < 0 ? -1 : 0) & block.secondSampleMasks[i];
+		outSamples[i] = mixWGOutput(firstSample, secondSample, true, block.interpolationFactors[i]);
+	}
+}
+
 void LA32IntPartialPair::deactivate(const PairType useMaster) {
 	if (useMaster == MASTER) {
 		master.deactivate();
@@ -52,6 +52,20 @@ public:
 	static void addLogSamples(LogSample &logSample1, const LogSample &logSample2);
 };
 
+// Positions within the PCM wave and amps of a PCM WG, computed ahead for a block of samples.
+// This way, the PCM ROM data can be prefetched well before it is converted to the output.
+struct LA32PCMWaveBlock {
+	static const Bit32u LENGTH = 128;
+
+	Bit32u amps[LENGTH];
+	Bit32u firstSampleIndices[LENGTH];
+	Bit32u secondSampleIndices[LENGTH];
+	// -1 for audible samples, 0 for silent ones (e.g. beyond the end of a non-looped wave)
+	Bit16s firstSampleMasks[LENGTH];
+	Bit16s secondSampleMasks[LENGTH];
+	Bit16u interpolationFactors[LENGTH];
+};
+
 /**
  * LA32WaveGenerator is aimed to represent the exact model of LA32 wave generator.
  * The output square wave is created by adding high / low linear segments in-between
@@ -174,7 +188,10 @@ class LA32WaveGenerator {
 	void generateNextSawtoothCosineLogSample(LogSample &logSample) const;
 
 	void pcmSampleToLogSample(LogSample &logSample, const Bit16s pcmSample) const;
+	Bit32u getSecondPCMWaveTableIx(Bit32u pcmWaveTableIx, bool &silent) const;
 	void generateNextPCMWaveLogSamples();
+	static Bit32u getPCMSampleStep(const Bit16u pitch);
+	void advancePCMWavePosition();
 
 public:
 	// Initialise the WG engine for generation of synth partial samples and set up the invariant parameters
@@ -186,6 +203,18 @@ public:
 	// Update parameters with respect to TVP, TVA and TVF, and generate next sample
 	void generateNextSample(const Bit32u amp, const Bit16u pitch, const Bit32u cutoff);
 
+	// Same as generateNextSample() for PCM waves, except that the PCM samples are not read,
+	// only their positions are stored in the block to be processed later
+	void generateNextPCMWavePositions(const Bit32u amp, const Bit16u pitch, LA32PCMWaveBlock &block, const Bit32u position);
+
+	// Returns the number of PCM samples the WG engine remains active for at the specified steady pitch, limited by maxCount.
+	// The last of the samples counted is the one which makes a non-looped PCM wave end.
+	Bit32u getPCMWaveSampleCount(const Bit16u pitch, const Bit32u maxCount) const;
+
+	// Advances the PCM wave position by the specified number of samples at a steady pitch, without generating any output.
+	// The count must not exceed the value returned by getPCMWaveSampleCount().
+	void skipPCMWaveSamples(const Bit16u pitch, const Bit32u count);
+
 	// WG output in the log-space consists of two components which are to be added (or ring modulated) in the linear-space afterwards
 	LogSample getOutputLogSample(const bool first) const;
 
@@ -200,6 +229,9 @@ public:
 
 	// Return current PCM interpolation factor
 	Bit32u getPCMInterpolationFactor() const;
+
+	// Return start address of the PCM wave
+	const Bit16s *getPCMWaveAddress() const;
 }; // class LA32WaveGenerator
 
 // LA32PartialPair contains a structure of two partials being mixed / ring modulated
@@ -227,6 +259,26 @@ public:
 	virtual void deactivate(const PairType master) = 0;
 }; // class LA32PartialPair
 
+// Log-space output of LA32IntPartialPair captured for a block of samples.
+// The layout enables conversion of the whole block to the linear space in a loop that the compiler can vectorise.
+struct LA32IntPartialPairOutputBlock {
+	static const Bit32u LENGTH = 128;
+
+	enum {
+		MASTER_FIRST,
+		MASTER_SECOND,
+		SLAVE_FIRST,
+		SLAVE_SECOND,
+		LOG_SAMPLE_COUNT
+	};
+
+	Bit16u logValues[LOG_SAMPLE_COUNT][LENGTH];
+	// 0 for positive log samples, -1 for negative ones
+	Bit16s signMasks[LOG_SAMPLE_COUNT][LENGTH];
+	Bit16u masterPCMInterpolationFactors[LENGTH];
+	Bit16u slavePCMInterpolationFactors[LENGTH];
+};
+
 class LA32IntPartialPair : public LA32PartialPair {
 	LA32WaveGenerator master;
 	LA32WaveGenerator slave;
@@ -254,6 +306,24 @@ public:
 	// Although, LA32 applies panning itself, we assume it is applied in the mixer, not within a pair
 	Bit16s nextOutSample();
 
+	// Store the current WG output in the log-space at the specified position of the block
+	void captureOutputLogSamples(LA32IntPartialPairOutputBlock &block, const Bit32u position) const;
+
+	// Same as nextOutSample() but for a block of samples captured previously
+	void produceOutputBlock(const LA32IntPartialPairOutputBlock &block, Bit16s *outSamples, const Bit32u length) const;
+
+	// Fast path for pairs with a PCM master WG and no ring modulation, i.e. the slave WG is inactive
+	void generateNextPCMWavePositions(const Bit32u amp, const Bit16u pitch, LA32PCMWaveBlock &block, const Bit32u position);
+
+	// Returns the number of PCM samples the master WG remains active for at the specified steady pitch, limited by maxCount
+	Bit32u getPCMWaveSampleCount(const Bit16u pitch, const Bit32u maxCount) const;
+
+	// Advances the PCM wave position of the master WG by the specified number of samples at a steady pitch, without generating any output
+	void skipPCMWaveSamples(const Bit16u pitch, const Bit32u count);
+
+	// Same as nextOutSample() but for a block of PCM wave positions generated previously
+	void producePCMOutputBlock(const LA32PCMWaveBlock &block, Bit16s *outSamples, const Bit32u length) const;
+
 	// Deactivate the WG engine
 	void deactivate(const PairType master);
 
@@ -20,6 +20,7 @@
 
 #include "globals.h"
 #include "Types.h"
+#include "Synth.h"
 
 namespace MT32Emu {
 
@@ -44,6 +45,11 @@ public:
 			Bit32u shortMessageData;
 		};
 		Bit32u timestamp;
+		// Only set for SysEx bulk events, i.e. when sysexData refers to a client-owned buffer rather than to the storage.
+		// In this case, sysexData and sysexLength designate the remaining messages of the bulk.
+		const Bit8u *sysexBulk;
+		SysexBulkReleaseCallback sysexBulkReleaseCallback;
+		void *sysexBulkInstanceData;
 	};
 
 	explicit MidiEventQueue(
@@ -55,9 +61,14 @@ public:
 	void reset();
 	bool pushShortMessage(Bit32u shortMessageData, Bit32u timestamp);
 	bool pushSysex(const Bit8u *sysexData, Bit32u sysexLength, Bit32u timestamp);
+	bool pushSysexBulk(const Bit8u *sysexBulk, Bit32u sysexBulkLength, Bit32u timestamp, SysexBulkReleaseCallback releaseCallback, void *instanceData);
 	const volatile MidiEvent *peekMidiEvent();
+	// Makes the SysEx bulk event at the head of the queue refer to the remaining messages, that are due at the specified time.
+	void advanceSysexBulk(const Bit8u *remainingSysexData, Bit32u remainingLength, Bit32u timestamp);
 	void dropMidiEvent();
 	inline bool isEmpty() const;
+	// Returns the number of heap allocations performed to store SysEx data since the queue was created.
+	Bit32u getAllocationCount() const;
 
 private:
 	SysexDataStorage &sysexDataStorage;
@@ -66,6 +77,9 @@ private:
 	const Bit32u ringBufferMask;
 	volatile Bit32u startPosition;
 	volatile Bit32u endPosition;
+
+	void disposeSysexData(volatile MidiEvent &midiEvent);
+	void releaseSysexBulk(volatile MidiEvent &midiEvent);
 };
 
 } // namespace MT32Emu
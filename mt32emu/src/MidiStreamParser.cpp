@@ -23,8 +23,32 @@
 #include "MidiStreamParser.h"
 #include "Synth.h"
 
+namespace MT32Emu {
+
+class MidiStreamParserExtensions {
+public:
+	Bit32u streamBufferAllocationCount;
+};
+
+} // namespace MT32Emu
+
 using namespace MT32Emu;
 
+// Returns the index of the first byte with the most significant bit set, i.e. a status byte, or length if there is none.
+// The bulk of the data is checked a word at a time, which is what makes long SysEx bodies cheap to skip through.
+static Bit32u findStatusByte(const Bit8u stream[], const Bit32u length) {
+	static const Bit32u STATUS_BITS = 0x80808080;
+	Bit32u pos = 0;
+	while (pos + sizeof(Bit32u) <= length) {
+		Bit32u word;
+		memcpy(&word, stream + pos, sizeof(Bit32u));
+		if ((word & STATUS_BITS) != 0) break;
+		pos += sizeof(Bit32u);
+	}
+	while (pos < length && stream[pos] < 0x80) ++pos;
+	return pos;
+}
+
 DefaultMidiStreamParser::DefaultMidiStreamParser(Synth &useSynth, Bit32u initialStreamBufferCapacity) :
 	MidiStreamParser(initialStreamBufferCapacity), synth(useSynth), timestampSet(false) {}
 
@@ -80,11 +104,13 @@ MidiStreamParserImpl::MidiStreamParserImpl(MidiReceiver &useReceiver, MidiReport
 	streamBufferSize = 0;
 	runningStatus = 0;
 
-	reserved = NULL;
+	extensions = new MidiStreamParserExtensions;
+	extensions->streamBufferAllocationCount = 0;
 }
 
 MidiStreamParserImpl::~MidiStreamParserImpl() {
 	delete[] streamBuffer;
+	delete extensions;
 }
 
 void MidiStreamParserImpl::parseStream(const Bit8u *stream, Bit32u length) {
@@ -107,7 +133,8 @@ void MidiStreamParserImpl::parseStream(const Bit8u *stream, Bit32u length) {
 				runningStatus = 0; // SysEx clears the running status
 				parsedMessageLength = parseSysex(stream, length);
 			} else {
-				parsedMessageLength = parseShortMessageStatus(stream);
+				parsedMessageLength = parseShortMessages(stream, length);
+				if (parsedMessageLength == 0) parsedMessageLength = parseShortMessageStatus(stream);
 			}
 		}
 
@@ -129,6 +156,10 @@ void MidiStreamParserImpl::processShortMessage(const Bit32u message) {
 	}
 }
 
+Bit32u MidiStreamParserImpl::getStreamBufferAllocationCount() const {
+	return extensions->streamBufferAllocationCount;
+}
+
 // We deal with SysEx messages below 512 bytes long in most cases. Nevertheless, it seems reasonable to support a possibility
 // to load bulk dumps using a single message. However, this is known to fail with a real device due to limited input buffer size.
 bool MidiStreamParserImpl::checkStreamBufferCapacity(const bool preserveContent) {
@@ -137,6 +168,7 @@ bool MidiStreamParserImpl::checkStreamBufferCapacity(const bool preserveContent)
 		Bit8u *oldStreamBuffer = streamBuffer;
 		streamBufferCapacity = MAX_STREAM_BUFFER_SIZE;
 		streamBuffer = new Bit8u[streamBufferCapacity];
+		extensions->streamBufferAllocationCount++;
 		if (preserveContent) memcpy(streamBuffer, oldStreamBuffer, streamBufferSize);
 		delete[] oldStreamBuffer;
 		return true;
@@ -177,6 +209,36 @@ Bit32u MidiStreamParserImpl::parseShortMessageStatus(const Bit8u stream[]) {
 	return parsedLength;
 }
 
+// Fast path that handles a run of complete short messages, with or without running status, straight from the input stream.
+// Stops at anything that needs to go through streamBuffer, such as a message split across calls or interleaved with a System Realtime,
+// as well as at System messages. Returns # of bytes parsed
+Bit32u MidiStreamParserImpl::parseShortMessages(const Bit8u stream[], const Bit32u length) {
+	Bit32u parsedLength = 0;
+	while (parsedLength < length) {
+		Bit32u dataPos = parsedLength;
+		Bit8u status = stream[dataPos];
+		if (status < 0x80) {
+			if (runningStatus < 0x80) break;
+			status = runningStatus;
+		} else if (status < 0xF0) {
+			++dataPos;
+		} else {
+			break;
+		}
+		const Bit32u dataLength = Synth::getShortMessageLength(status) - 1;
+		if (length - dataPos < dataLength || findStatusByte(stream + dataPos, dataLength) < dataLength) break;
+
+		Bit32u shortMessage = status;
+		for (Bit32u i = 0; i < dataLength; ++i) {
+			shortMessage |= stream[dataPos + i] << ((i + 1) << 3);
+		}
+		runningStatus = status;
+		midiReceiver.handleShortMessage(shortMessage);
+		parsedLength = dataPos + dataLength;
+	}
+	return parsedLength;
+}
+
 // Returns # of bytes parsed
 Bit32u MidiStreamParserImpl::parseShortMessageDataBytes(const Bit8u stream[], Bit32u length) {
 	const Bit32u shortMessageLength = Synth::getShortMessageLength(*streamBuffer);
@@ -218,24 +280,24 @@ Bit32u MidiStreamParserImpl::parseSysex(const Bit8u stream[], const Bit32u lengt
 	// Find SysEx length
 	Bit32u sysexLength = 1;
 	while (sysexLength < length) {
+		sysexLength += findStatusByte(stream + sysexLength, length - sysexLength);
+		if (sysexLength == length) break;
 		Bit8u nextByte = stream[sysexLength++];
-		if (0x80 <= nextByte) {
-			if (nextByte == 0xF7) {
-				// End of SysEx
-				midiReceiver.handleSysex(stream, sysexLength);
-				return sysexLength;
-			}
-			if (0xF8 <= nextByte) {
-				// The System Realtime message must be processed right after return
-				// but the SysEx is actually fragmented and to be reconstructed in streamBuffer
-				--sysexLength;
-				break;
-			}
-			// Illegal status byte in SysEx message, aborting
-			midiReporter.printDebug("parseSysex: SysEx message lacks end-of-sysex (0xf7), ignored");
-			// Continue parsing from that point
-			return sysexLength - 1;
+		if (nextByte == 0xF7) {
+			// End of SysEx, which is passed on right from the input stream
+			midiReceiver.handleSysex(stream, sysexLength);
+			return sysexLength;
 		}
+		if (0xF8 <= nextByte) {
+			// The System Realtime message must be processed right after return
+			// but the SysEx is actually fragmented and to be reconstructed in streamBuffer
+			--sysexLength;
+			break;
+		}
+		// Illegal status byte in SysEx message, aborting
+		midiReporter.printDebug("parseSysex: SysEx message lacks end-of-sysex (0xf7), ignored");
+		// Continue parsing from that point
+		return sysexLength - 1;
 	}
 
 	// Store incomplete SysEx message for further processing
@@ -254,12 +316,19 @@ Bit32u MidiStreamParserImpl::parseSysex(const Bit8u stream[], const Bit32u lengt
 Bit32u MidiStreamParserImpl::parseSysexFragment(const Bit8u stream[], const Bit32u length) {
 	Bit32u parsedLength = 0;
 	while (parsedLength < length) {
-		Bit8u nextByte = stream[parsedLength++];
-		if (nextByte < 0x80) {
-			// Add SysEx data byte to streamBuffer
-			if (checkStreamBufferCapacity(true)) streamBuffer[streamBufferSize++] = nextByte;
-			continue;
+		// Add SysEx data bytes to streamBuffer in bulk, as far as its capacity allows
+		const Bit32u dataEnd = parsedLength + findStatusByte(stream + parsedLength, length - parsedLength);
+		while (parsedLength < dataEnd && checkStreamBufferCapacity(true)) {
+			Bit32u copyLength = streamBufferCapacity - streamBufferSize;
+			if (dataEnd - parsedLength < copyLength) copyLength = dataEnd - parsedLength;
+			memcpy(streamBuffer + streamBufferSize, stream + parsedLength, copyLength);
+			streamBufferSize += copyLength;
+			parsedLength += copyLength;
 		}
+		parsedLength = dataEnd;
+		if (parsedLength == length) break;
+
+		Bit8u nextByte = stream[parsedLength++];
 		if (0xF8 <= nextByte) {
 			// Bypass System Realtime message
 			midiReceiver.handleSystemRealtimeMessage(nextByte);
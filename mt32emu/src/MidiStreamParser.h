@@ -24,6 +24,7 @@
 namespace MT32Emu {
 
 class Synth;
+class MidiStreamParserExtensions;
 
 // Interface for a user-supplied class to receive parsed well-formed MIDI messages.
 class MT32EMU_EXPORT MidiReceiver {
@@ -73,6 +74,10 @@ public:
 	// The short MIDI message may contain no status byte, the running status is used in this case.
 	void processShortMessage(const Bit32u message);
 
+	// Debugging aid for realtime applications. Returns the number of times streamBuffer was reallocated to fit a long SysEx
+	// since the parser was created. The value always remains 0 when the initial capacity is set to MAX_STREAM_BUFFER_SIZE.
+	MT32EMU_EXPORT_V(2.8) Bit32u getStreamBufferAllocationCount() const;
+
 private:
 	Bit8u runningStatus;
 	Bit8u *streamBuffer;
@@ -82,10 +87,11 @@ private:
 	MidiReporter &midiReporter;
 
 	// Binary compatibility helper.
-	void *reserved;
+	MidiStreamParserExtensions *extensions;
 
 	bool checkStreamBufferCapacity(const bool preserveContent);
 	bool processStatusByte(Bit8u &status);
+	Bit32u parseShortMessages(const Bit8u stream[], const Bit32u length);
 	Bit32u parseShortMessageStatus(const Bit8u stream[]);
 	Bit32u parseShortMessageDataBytes(const Bit8u stream[], Bit32u length);
 	Bit32u parseSysex(const Bit8u stream[], const Bit32u length);
@@ -65,6 +65,7 @@ Part::Part(Synth *useSynth, unsigned int usePartNum) {
 	pitchBend = 0;
 	activePartialCount = 0;
 	activeNonReleasingPolyCount = 0;
+	timbreTempModified = false;
 	memset(patchCache, 0, sizeof(patchCache));
 }
 
@@ -143,30 +144,11 @@ void Part::reset() {
 }
 
 void RhythmPart::refresh() {
-	// (Re-)cache all the mapped timbres ahead of time
-	for (unsigned int drumNum = 0; drumNum < synth->controlROMMap->rhythmSettingsCount; drumNum++) {
-		int drumTimbreNum = rhythmTemp[drumNum].timbre;
-		if (drumTimbreNum >= 127) { // 94 on MT-32
-			continue;
-		}
-		PatchCache *cache = drumCache[drumNum];
-		backupCacheToPartials(cache);
-		for (int t = 0; t < 4; t++) {
-			// Common parameters, stored redundantly
-			cache[t].dirty = true;
-			cache[t].reverb = rhythmTemp[drumNum].reverbSwitch > 0;
-		}
-	}
+	// The mapped timbres are played straight from the per-timbre caches, and the rhythm settings are picked up as each note starts
 	updatePitchBenderRange();
 }
 
 void Part::refresh() {
-	backupCacheToPartials(patchCache);
-	for (int t = 0; t < 4; t++) {
-		// Common parameters, stored redundantly
-		patchCache[t].dirty = true;
-		patchCache[t].reverb = patchTemp->patch.reverbSwitch > 0;
-	}
 	memcpy(currentInstr, timbreTemp->common.name, 10);
 	synth->newTimbreSet(partNum);
 	updatePitchBenderRange();
@@ -176,21 +158,25 @@ const char *Part::getCurrentInstr() const {
 	return &currentInstr[0];
 }
 
-void RhythmPart::refreshTimbre(unsigned int absTimbreNum) {
-	for (int m = 0; m < 85; m++) {
-		if (rhythmTemp[m].timbre == absTimbreNum - 128) {
-			drumCache[m][0].dirty = true;
-		}
-	}
+void RhythmPart::refreshTimbre(unsigned int) {
+	// Nothing to do, the synth invalidates the cache of the written timbre which the rhythm part plays directly
 }
 
 void Part::refreshTimbre(unsigned int absTimbreNum) {
 	if (getAbsTimbreNum() == absTimbreNum) {
 		memcpy(currentInstr, timbreTemp->common.name, 10);
+		// timbreTemp still holds the former content of the timbre, so it can't share the timbre cache anymore
+		timbreTempModified = true;
 		patchCache[0].dirty = true;
 	}
 }
 
+void Part::refreshTimbreTemp() {
+	timbreTempModified = true;
+	patchCache[0].dirty = true;
+	refresh();
+}
+
 void Part::setPatch(const PatchParam *patch) {
 	patchTemp->patch = *patch;
 }
@@ -199,8 +185,10 @@ void RhythmPart::setTimbre(TimbreParam * /*timbre*/) {
 	synth->printDebug("%s: Attempted to call setTimbre() - doesn't make sense for rhythm", name);
 }
 
+// The timbre is expected to be the one referred by the patch in patchTemp, as its cache is shared.
 void Part::setTimbre(TimbreParam *timbre) {
 	*timbreTemp = *timbre;
+	timbreTempModified = false;
 }
 
 unsigned int RhythmPart::getAbsTimbreNum() const {
@@ -232,18 +220,8 @@ void Part::updatePitchBenderRange() {
 	pitchBenderRange = patchTemp->patch.benderRange * 683;
 }
 
-void Part::backupCacheToPartials(PatchCache cache[4]) {
-	// check if any partials are still playing with the old patch cache
-	// if so then duplicate the cached data from the part to the partial so that
-	// we can change the part's cache without affecting the partial.
-	// We delay this until now to avoid a copy operation with every note played
-	for (Poly *poly = activePolys.getFirst(); poly != NULL; poly = poly->getNext()) {
-		poly->backupCacheToPartials(cache);
-	}
-}
-
+// Partials only read the cache while starting, so it's safe to recache while they are still playing.
 void Part::cacheTimbre(PatchCache cache[4], const TimbreParam *timbre) {
-	backupCacheToPartials(cache);
 	int partialCount = 0;
 	for (int t = 0; t < 4; t++) {
 		if (((timbre->common.partialMute >> t) & 0x1) == 1) {
@@ -288,8 +266,6 @@ void Part::cacheTimbre(PatchCache cache[4], const TimbreParam *timbre) {
 			break;
 		}
 
-		cache[t].partialParam = &timbre->partial[t];
-
 		cache[t].waveform = timbre->partial[t].wg.waveform;
 	}
 	for (int t = 0; t < 4; t++) {
@@ -308,6 +284,14 @@ void Part::cacheTimbre(PatchCache cache[4], const TimbreParam *timbre) {
 #endif
 }
 
+const PatchCache *Part::getTimbreCache(unsigned int absTimbreNum) {
+	PatchCache *cache = synth->getTimbreCache(absTimbreNum);
+	if (cache[0].dirty) {
+		cacheTimbre(cache, &synth->mt32ram.timbres[absTimbreNum].timbre);
+	}
+	return cache;
+}
+
 const char *Part::getName() const {
 	return name;
 }
@@ -417,9 +401,7 @@ void RhythmPart::noteOn(unsigned int midiKey, unsigned int velocity) {
 	int absTimbreNum = drumTimbreNum + 128;
 	TimbreParam *timbre = &synth->mt32ram.timbres[absTimbreNum].timbre;
 	memcpy(currentInstr, timbre->common.name, 10);
-	if (drumCache[drumNum][0].dirty) {
-		cacheTimbre(drumCache[drumNum], timbre);
-	}
+	const PatchCache *cache = getTimbreCache(absTimbreNum);
 #if MT32EMU_MONITOR_INSTRUMENTS > 0
 	synth->printDebug("%s (%s): Start poly (drum %d, timbre %d): midiKey %u, key %u, velo %u, mod %u, exp %u, bend %u", name, currentInstr, drumNum, absTimbreNum, midiKey, key, velocity, modulation, expression, pitchBend);
 #if MT32EMU_MONITOR_INSTRUMENTS > 1
@@ -429,13 +411,19 @@ void RhythmPart::noteOn(unsigned int midiKey, unsigned int velocity) {
 	synth->printDebug(" RhythmTemp: timbre %u, outputLevel %u, panpot %u, reverbSwitch %u", rhythmTemp[drumNum].timbre, rhythmTemp[drumNum].outputLevel, rhythmTemp[drumNum].panpot, rhythmTemp[drumNum].reverbSwitch);
 #endif
 #endif
-	playPoly(drumCache[drumNum], &rhythmTemp[drumNum], midiKey, key, velocity);
+	playPoly(cache, timbre, &rhythmTemp[drumNum], midiKey, key, velocity);
 }
 
 void Part::noteOn(unsigned int midiKey, unsigned int velocity) {
 	unsigned int key = midiKeyToKey(midiKey);
-	if (patchCache[0].dirty) {
-		cacheTimbre(patchCache, timbreTemp);
+	const PatchCache *cache;
+	if (timbreTempModified) {
+		if (patchCache[0].dirty) {
+			cacheTimbre(patchCache, timbreTemp);
+		}
+		cache = patchCache;
+	} else {
+		cache = getTimbreCache(getAbsTimbreNum());
 	}
 #if MT32EMU_MONITOR_INSTRUMENTS > 0
 	synth->printDebug("%s (%s): Start poly: midiKey %u, key %u, velo %u, mod %u, exp %u, bend %u", name, currentInstr, midiKey, key, velocity, modulation, expression, pitchBend);
@@ -444,7 +432,7 @@ void Part::noteOn(unsigned int midiKey, unsigned int velocity) {
 	synth->printDebug(" PatchTemp: outputLevel %u, panpot %u", patchTemp->outputLevel, patchTemp->panpot);
 #endif
 #endif
-	playPoly(patchCache, NULL, midiKey, key, velocity);
+	playPoly(cache, timbreTemp, NULL, midiKey, key, velocity);
 }
 
 bool Part::abortFirstPoly(unsigned int key) {
@@ -479,7 +467,7 @@ bool Part::abortFirstPoly() {
 	return activePolys.getFirst()->startAbort();
 }
 
-void Part::playPoly(const PatchCache cache[4], const MemParams::RhythmTemp *rhythmTemp, unsigned int midiKey, unsigned int key, unsigned int velocity) {
+void Part::playPoly(const PatchCache cache[4], const TimbreParam *timbre, const MemParams::RhythmTemp *rhythmTemp, unsigned int midiKey, unsigned int key, unsigned int velocity) {
 	// CONFIRMED: Even in single-assign mode, we don't abort playing polys if the timbre to play is completely muted.
 	unsigned int needPartials = cache[0].partialCount;
 	if (needPartials == 0) {
@@ -530,7 +518,7 @@ void Part::playPoly(const PatchCache cache[4], const MemParams::RhythmTemp *rhyt
 #if MT32EMU_MONITOR_PARTIALS > 2
 			synth->printDebug("%s (%s): Allocated partial %d", name, currentInstr, partials[x]->debugGetPartialNum());
 #endif
-			partials[x]->startPartial(this, poly, &cache[x], rhythmTemp, partials[cache[x].structurePair]);
+			partials[x]->startPartial(this, poly, &cache[x], &timbre->partial[x], rhythmTemp, partials[cache[x].structurePair]);
 		}
 	}
 #if MT32EMU_MONITOR_PARTIALS > 1
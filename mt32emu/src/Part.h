@@ -56,6 +56,9 @@ private:
 
 	unsigned int activePartialCount;
 	unsigned int activeNonReleasingPolyCount;
+	// Set when timbreTemp has diverged from the timbre it was loaded from, so that the shared timbre cache is no longer valid for this part.
+	bool timbreTempModified;
+	// Caches timbreTemp while it is modified, otherwise the synth's per-timbre cache is used.
 	PatchCache patchCache[4];
 	PolyList activePolys;
 
@@ -79,9 +82,9 @@ protected:
 	Bit16u rpn;
 	Bit16u pitchBenderRange; // (patchTemp->patch.benderRange * 683) at the time of the last MIDI program change or MIDI data entry.
 
-	void backupCacheToPartials(PatchCache cache[4]);
 	void cacheTimbre(PatchCache cache[4], const TimbreParam *timbre);
-	void playPoly(const PatchCache cache[4], const MemParams::RhythmTemp *rhythmTemp, unsigned int midiKey, unsigned int key, unsigned int velocity);
+	const PatchCache *getTimbreCache(unsigned int absTimbreNum);
+	void playPoly(const PatchCache cache[4], const TimbreParam *timbre, const MemParams::RhythmTemp *rhythmTemp, unsigned int midiKey, unsigned int key, unsigned int velocity);
 	void stopNote(unsigned int key);
 	const char *getName() const;
 
@@ -115,6 +118,7 @@ public:
 	void updatePitchBenderRange();
 	virtual void refresh();
 	virtual void refreshTimbre(unsigned int absTimbreNum);
+	void refreshTimbreTemp();
 	virtual void setTimbre(TimbreParam *timbre);
 	virtual unsigned int getAbsTimbreNum() const;
 	const char *getCurrentInstr() const;
@@ -140,8 +144,6 @@ class RhythmPart: public Part {
 	// Pointer to the area of the MT-32's memory dedicated to rhythm
 	const MemParams::RhythmTemp *rhythmTemp;
 
-	// This caches the timbres/settings in use by the rhythm part
-	PatchCache drumCache[85][4];
 public:
 	RhythmPart(Synth *synth, unsigned int usePartNum);
 	void refresh();
@@ -16,6 +16,7 @@
  */
 
 #include <cstddef>
+#include <new>
 
 #include "internals.h"
 
@@ -51,23 +52,25 @@ static Bit32s getPanFactor(Bit32s panSetting) {
 	return PAN_FACTORS[panSetting];
 }
 
-Partial::Partial(Synth *useSynth, int usePartialIndex) :
+Partial::Partial(Synth *useSynth, int usePartialIndex, const PartialStorage &storage) :
 	synth(useSynth), partialIndex(usePartialIndex), sampleNum(0),
 	floatMode(useSynth->getSelectedRendererType() == RendererType_FLOAT) {
 	// Initialisation of tva, tvp and tvf uses 'this' pointer
 	// and thus should not be in the initializer list to avoid a compiler warning
-	tva = new TVA(this, &ampRamp);
-	tvp = new TVP(this);
-	tvf = new TVF(this, &cutoffModifierRamp);
+	tva = new(storage.tva) TVA(this, &ampRamp);
+	tvp = new(storage.tvp) TVP(this);
+	tvf = new(storage.tvf) TVF(this, &cutoffModifierRamp);
 	ownerPart = -1;
 	poly = NULL;
 	pair = NULL;
+	culled = false;
+	reverb = false;
 	switch (synth->getSelectedRendererType()) {
 	case RendererType_BIT16S:
-		la32Pair = new LA32IntPartialPair;
+		la32Pair = new(storage.la32Pair) LA32IntPartialPair;
 		break;
 	case RendererType_FLOAT:
-		la32Pair = new LA32FloatPartialPair;
+		la32Pair = new(storage.la32Pair) LA32FloatPartialPair;
 		break;
 	default:
 		la32Pair = NULL;
@@ -75,10 +78,11 @@ Partial::Partial(Synth *useSynth, int usePartialIndex) :
 }
 
 Partial::~Partial() {
-	delete la32Pair;
-	delete tva;
-	delete tvp;
-	delete tvf;
+	// The memory is owned by the PartialManager, so only destroy the objects.
+	if (la32Pair != NULL) la32Pair->~LA32PartialPair();
+	tva->~TVA();
+	tvp->~TVP();
+	tvf->~TVF();
 }
 
 // Only used for debugging purposes
@@ -135,17 +139,17 @@ void Partial::deactivate() {
 	}
 }
 
-void Partial::startPartial(const Part *part, Poly *usePoly, const PatchCache *usePatchCache, const MemParams::RhythmTemp *rhythmTemp, Partial *pairPartial) {
-	if (usePoly == NULL || usePatchCache == NULL) {
-		synth->printDebug("[Partial %d] *** Error: Starting partial for owner %d, usePoly=%s, usePatchCache=%s", partialIndex, ownerPart, usePoly == NULL ? "*** NULL ***" : "OK", usePatchCache == NULL ? "*** NULL ***" : "OK");
+void Partial::startPartial(const Part *part, Poly *usePoly, const PatchCache *patchCache, const TimbreParam::PartialParam *partialParam, const MemParams::RhythmTemp *rhythmTemp, Partial *pairPartial) {
+	if (usePoly == NULL || patchCache == NULL) {
+		synth->printDebug("[Partial %d] *** Error: Starting partial for owner %d, usePoly=%s, patchCache=%s", partialIndex, ownerPart, usePoly == NULL ? "*** NULL ***" : "OK", patchCache == NULL ? "*** NULL ***" : "OK");
 		return;
 	}
-	patchCache = usePatchCache;
 	poly = usePoly;
 	mixType = patchCache->structureMix;
 	structurePosition = patchCache->structurePosition;
 
 	Bit8u panSetting = rhythmTemp != NULL ? rhythmTemp->panpot : part->getPatchTemp()->panpot;
+	reverb = (rhythmTemp != NULL ? rhythmTemp->reverbSwitch : part->getPatchTemp()->patch.reverbSwitch) > 0;
 	if (mixType == 3) {
 		if (structurePosition == 0) {
 			panSetting = PAN_NUMERATOR_MASTER[panSetting] << 1;
@@ -210,9 +214,10 @@ void Partial::startPartial(const Part *part, Poly *usePoly, const PatchCache *us
 
 	pair = pairPartial;
 	alreadyOutputed = false;
-	tva->reset(part, patchCache->partialParam, rhythmTemp);
-	tvp->reset(part, patchCache->partialParam);
-	tvf->reset(patchCache->partialParam, tvp->getBasePitch());
+	culled = false;
+	tva->reset(part, partialParam, rhythmTemp);
+	tvp->reset(part, partialParam);
+	tvf->reset(partialParam, tvp->getBasePitch());
 
 	LA32PartialPair::PairType pairType;
 	LA32PartialPair *useLA32Pair;
@@ -245,7 +250,7 @@ Bit32u Partial::getAmpValue() {
 	//
 	// Also still partially unconfirmed is the behaviour when ramping between levels, as well as the timing.
 	// TODO: The tests above were performed using the float model, to be refined
-	Bit32u ampRampVal = 67117056 - ampRamp.nextValue();
+	Bit32u ampRampVal = MAX_AMP - ampRamp.nextValue();
 	if (ampRamp.checkInterrupt()) {
 		tva->handleInterrupt();
 	}
@@ -263,6 +268,35 @@ Bit32u Partial::getCutoffValue() {
 	return (tvf->getBaseCutoff() << 18) + cutoffModifierRampVal;
 }
 
+Bit32u Partial::getAmpValues(Bit32u *ampValues, Bit32u length) {
+	Bit32u count = ampRamp.nextValues(ampValues, length);
+	for (Bit32u i = 0; i < count; i++) {
+		ampValues[i] = MAX_AMP - ampValues[i];
+	}
+	if (ampRamp.checkInterrupt()) {
+		tva->handleInterrupt();
+	}
+	return count;
+}
+
+Bit32u Partial::getCutoffValues(Bit32u *cutoffValues, Bit32u length) {
+	if (isPCM()) {
+		for (Bit32u i = 0; i < length; i++) {
+			cutoffValues[i] = 0;
+		}
+		return length;
+	}
+	Bit32u count = cutoffModifierRamp.nextValues(cutoffValues, length);
+	Bit32u baseCutoff = tvf->getBaseCutoff() << 18;
+	for (Bit32u i = 0; i < count; i++) {
+		cutoffValues[i] += baseCutoff;
+	}
+	if (cutoffModifierRamp.checkInterrupt()) {
+		tvf->handleInterrupt();
+	}
+	return count;
+}
+
 bool Partial::hasRingModulatingSlave() const {
 	return pair != NULL && structurePosition == 0 && (mixType == 1 || mixType == 2);
 }
@@ -294,13 +328,6 @@ TVA *Partial::getTVA() const {
 	return tva;
 }
 
-void Partial::backupCache(const PatchCache &cache) {
-	if (patchCache == &cache) {
-		cachebackup = cache;
-		patchCache = &cachebackup;
-	}
-}
-
 bool Partial::canProduceOutput() {
 	if (!isActive() || alreadyOutputed || isRingModulatingSlave()) {
 		return false;
@@ -332,8 +359,8 @@ bool Partial::generateNextSample(LA32PairImpl *la32PairImpl) {
 	return true;
 }
 
-void Partial::produceAndMixSample(IntSample *&leftBuf, IntSample *&rightBuf, LA32IntPartialPair *la32IntPair) {
-	IntSampleEx sample = la32IntPair->nextOutSample();
+void Partial::produceAndMixSample(IntSample *&leftBuf, IntSample *&rightBuf, const Bit16s pairSample) {
+	IntSampleEx sample = pairSample;
 
 	// FIXME: LA32 may produce distorted sound in case if the absolute value of maximal amplitude of the input exceeds 8191
 	// when the panning value is non-zero. Most probably the distortion occurs in the same way it does with ring modulation,
@@ -369,12 +396,129 @@ bool Partial::doProduceOutput(Sample *leftBuf, Sample *rightBuf, Bit32u length,
 	return true;
 }
 
+void Partial::produceBlockedOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length, LA32IntPartialPair *la32IntPair) {
+	// The WG state can only be advanced sample by sample. Yet, conversion of the WG output to the linear space and mixing
+	// are independent across samples, so these are performed in blocks, in tight loops that the compiler can vectorise.
+	LA32IntPartialPairOutputBlock outputBlock;
+	Bit16s pairSamples[LA32IntPartialPairOutputBlock::LENGTH];
+	bool stopped = false;
+	while (!stopped && sampleNum < length) {
+		Bit32u blockLength = 0;
+		Bit32u maxBlockLength = length - sampleNum;
+		if (maxBlockLength > LA32IntPartialPairOutputBlock::LENGTH) maxBlockLength = LA32IntPartialPairOutputBlock::LENGTH;
+		while (blockLength < maxBlockLength) {
+			if (!generateNextSample(la32IntPair)) {
+				stopped = true;
+				break;
+			}
+			la32IntPair->captureOutputLogSamples(outputBlock, blockLength++);
+			sampleNum++;
+		}
+		la32IntPair->produceOutputBlock(outputBlock, pairSamples, blockLength);
+		for (Bit32u i = 0; i < blockLength; i++) {
+			produceAndMixSample(leftBuf, rightBuf, pairSamples[i]);
+		}
+	}
+}
+
+void Partial::producePCMOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length, LA32IntPartialPair *la32IntPair) {
+	// Dedicated path for PCM partials without ring modulation, which are most common. The envelopes and the wave positions
+	// are advanced first for a block of samples, prefetching the PCM ROM data in the meantime. Only then the PCM samples
+	// are read, converted to the linear space, interpolated and mixed.
+	LA32PCMWaveBlock pcmWaveBlock;
+	Bit32u ampValues[LA32PCMWaveBlock::LENGTH];
+	Bit16s pairSamples[LA32PCMWaveBlock::LENGTH];
+	bool stopped = false;
+	while (!stopped && sampleNum < length) {
+		Bit32u blockLength = 0;
+		Bit32u maxBlockLength = length - sampleNum;
+		if (maxBlockLength > LA32PCMWaveBlock::LENGTH) maxBlockLength = LA32PCMWaveBlock::LENGTH;
+		while (blockLength < maxBlockLength) {
+			if (!tva->isPlaying() || !la32IntPair->isActive(LA32PartialPair::MASTER)) {
+				deactivate();
+				stopped = true;
+				break;
+			}
+			// The pitch stays the same till the next TVP timer firing, so the envelope and the wave position are advanced
+			// in runs up to that point, the next TVA interrupt or the end of the PCM wave, whichever comes first.
+			// This is equivalent to rendering sample by sample, as neither can stop the partial in the middle of a run.
+			const Bit16u pitch = tvp->nextPitch();
+			Bit32u runLength = maxBlockLength - blockLength;
+			Bit32u steadyPitchLength = tvp->getSteadyPitchSampleCount() + 1;
+			if (runLength > steadyPitchLength) runLength = steadyPitchLength;
+			runLength = la32IntPair->getPCMWaveSampleCount(pitch, runLength);
+			runLength = getAmpValues(ampValues, runLength);
+			tvp->skipSteadyPitches(runLength - 1);
+			for (Bit32u i = 0; i < runLength; i++) {
+				la32IntPair->generateNextPCMWavePositions(ampValues[i], pitch, pcmWaveBlock, blockLength++);
+			}
+			sampleNum += runLength;
+		}
+		la32IntPair->producePCMOutputBlock(pcmWaveBlock, pairSamples, blockLength);
+		for (Bit32u i = 0; i < blockLength; i++) {
+			produceAndMixSample(leftBuf, rightBuf, pairSamples[i]);
+		}
+	}
+}
+
+bool Partial::checkCulled() {
+	if (culled) return true;
+	// The amplitude only decreases in the release phase, so the partial won't become audible again.
+	// Ring modulation is not considered, as it involves the amplitude of another partial.
+	if (!synth->isPartialCullingEnabled() || hasRingModulatingSlave() || tva->getPhase() != TVA_PHASE_RELEASE) return false;
+	culled = MAX_AMP - ampRamp.getCurrentValue() >= synth->getPartialCullingAmpThreshold();
+	return culled;
+}
+
+void Partial::skipCulledOutput(Bit32u length, LA32IntPartialPair *la32IntPair) {
+	// The envelopes and the PCM wave position are advanced in the same runs as in producePCMOutput(), so that the partial
+	// is deactivated at exactly the same time as if its output were generated.
+	Bit32u values[LA32PCMWaveBlock::LENGTH];
+	while (sampleNum < length) {
+		if (!tva->isPlaying() || !la32IntPair->isActive(LA32PartialPair::MASTER)) {
+			deactivate();
+			break;
+		}
+		const Bit16u pitch = tvp->nextPitch();
+		Bit32u runLength = length - sampleNum;
+		if (runLength > LA32PCMWaveBlock::LENGTH) runLength = LA32PCMWaveBlock::LENGTH;
+		Bit32u steadyPitchLength = tvp->getSteadyPitchSampleCount() + 1;
+		if (runLength > steadyPitchLength) runLength = steadyPitchLength;
+		if (isPCM()) runLength = la32IntPair->getPCMWaveSampleCount(pitch, runLength);
+		runLength = getAmpValues(values, runLength);
+		tvp->skipSteadyPitches(runLength - 1);
+		if (isPCM()) {
+			la32IntPair->skipPCMWaveSamples(pitch, runLength);
+		} else {
+			// The TVF envelope is independent of the others, so its interrupts may be handled within the run.
+			for (Bit32u cutoffCount = 0; cutoffCount < runLength;) {
+				cutoffCount += getCutoffValues(values, runLength - cutoffCount);
+			}
+		}
+		sampleNum += runLength;
+		synth->partialSamplesCulled(runLength);
+	}
+}
+
 bool Partial::produceOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length) {
 	if (floatMode) {
 		synth->printDebug("Partial: Invalid call to produceOutput()! Renderer = %d\n", synth->getSelectedRendererType());
 		return false;
 	}
-	return doProduceOutput(leftBuf, rightBuf, length, static_cast<LA32IntPartialPair *>(la32Pair));
+	if (!canProduceOutput()) return false;
+	alreadyOutputed = true;
+
+	LA32IntPartialPair *la32IntPair = static_cast<LA32IntPartialPair *>(la32Pair);
+	sampleNum = 0;
+	if (checkCulled()) {
+		skipCulledOutput(length, la32IntPair);
+	} else if (isPCM() && !hasRingModulatingSlave()) {
+		producePCMOutput(leftBuf, rightBuf, length, la32IntPair);
+	} else {
+		produceBlockedOutput(leftBuf, rightBuf, length, la32IntPair);
+	}
+	sampleNum = 0;
+	return true;
 }
 
 bool Partial::produceOutput(FloatSample *leftBuf, FloatSample *rightBuf, Bit32u length) {
@@ -389,7 +533,7 @@ bool Partial::shouldReverb() {
 	if (!isActive()) {
 		return false;
 	}
-	return patchCache->reverb;
+	return reverb;
 }
 
 void Partial::startAbort() {
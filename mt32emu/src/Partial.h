@@ -36,6 +36,15 @@ class TVF;
 class TVP;
 struct ControlROMPCMStruct;
 
+// Memory preallocated by the PartialManager for the state of a single Partial.
+// The memory of all the partials is laid out in contiguous arrays, so that the state is traversed sequentially while rendering.
+struct PartialStorage {
+	void *tva;
+	void *tvp;
+	void *tvf;
+	void *la32Pair;
+};
+
 // A partial represents one of up to four waveform generators currently playing within a poly.
 class Partial {
 private:
@@ -73,28 +82,43 @@ private:
 	LA32Ramp ampRamp;
 	LA32Ramp cutoffModifierRamp;
 
+	// Set when the partial has become inaudible in the release phase and its waveform is no longer generated
+	bool culled;
+
 	// TODO: This should be owned by PartialPair
 	LA32PartialPair *la32Pair;
 	const bool floatMode;
 
-	const PatchCache *patchCache;
-	PatchCache cachebackup;
+	// Whether the partial goes to the reverb, as set for the part or the rhythm key at the time the partial started.
+	bool reverb;
 
 	Bit32u getAmpValue();
 	Bit32u getCutoffValue();
+	// Same as getAmpValue() and getCutoffValue() respectively but for a block of samples. Each stops early right after
+	// the sample which triggers an envelope interrupt (that is already handled). Return the number of values produced.
+	Bit32u getAmpValues(Bit32u *ampValues, Bit32u length);
+	Bit32u getCutoffValues(Bit32u *cutoffValues, Bit32u length);
 
 	template <class Sample, class LA32PairImpl>
 	bool doProduceOutput(Sample *leftBuf, Sample *rightBuf, Bit32u length, LA32PairImpl *la32PairImpl);
 	bool canProduceOutput();
+	void produceBlockedOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length, LA32IntPartialPair *la32IntPair);
+	void producePCMOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length, LA32IntPartialPair *la32IntPair);
+	bool checkCulled();
+	void skipCulledOutput(Bit32u length, LA32IntPartialPair *la32IntPair);
 	template <class LA32PairImpl>
 	bool generateNextSample(LA32PairImpl *la32PairImpl);
-	void produceAndMixSample(IntSample *&leftBuf, IntSample *&rightBuf, LA32IntPartialPair *la32IntPair);
+	void produceAndMixSample(IntSample *&leftBuf, IntSample *&rightBuf, const Bit16s pairSample);
 	void produceAndMixSample(FloatSample *&leftBuf, FloatSample *&rightBuf, LA32FloatPartialPair *la32FloatPair);
 
 public:
+	// Amplitude values are produced by subtracting the amplitude ramp value from this, so that the amplitude
+	// is represented as attenuation. The partial is completely silent once the attenuation reaches this value.
+	static const Bit32u MAX_AMP = 67117056;
+
 	bool alreadyOutputed;
 
-	Partial(Synth *synth, int debugPartialNum);
+	Partial(Synth *synth, int debugPartialNum, const PartialStorage &storage);
 	~Partial();
 
 	int debugGetPartialNum() const;
@@ -105,7 +129,9 @@ public:
 	bool isActive() const;
 	void activate(int part);
 	void deactivate(void);
-	void startPartial(const Part *part, Poly *usePoly, const PatchCache *useCache, const MemParams::RhythmTemp *rhythmTemp, Partial *pairPartial);
+	// The patch cache is only read while starting, so it may be a shared entry that gets recached later on.
+	// The partial parameters are expected to point into live sysex-addressable memory.
+	void startPartial(const Part *part, Poly *usePoly, const PatchCache *patchCache, const TimbreParam::PartialParam *partialParam, const MemParams::RhythmTemp *rhythmTemp, Partial *pairPartial);
 	void startAbort();
 	void startDecayAll();
 	bool shouldReverb();
@@ -117,7 +143,6 @@ public:
 	Synth *getSynth() const;
 	TVA *getTVA() const;
 
-	void backupCache(const PatchCache &cache);
 
 	// Returns true only if data written to buffer
 	// These functions produce processed stereo samples
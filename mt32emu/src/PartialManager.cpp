@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <cstring>
+#include <new>
 
 #include "internals.h"
 
@@ -25,19 +26,52 @@
 #include "Partial.h"
 #include "Poly.h"
 #include "Synth.h"
+#include "TVA.h"
+#include "TVF.h"
+#include "TVP.h"
 
 namespace MT32Emu {
 
+static const size_t CACHE_LINE_SIZE = 64;
+
+static size_t alignToCacheLine(size_t size) {
+	return (size + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+}
+
 PartialManager::PartialManager(Synth *useSynth, Part **useParts) {
 	synth = useSynth;
 	parts = useParts;
 	inactivePartialCount = synth->getPartialCount();
-	partialTable = new Partial *[inactivePartialCount];
+	partialLimit = inactivePartialCount;
 	inactivePartials = new int[inactivePartialCount];
 	freePolys = new Poly *[synth->getPartialCount()];
 	firstFreePolyIndex = 0;
+
+	// The state of all the partials lives in a single pool of contiguous arrays, each one aligned to a cache line.
+	const size_t partialCount = synth->getPartialCount();
+	const size_t la32PairSize = synth->getSelectedRendererType() == RendererType_FLOAT ? sizeof(LA32FloatPartialPair) : sizeof(LA32IntPartialPair);
+	const size_t partialsSize = alignToCacheLine(partialCount * sizeof(Partial));
+	const size_t la32PairsSize = alignToCacheLine(partialCount * la32PairSize);
+	const size_t tvasSize = alignToCacheLine(partialCount * sizeof(TVA));
+	const size_t tvpsSize = alignToCacheLine(partialCount * sizeof(TVP));
+	const size_t tvfsSize = alignToCacheLine(partialCount * sizeof(TVF));
+	partialPoolMemory = new Bit8u[partialsSize + la32PairsSize + tvasSize + tvpsSize + tvfsSize + CACHE_LINE_SIZE - 1];
+
+	Bit8u *partialsPool = reinterpret_cast<Bit8u *>(alignToCacheLine(reinterpret_cast<size_t>(partialPoolMemory)));
+	Bit8u *la32PairsPool = partialsPool + partialsSize;
+	Bit8u *tvasPool = la32PairsPool + la32PairsSize;
+	Bit8u *tvpsPool = tvasPool + tvasSize;
+	Bit8u *tvfsPool = tvpsPool + tvpsSize;
+
+	partialTable = reinterpret_cast<Partial *>(partialsPool);
 	for (unsigned int i = 0; i < synth->getPartialCount(); i++) {
-		partialTable[i] = new Partial(synth, i);
+		PartialStorage storage = {
+			tvasPool + i * sizeof(TVA),
+			tvpsPool + i * sizeof(TVP),
+			tvfsPool + i * sizeof(TVF),
+			la32PairsPool + i * la32PairSize
+		};
+		new(partialTable + i) Partial(synth, i, storage);
 		inactivePartials[i] = inactivePartialCount - i - 1;
 		freePolys[i] = new Poly();
 	}
@@ -45,35 +79,47 @@ PartialManager::PartialManager(Synth *useSynth, Part **useParts) {
 
 PartialManager::~PartialManager(void) {
 	for (unsigned int i = 0; i < synth->getPartialCount(); i++) {
-		delete partialTable[i];
+		partialTable[i].~Partial();
 		if (freePolys[i] != NULL) delete freePolys[i];
 	}
-	delete[] partialTable;
+	delete[] partialPoolMemory;
 	delete[] inactivePartials;
 	delete[] freePolys;
 }
 
 void PartialManager::clearAlreadyOutputed() {
 	for (unsigned int i = 0; i < synth->getPartialCount(); i++) {
-		partialTable[i]->alreadyOutputed = false;
+		partialTable[i].alreadyOutputed = false;
 	}
 }
 
-bool PartialManager::shouldReverb(int i) {
-	return partialTable[i]->shouldReverb();
+template <class Sample>
+void PartialManager::doProduceOutput(Sample *nonReverbLeftBuf, Sample *nonReverbRightBuf, Sample *reverbLeftBuf, Sample *reverbRightBuf, Bit32u bufferLength) {
+	const unsigned int partialCount = synth->getPartialCount();
+	// Quite common when rendering in small chunks, no need to visit each partial
+	if (inactivePartialCount == partialCount) return;
+	for (unsigned int i = 0; i < partialCount; i++) {
+		Partial &partial = partialTable[i];
+		if (!partial.isActive()) continue;
+		if (partial.shouldReverb()) {
+			partial.produceOutput(reverbLeftBuf, reverbRightBuf, bufferLength);
+		} else {
+			partial.produceOutput(nonReverbLeftBuf, nonReverbRightBuf, bufferLength);
+		}
+	}
 }
 
-bool PartialManager::produceOutput(int i, IntSample *leftBuf, IntSample *rightBuf, Bit32u bufferLength) {
-	return partialTable[i]->produceOutput(leftBuf, rightBuf, bufferLength);
+void PartialManager::produceOutput(IntSample *nonReverbLeftBuf, IntSample *nonReverbRightBuf, IntSample *reverbLeftBuf, IntSample *reverbRightBuf, Bit32u bufferLength) {
+	doProduceOutput(nonReverbLeftBuf, nonReverbRightBuf, reverbLeftBuf, reverbRightBuf, bufferLength);
 }
 
-bool PartialManager::produceOutput(int i, FloatSample *leftBuf, FloatSample *rightBuf, Bit32u bufferLength) {
-	return partialTable[i]->produceOutput(leftBuf, rightBuf, bufferLength);
+void PartialManager::produceOutput(FloatSample *nonReverbLeftBuf, FloatSample *nonReverbRightBuf, FloatSample *reverbLeftBuf, FloatSample *reverbRightBuf, Bit32u bufferLength) {
+	doProduceOutput(nonReverbLeftBuf, nonReverbRightBuf, reverbLeftBuf, reverbRightBuf, bufferLength);
 }
 
 void PartialManager::deactivateAll() {
 	for (unsigned int i = 0; i < synth->getPartialCount(); i++) {
-		partialTable[i]->deactivate();
+		partialTable[i].deactivate();
 	}
 }
 
@@ -88,28 +134,58 @@ unsigned int PartialManager::setReserve(Bit8u *rset) {
 
 Partial *PartialManager::allocPartial(int partNum) {
 	if (inactivePartialCount > 0) {
-		Partial *partial = partialTable[inactivePartials[--inactivePartialCount]];
+		Partial *partial = &partialTable[inactivePartials[--inactivePartialCount]];
 		partial->activate(partNum);
 		return partial;
 	}
 	synth->printDebug("PartialManager Error: No inactive partials to allocate for part %d, current partial state:\n", partNum);
 	for (Bit32u i = 0; i < synth->getPartialCount(); i++) {
-		const Partial *partial = partialTable[i];
+		const Partial *partial = &partialTable[i];
 		synth->printDebug("[Partial %d]: activation=%d, owner part=%d\n", i, partial->isActive(), partial->getOwnerPart());
 	}
 	return NULL;
 }
 
 unsigned int PartialManager::getFreePartialCount() {
-	return inactivePartialCount;
+	const unsigned int activePartialCount = getActivePartialCount();
+	return activePartialCount < partialLimit ? partialLimit - activePartialCount : 0;
+}
+
+unsigned int PartialManager::getActivePartialCount() const {
+	return synth->getPartialCount() - inactivePartialCount;
+}
+
+void PartialManager::setPartialLimit(Bit32u newPartialLimit) {
+	if (newPartialLimit < 1) {
+		newPartialLimit = 1;
+	} else if (newPartialLimit > synth->getPartialCount()) {
+		newPartialLimit = synth->getPartialCount();
+	}
+	partialLimit = newPartialLimit;
+}
+
+Bit32u PartialManager::getPartialLimit() const {
+	return partialLimit;
+}
+
+// When there are more active partials than the limit permits, aborts a poly following the same priorities as freePartials()
+// does when allocating for the rhythm part. Only one poly is aborted at a time, so this needs to be invoked repeatedly
+// until the excess polys are gone.
+void PartialManager::enforcePartialLimit() {
+	if (getActivePartialCount() <= partialLimit || synth->isAbortingPoly()) return;
+	if (abortFirstReleasingPolyWhereReserveExceeded(-1)) return;
+	if (abortFirstPolyPreferHeldWhereReserveExceeded(-1)) return;
+	for (int partNum = 7; partNum >= -1; partNum--) {
+		if (parts[partNum == -1 ? 8 : partNum]->abortFirstPolyPreferHeld()) return;
+	}
 }
 
 // This function is solely used to gather data for debug output at the moment.
 void PartialManager::getPerPartPartialUsage(unsigned int perPartPartialUsage[9]) {
 	memset(perPartPartialUsage, 0, 9 * sizeof(unsigned int));
 	for (unsigned int i = 0; i < synth->getPartialCount(); i++) {
-		if (partialTable[i]->isActive()) {
-			perPartPartialUsage[partialTable[i]->getOwnerPart()]++;
+		if (partialTable[i].isActive()) {
+			perPartPartialUsage[partialTable[i].getOwnerPart()]++;
 		}
 	}
 }
@@ -259,7 +335,7 @@ const Partial *PartialManager::getPartial(unsigned int partialNum) const {
 	if (partialNum > synth->getPartialCount() - 1) {
 		return NULL;
 	}
-	return partialTable[partialNum];
+	return &partialTable[partialNum];
 }
 
 Poly *PartialManager::assignPolyToPart(Part *part) {
@@ -299,7 +375,7 @@ void PartialManager::partialDeactivated(int partialIndex) {
 	}
 	synth->printDebug("PartialManager Error: Cannot return deactivated partial %d, current partial state:\n", partialIndex);
 	for (Bit32u i = 0; i < synth->getPartialCount(); i++) {
-		const Partial *partial = partialTable[i];
+		const Partial *partial = &partialTable[i];
 		synth->printDebug("[Partial %d]: activation=%d, owner part=%d\n", i, partial->isActive(), partial->getOwnerPart());
 	}
 }
@@ -34,12 +34,16 @@ private:
 	Synth *synth;
 	Part **parts;
 	Poly **freePolys;
-	Partial **partialTable;
+	Partial *partialTable;
+	Bit8u *partialPoolMemory; // Backs partialTable and all the state of the partials
 	Bit8u numReservedPartialsForPart[9];
 	Bit32u firstFreePolyIndex;
 	int *inactivePartials; // Holds indices of inactive Partials in the Partial table
 	Bit32u inactivePartialCount;
+	Bit32u partialLimit; // Maximum number of active partials permitted, doesn't exceed the size of the partial table
 
+	template <class Sample>
+	void doProduceOutput(Sample *nonReverbLeftBuf, Sample *nonReverbRightBuf, Sample *reverbLeftBuf, Sample *reverbRightBuf, Bit32u bufferLength);
 	bool abortFirstReleasingPolyWhereReserveExceeded(int minPart);
 	bool abortFirstPolyPreferHeldWhereReserveExceeded(int minPart);
 
@@ -48,13 +52,17 @@ public:
 	~PartialManager();
 	Partial *allocPartial(int partNum);
 	unsigned int getFreePartialCount();
+	unsigned int getActivePartialCount() const;
+	void setPartialLimit(Bit32u newPartialLimit);
+	Bit32u getPartialLimit() const;
+	void enforcePartialLimit();
 	void getPerPartPartialUsage(unsigned int perPartPartialUsage[9]);
 	bool freePartials(unsigned int needed, int partNum);
 	unsigned int setReserve(Bit8u *rset);
 	void deactivateAll();
-	bool produceOutput(int i, IntSample *leftBuf, IntSample *rightBuf, Bit32u bufferLength);
-	bool produceOutput(int i, FloatSample *leftBuf, FloatSample *rightBuf, Bit32u bufferLength);
-	bool shouldReverb(int i);
+	// Renders all the active partials in one pass, mixing their output to either reverb or non-reverb buffers
+	void produceOutput(IntSample *nonReverbLeftBuf, IntSample *nonReverbRightBuf, IntSample *reverbLeftBuf, IntSample *reverbRightBuf, Bit32u bufferLength);
+	void produceOutput(FloatSample *nonReverbLeftBuf, FloatSample *nonReverbRightBuf, FloatSample *reverbLeftBuf, FloatSample *reverbRightBuf, Bit32u bufferLength);
 	void clearAlreadyOutputed();
 	const Partial *getPartial(unsigned int partialNum) const;
 	Poly *assignPolyToPart(Part *part);
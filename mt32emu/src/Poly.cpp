@@ -130,15 +130,6 @@ void Poly::setState(PolyState newState) {
 	part->polyStateChanged(oldState, newState);
 }
 
-void Poly::backupCacheToPartials(PatchCache cache[4]) {
-	for (int partialNum = 0; partialNum < 4; partialNum++) {
-		Partial *partial = partials[partialNum];
-		if (partial != NULL) {
-			partial->backupCache(cache[partialNum]);
-		}
-	}
-}
-
 /**
  * Returns the internal key identifier.
  * For non-rhythm, this is within the range 12 to 108.
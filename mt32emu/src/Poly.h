@@ -25,7 +25,6 @@ namespace MT32Emu {
 
 class Part;
 class Partial;
-struct PatchCache;
 
 class Poly {
 private:
@@ -52,7 +51,6 @@ public:
 	bool startDecay();
 	bool startAbort();
 
-	void backupCacheToPartials(PatchCache cache[4]);
 
 	unsigned int getKey() const;
 	unsigned int getVelocity() const;
@@ -30,15 +30,15 @@
 
 using namespace MT32Emu;
 
-static inline void *createDelegate(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality) {
+static inline void *createDelegate(Synth &synth, SynthOutputSource *synthOutputSource, double targetSampleRate, SamplerateConversionQuality quality) {
 #if MT32EMU_WITH_LIBSOXR_RESAMPLER
-	return new SoxrAdapter(synth, targetSampleRate, quality);
+	return new SoxrAdapter(synth, synthOutputSource, targetSampleRate, quality);
 #elif MT32EMU_WITH_LIBSAMPLERATE_RESAMPLER
-	return new SamplerateAdapter(synth, targetSampleRate, quality);
+	return new SamplerateAdapter(synth, synthOutputSource, targetSampleRate, quality);
 #elif MT32EMU_WITH_INTERNAL_RESAMPLER
-	return new InternalResampler(synth, targetSampleRate, quality);
+	return new InternalResampler(synth, synthOutputSource, targetSampleRate, quality);
 #else
-	(void)synth, (void)targetSampleRate, (void)quality;
+	(void)synth, (void)synthOutputSource, (void)targetSampleRate, (void)quality;
 	return NULL;
 #endif
 }
@@ -64,7 +64,14 @@ double SampleRateConverter::getSupportedOutputSampleRate(double desiredSampleRat
 SampleRateConverter::SampleRateConverter(Synth &useSynth, double targetSampleRate, SamplerateConversionQuality useQuality) :
 	synthInternalToTargetSampleRateRatio(SAMPLE_RATE / targetSampleRate),
 	useSynthDelegate(useSynth.getStereoOutputSampleRate() == targetSampleRate),
-	srcDelegate(useSynthDelegate ? &useSynth : createDelegate(useSynth, targetSampleRate, useQuality))
+	srcDelegate(useSynthDelegate ? &useSynth : createDelegate(useSynth, NULL, targetSampleRate, useQuality))
+{}
+
+// When the sample rates match, the delegate still passes the samples through, as it's the only place to keep the source.
+SampleRateConverter::SampleRateConverter(Synth &useSynth, double targetSampleRate, SamplerateConversionQuality useQuality, SynthOutputSource &synthOutputSource) :
+	synthInternalToTargetSampleRateRatio(SAMPLE_RATE / targetSampleRate),
+	useSynthDelegate(false),
+	srcDelegate(createDelegate(useSynth, &synthOutputSource, targetSampleRate, useQuality))
 {}
 
 SampleRateConverter::~SampleRateConverter() {
@@ -25,6 +25,18 @@ namespace MT32Emu {
 
 class Synth;
 
+/* Interface for an alternative source of the synthesiser output signal consumed by SampleRateConverter.
+ * It allows the synth output to be rendered separately from the sample rate conversion, e.g. ahead of time in another thread.
+ */
+class MT32EMU_EXPORT_V(2.8) SynthOutputSource {
+public:
+	virtual ~SynthOutputSource() {}
+
+	// Fills the provided buffer with the specified number of stereo frames of the synth output,
+	// exactly as Synth::render(float *, Bit32u) would.
+	virtual void getSynthOutputSamples(float *buffer, unsigned int length) = 0;
+};
+
 /* SampleRateConverter class allows to convert the synthesiser output to any desired sample rate.
  * It processes the completely mixed stereo output signal as it passes the analogue circuit emulation,
  * so emulating the synthesiser output signal passing further through an ADC.
@@ -44,6 +56,11 @@ public:
 	// Creates a SampleRateConverter instance that converts output signal from the synth to the given sample rate
 	// with the specified conversion quality.
 	SampleRateConverter(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality);
+
+	// Creates a SampleRateConverter instance that converts the synth output signal retrieved from the provided source
+	// rather than rendered directly. The synth is only used to determine the input sample rate, therefore, it must be open
+	// with the analogue output mode in effect. The source must remain valid during the lifetime of this instance.
+	SampleRateConverter(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality, SynthOutputSource &synthOutputSource);
 	~SampleRateConverter();
 
 	// Fills the provided output buffer with the results of the sample rate conversion.
@@ -0,0 +1,250 @@
+/* Copyright (C) 2003, 2004, 2005, 2006, 2008, 2009 Dean Beeler, Jerome Fisher
+ * Copyright (C) 2011-2022 Dean Beeler, Jerome Fisher, Sergey V. Mikayev
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include "internals.h"
+
+#include "SharedROMData.h"
+#include "sha1/sha1.h"
+
+#if MT32EMU_WITH_SHARED_ROM_DATA
+
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MT32Emu {
+
+static const char OBJECT_MAGIC[] = "MT32PCM";
+static const Bit32u OBJECT_FORMAT_VERSION = 1;
+
+struct SharedPCMROMDataHeader {
+	char magic[sizeof(OBJECT_MAGIC)];
+	Bit32u formatVersion;
+	Bit32u sampleCount;
+	File::SHA1Digest romDigest;
+	Bit8u dataDigest[20];
+};
+
+// The samples follow the header aligned, so that the data remains suitably aligned for any access pattern.
+static const size_t DATA_OFFSET = 128;
+
+// An unpublished object that hasn't been modified for this long is considered abandoned by a creator that died.
+// Decoding takes a fraction of a second, so this is merely a safety margin.
+static const time_t STALE_OBJECT_AGE_SECONDS = 10;
+
+static inline SharedPCMROMDataHeader &getHeader(Bit8u *mapping) {
+	return *reinterpret_cast<SharedPCMROMDataHeader *>(mapping);
+}
+
+static inline size_t getMappingSize(size_t sampleCount) {
+	return DATA_OFFSET + sampleCount * sizeof(Bit16s);
+}
+
+// Only objects created by the same user are trusted, since any local user could otherwise place crafted data
+// under the expected name. The digest stored in the header merely ensures the data is intact.
+static bool isObjectTrusted(const struct stat &objectStat) {
+	return objectStat.st_uid == geteuid() && (objectStat.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+static bool isPublished(const Bit8u *bytes) {
+	return memcmp(getHeader(const_cast<Bit8u *>(bytes)).magic, OBJECT_MAGIC, sizeof(OBJECT_MAGIC)) == 0;
+}
+
+static bool isObjectValid(const Bit8u *bytes, size_t size, const File::SHA1Digest &romDigest, size_t sampleCount) {
+	const SharedPCMROMDataHeader &header = getHeader(const_cast<Bit8u *>(bytes));
+	bool valid = isPublished(bytes)
+		&& header.formatVersion == OBJECT_FORMAT_VERSION
+		&& header.sampleCount == sampleCount
+		&& memcmp(header.romDigest, romDigest, sizeof(File::SHA1Digest)) == 0;
+	if (valid) {
+		Bit8u dataDigest[sizeof(header.dataDigest)];
+		sha1::calc(bytes + DATA_OFFSET, int(size - DATA_OFFSET), dataDigest);
+		valid = memcmp(dataDigest, header.dataDigest, sizeof(dataDigest)) == 0;
+	}
+	return valid;
+}
+
+// Removes the existing object with the given name when it is either invalid or left unpublished by a creator
+// that died before completing it. Returns true if the name is free to create a new object.
+static bool removeStaleObject(const char *name, const File::SHA1Digest &romDigest, size_t sampleCount) {
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1) return errno == ENOENT;
+	struct stat objectStat;
+	bool stale = false;
+	if (fstat(fd, &objectStat) == 0 && isObjectTrusted(objectStat)) {
+		const size_t size = getMappingSize(sampleCount);
+		bool abandoned = time(NULL) - objectStat.st_mtime >= STALE_OBJECT_AGE_SECONDS;
+		if (size_t(objectStat.st_size) != size) {
+			stale = abandoned;
+		} else {
+			void *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+			if (mapping != MAP_FAILED) {
+				const Bit8u *bytes = static_cast<const Bit8u *>(mapping);
+				stale = isPublished(bytes) ? !isObjectValid(bytes, size, romDigest, sampleCount) : abandoned;
+				munmap(mapping, size);
+			}
+		}
+	}
+	close(fd);
+	return stale && shm_unlink(name) == 0;
+}
+
+static bool makeObjectName(char *objectName, size_t maxLength, const char *namePrefix, const File::SHA1Digest &romDigest) {
+	if (namePrefix == NULL || *namePrefix == 0 || strchr(namePrefix, '/') != NULL) return false;
+	size_t prefixLength = strlen(namePrefix);
+	size_t digestLength = strlen(romDigest);
+	// The name starts with a slash, and the prefix is separated from the digest with a dash.
+	if (prefixLength + digestLength + 2 > maxLength) return false;
+	objectName[0] = '/';
+	memcpy(objectName + 1, namePrefix, prefixLength);
+	objectName[prefixLength + 1] = '-';
+	memcpy(objectName + prefixLength + 2, romDigest, digestLength + 1);
+	return true;
+}
+
+SharedPCMROMData::SharedPCMROMData(Bit8u *useMapping, size_t useMappingSize, bool usePublished, const char *useObjectName, int useObjectFd) :
+	mapping(useMapping), mappingSize(useMappingSize), published(usePublished), objectFd(useObjectFd)
+{
+	strcpy(objectName, useObjectName);
+}
+
+SharedPCMROMData *SharedPCMROMData::map(const char *namePrefix, const File::SHA1Digest &romDigest, size_t sampleCount) {
+	char name[MAX_OBJECT_NAME_LENGTH + 1];
+	if (!makeObjectName(name, MAX_OBJECT_NAME_LENGTH, namePrefix, romDigest)) return NULL;
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1) return NULL;
+	const size_t size = getMappingSize(sampleCount);
+	struct stat objectStat;
+	void *mapping = MAP_FAILED;
+	if (fstat(fd, &objectStat) == 0 && isObjectTrusted(objectStat) && size_t(objectStat.st_size) == size) {
+		mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (mapping == MAP_FAILED) return NULL;
+
+	Bit8u *bytes = static_cast<Bit8u *>(mapping);
+	if (!isObjectValid(bytes, size, romDigest, sampleCount)) {
+		munmap(mapping, size);
+		return NULL;
+	}
+	return new SharedPCMROMData(bytes, size, true, name, -1);
+}
+
+SharedPCMROMData *SharedPCMROMData::create(const char *namePrefix, const File::SHA1Digest &romDigest, size_t sampleCount) {
+	char name[MAX_OBJECT_NAME_LENGTH + 1];
+	if (!makeObjectName(name, MAX_OBJECT_NAME_LENGTH, namePrefix, romDigest)) return NULL;
+	// Other processes of the same user are only allowed to read the object. The creator writes via the mapping established below.
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR);
+	if (fd == -1) {
+		if (errno != EEXIST || !removeStaleObject(name, romDigest, sampleCount)) return NULL;
+		fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR);
+		if (fd == -1) return NULL;
+	}
+	const size_t size = getMappingSize(sampleCount);
+	void *mapping = MAP_FAILED;
+	if (ftruncate(fd, off_t(size)) == 0) {
+		mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (mapping == MAP_FAILED) {
+		close(fd);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	Bit8u *bytes = static_cast<Bit8u *>(mapping);
+	SharedPCMROMDataHeader &header = getHeader(bytes);
+	// The magic is only written once the data is complete.
+	memset(&header, 0, sizeof(header));
+	header.formatVersion = OBJECT_FORMAT_VERSION;
+	header.sampleCount = Bit32u(sampleCount);
+	memcpy(header.romDigest, romDigest, sizeof(File::SHA1Digest));
+	// The descriptor is kept open until the object is published, to identify it in case it has to be removed.
+	return new SharedPCMROMData(bytes, size, false, name, fd);
+}
+
+SharedPCMROMData::~SharedPCMROMData() {
+	munmap(mapping, mappingSize);
+	if (objectFd == -1) return;
+	if (!published) {
+		// Another process may have replaced the object, assuming it abandoned. Only remove the one we created.
+		int fd = shm_open(objectName, O_RDONLY, 0);
+		if (fd != -1) {
+			struct stat ownStat, namedStat;
+			if (fstat(objectFd, &ownStat) == 0 && fstat(fd, &namedStat) == 0
+				&& ownStat.st_dev == namedStat.st_dev && ownStat.st_ino == namedStat.st_ino) {
+				shm_unlink(objectName);
+			}
+			close(fd);
+		}
+	}
+	close(objectFd);
+}
+
+bool SharedPCMROMData::publish() {
+	if (published) return true;
+	SharedPCMROMDataHeader &header = getHeader(mapping);
+	sha1::calc(mapping + DATA_OFFSET, int(mappingSize - DATA_OFFSET), header.dataDigest);
+	memcpy(header.magic, OBJECT_MAGIC, sizeof(OBJECT_MAGIC));
+	if (mprotect(mapping, mappingSize, PROT_READ) != 0) return false;
+	published = true;
+	close(objectFd);
+	objectFd = -1;
+	return true;
+}
+
+Bit16s *SharedPCMROMData::getData() const {
+	return reinterpret_cast<Bit16s *>(mapping + DATA_OFFSET);
+}
+
+} // namespace MT32Emu
+
+#else // #if MT32EMU_WITH_SHARED_ROM_DATA
+
+namespace MT32Emu {
+
+SharedPCMROMData::SharedPCMROMData(Bit8u *useMapping, size_t useMappingSize, bool usePublished, const char *useObjectName, int useObjectFd) :
+	mapping(useMapping), mappingSize(useMappingSize), published(usePublished), objectFd(useObjectFd)
+{
+	strcpy(objectName, useObjectName);
+}
+
+SharedPCMROMData *SharedPCMROMData::map(const char *, const File::SHA1Digest &, size_t) {
+	return NULL;
+}
+
+SharedPCMROMData *SharedPCMROMData::create(const char *, const File::SHA1Digest &, size_t) {
+	return NULL;
+}
+
+SharedPCMROMData::~SharedPCMROMData() {}
+
+bool SharedPCMROMData::publish() {
+	return false;
+}
+
+Bit16s *SharedPCMROMData::getData() const {
+	return NULL;
+}
+
+} // namespace MT32Emu
+
+#endif // #if MT32EMU_WITH_SHARED_ROM_DATA
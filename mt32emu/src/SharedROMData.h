@@ -0,0 +1,75 @@
+/* Copyright (C) 2003, 2004, 2005, 2006, 2008, 2009 Dean Beeler, Jerome Fisher
+ * Copyright (C) 2011-2022 Dean Beeler, Jerome Fisher, Sergey V. Mikayev
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MT32EMU_SHARED_ROM_DATA_H
+#define MT32EMU_SHARED_ROM_DATA_H
+
+#include <cstddef>
+
+#include "globals.h"
+#include "Types.h"
+#include "File.h"
+
+namespace MT32Emu {
+
+/**
+ * Decoded PCM ROM data placed in a named POSIX shared memory object, so that processes using the same PCM ROM image
+ * can map it read-only instead of decoding and keeping private copies. The object name is composed of the name prefix
+ * supplied by the client and the SHA1 digest of the ROM image. The header of the object contains the SHA1 digest
+ * of the decoded data, which is verified each time the object is mapped. Hence, an object that is incomplete, damaged
+ * or built from a different image is never used. Objects are only shared among processes of the same user, an object
+ * owned by another user or writable by others is never trusted. An invalid object, or one left unpublished by a process
+ * that died while creating it, is replaced by the next process that attempts to create it. Otherwise, the object persists
+ * until it is removed explicitly or the system reboots.
+ * When the library is built without support for shared memory, no object can be either mapped or created.
+ */
+class SharedPCMROMData {
+public:
+	// Maps an existing object with the decoded data of the PCM ROM image identified by romDigest.
+	// Returns NULL if there is no such object, it is not trusted or it fails the integrity check.
+	static SharedPCMROMData *map(const char *namePrefix, const File::SHA1Digest &romDigest, size_t sampleCount);
+
+	// Creates a new object for the decoded data of the PCM ROM image identified by romDigest. The caller is expected
+	// to fill in the data returned by getData() and then invoke publish(). Returns NULL if the object already exists
+	// or cannot be created. An existing object that is invalid or abandoned unpublished is removed and created anew.
+	static SharedPCMROMData *create(const char *namePrefix, const File::SHA1Digest &romDigest, size_t sampleCount);
+
+	// Unmaps the object. An object that has been created but not published is removed.
+	~SharedPCMROMData();
+
+	// Returns the decoded samples. Once the object is mapped or published, the memory is read-only.
+	Bit16s *getData() const;
+
+	// Stores the SHA1 digest of the decoded data in the header and protects the memory from further modification,
+	// thus making the object available for other processes to map.
+	bool publish();
+
+private:
+	static const size_t MAX_OBJECT_NAME_LENGTH = 255;
+
+	Bit8u * const mapping;
+	const size_t mappingSize;
+	bool published;
+	int objectFd;
+	char objectName[MAX_OBJECT_NAME_LENGTH + 1];
+
+	SharedPCMROMData(Bit8u *useMapping, size_t useMappingSize, bool usePublished, const char *useObjectName, int useObjectFd);
+};
+
+} // namespace MT32Emu
+
+#endif // #ifndef MT32EMU_SHARED_ROM_DATA_H
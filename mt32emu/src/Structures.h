@@ -242,7 +242,8 @@ struct PCMWaveEntry {
 	ControlROMPCMStruct *controlROMPCMStruct;
 };
 
-// This is basically a per-partial, pre-processed combination of timbre and patch/rhythm settings
+// This is basically a per-partial, pre-processed form of timbre settings.
+// It depends on nothing but the timbre, so that a single entry may be shared by all the parts playing the timbre.
 struct PatchCache {
 	bool playPartial;
 	bool PCMPartial;
@@ -257,12 +258,8 @@ struct PatchCache {
 	bool dirty;
 	Bit32u partialCount;
 	bool sustain;
-	bool reverb;
 
 	TimbreParam::PartialParam srcPartial;
-
-	// The following directly points into live sysex-addressable memory
-	const TimbreParam::PartialParam *partialParam;
 };
 
 } // namespace MT32Emu
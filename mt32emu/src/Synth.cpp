@@ -31,6 +31,7 @@
 #include "PartialManager.h"
 #include "Poly.h"
 #include "ROMInfo.h"
+#include "SharedROMData.h"
 #include "TVA.h"
 
 #if MT32EMU_MONITOR_SYSEX > 0
@@ -42,6 +43,17 @@ namespace MT32Emu {
 // MIDI interface data transfer rate in samples. Used to simulate the transfer delay.
 static const double MIDI_DATA_TRANSFER_RATE = double(SAMPLE_RATE) / 31250.0 * 8.0;
 
+// Partial amplitude attenuation is represented in the same log-space as the wave generator output, 4096 units per octave,
+// yet with extra 10 bits of precision.
+static const float PARTIAL_AMP_UNITS_PER_OCTAVE = 4194304.0f;
+static const float DECIBELS_PER_OCTAVE = 6.0206f;
+// Once attenuated by 13 octaves, the output of the integer wave generator is always zero.
+static const Bit32u DEFAULT_PARTIAL_CULLING_AMP_THRESHOLD = 13 << 22;
+// The partial limit governor never goes below this number of partials.
+static const Bit32u MIN_GOVERNED_PARTIAL_LIMIT = 8;
+// Number of render load reports to skip after the partial limit is lowered, so that the effect becomes measurable.
+static const Bit32u RENDER_LOAD_HOLD_REPORT_COUNT = 8;
+
 static const ControlROMFeatureSet OLD_MT32_ELDER = {
 	true,  // quirkBasePitchOverflow
 	true,  // quirkPitchEnvelopeOverflow
@@ -145,13 +157,26 @@ protected:
 	}
 
 	bool isActivated() const {
-		return synth.activated;
+		// The MIDI event source is only polled while rendering, hence it always keeps the synth activated.
+		return synth.activated || getMidiEventSource() != NULL;
 	}
 
 	bool isAbortingPoly() const {
 		return synth.isAbortingPoly();
 	}
 
+	bool getMIDIEventSourceDelayedTimestamp(Bit32u &timestamp, Bit32u shortMessage, const Bit8u *sysexData, Bit32u sysexLength) const {
+		return synth.getMIDIEventSourceDelayedTimestamp(timestamp, shortMessage, sysexData, sysexLength);
+	}
+
+	void setLastReceivedMIDIEventTimestamp(Bit32u timestamp) {
+		synth.lastReceivedMIDIEventTimestamp = timestamp;
+	}
+
+	bool playNextSysexBulkMessage() {
+		return synth.playNextSysexBulkMessage();
+	}
+
 	Analog &getAnalog() const {
 		return *synth.analog;
 	}
@@ -160,6 +185,8 @@ protected:
 		return *synth.midiQueue;
 	}
 
+	inline MidiEventSource *getMidiEventSource() const;
+
 	PartialManager &getPartialManager() {
 		return *synth.partialManager;
 	}
@@ -230,6 +257,234 @@ public:
 	void produceStreams(const DACOutputStreams<Sample> &streams, Bit32u len);
 };
 
+/**
+ * Records the notifications issued by the synth while rendering into a lock-free ring buffer, so that the client callbacks
+ * are invoked later from the thread that calls Synth::dispatchDeferredReports(). Each record is stamped with the rendered
+ * sample count. Notifications that either have to return a result or report errors are forwarded to the client immediately.
+ * The buffer is single-producer / single-consumer; when it is full, newly issued notifications are dropped.
+ * Notifications are issued by whichever thread currently invokes the synth, e.g. the rendering thread or a thread that
+ * calls setMainDisplayMode(). Those invocations are already required to be serialised by the client, which makes them
+ * a single producer in turn. The positions are published with release semantics and read with acquire semantics,
+ * so that the consumer never observes a record before it is filled in, and the producer never reuses a record
+ * before the consumer is done with it.
+ */
+class DeferredReportHandler : public ReportHandler2 {
+public:
+	explicit DeferredReportHandler(const Synth &useSynth) :
+		synth(useSynth),
+		ringBuffer(new Report[RING_BUFFER_SIZE]),
+		startPosition(),
+		endPosition(),
+		currentTimestamp(),
+		clientReportHandler(),
+		clientReportHandler2()
+	{}
+
+	~DeferredReportHandler() {
+		delete[] ringBuffer;
+	}
+
+	void setClientReportHandlers(ReportHandler *useReportHandler, ReportHandler2 *useReportHandler2) {
+		clientReportHandler = useReportHandler;
+		clientReportHandler2 = useReportHandler2;
+	}
+
+	Bit32u getCurrentTimestamp() const {
+		return currentTimestamp;
+	}
+
+	Bit32u dispatch() {
+		Bit32u dispatchedCount = 0;
+		for (;;) {
+			Bit32u position = startPosition;
+			if (position == atomicLoadAcquire(endPosition)) break;
+			const volatile Report &report = ringBuffer[position];
+			currentTimestamp = report.timestamp;
+			dispatchReport(report);
+			atomicStoreRelease(startPosition, (position + 1) & RING_BUFFER_MASK);
+			dispatchedCount++;
+		}
+		return dispatchedCount;
+	}
+
+	void printDebug(const char *fmt, va_list list) {
+		clientReportHandler->printDebug(fmt, list);
+	}
+
+	void onErrorControlROM() {
+		clientReportHandler->onErrorControlROM();
+	}
+
+	void onErrorPCMROM() {
+		clientReportHandler->onErrorPCMROM();
+	}
+
+	void showLCDMessage(const char *message) {
+		volatile Report *report = newReport(ReportType_LCD_MESSAGE);
+		if (report == NULL) return;
+		copyText(*report, message);
+		pushReport();
+	}
+
+	void onMIDIMessagePlayed() {
+		if (newReport(ReportType_MIDI_MESSAGE_PLAYED) != NULL) pushReport();
+	}
+
+	bool onMIDIQueueOverflow() {
+		return clientReportHandler->onMIDIQueueOverflow();
+	}
+
+	void onMIDISystemRealtime(Bit8u systemRealtime) {
+		clientReportHandler->onMIDISystemRealtime(systemRealtime);
+	}
+
+	void onDeviceReset() {
+		if (newReport(ReportType_DEVICE_RESET) != NULL) pushReport();
+	}
+
+	void onDeviceReconfig() {
+		if (newReport(ReportType_DEVICE_RECONFIG) != NULL) pushReport();
+	}
+
+	void onNewReverbMode(Bit8u mode) {
+		pushValueReport(ReportType_NEW_REVERB_MODE, mode);
+	}
+
+	void onNewReverbTime(Bit8u time) {
+		pushValueReport(ReportType_NEW_REVERB_TIME, time);
+	}
+
+	void onNewReverbLevel(Bit8u level) {
+		pushValueReport(ReportType_NEW_REVERB_LEVEL, level);
+	}
+
+	void onPolyStateChanged(Bit8u partNum) {
+		pushValueReport(ReportType_POLY_STATE_CHANGED, partNum);
+	}
+
+	void onProgramChanged(Bit8u partNum, const char *soundGroupName, const char *patchName) {
+		volatile Report *report = newReport(ReportType_PROGRAM_CHANGED);
+		if (report == NULL) return;
+		report->value = partNum;
+		// Sound group names point to static storage of the control ROM features, so they remain valid.
+		report->soundGroupName = soundGroupName;
+		copyText(*report, patchName);
+		pushReport();
+	}
+
+	void onLCDStateUpdated() {
+		if (newReport(ReportType_LCD_STATE_UPDATED) != NULL) pushReport();
+	}
+
+	void onMidiMessageLEDStateUpdated(bool ledState) {
+		pushValueReport(ReportType_MIDI_MESSAGE_LED_STATE_UPDATED, ledState ? 1 : 0);
+	}
+
+private:
+	enum ReportType {
+		ReportType_LCD_MESSAGE,
+		ReportType_MIDI_MESSAGE_PLAYED,
+		ReportType_DEVICE_RESET,
+		ReportType_DEVICE_RECONFIG,
+		ReportType_NEW_REVERB_MODE,
+		ReportType_NEW_REVERB_TIME,
+		ReportType_NEW_REVERB_LEVEL,
+		ReportType_POLY_STATE_CHANGED,
+		ReportType_PROGRAM_CHANGED,
+		ReportType_LCD_STATE_UPDATED,
+		ReportType_MIDI_MESSAGE_LED_STATE_UPDATED
+	};
+
+	struct Report {
+		Bit32u timestamp;
+		ReportType type;
+		Bit8u value;
+		const char *soundGroupName;
+		// Fits both a custom LCD message and a patch name.
+		char text[Display::LCD_TEXT_SIZE + 1];
+	};
+
+	static const Bit32u RING_BUFFER_SIZE = 1024;
+	static const Bit32u RING_BUFFER_MASK = RING_BUFFER_SIZE - 1;
+
+	const Synth &synth;
+	volatile Report * const ringBuffer;
+	volatile Bit32u startPosition;
+	volatile Bit32u endPosition;
+	Bit32u currentTimestamp;
+	ReportHandler *clientReportHandler;
+	ReportHandler2 *clientReportHandler2;
+
+	static void copyText(volatile Report &report, const char *text) {
+		Bit32u i = 0;
+		while (i < Display::LCD_TEXT_SIZE && text[i] != 0) {
+			report.text[i] = text[i];
+			i++;
+		}
+		report.text[i] = 0;
+	}
+
+	// Returns the record to fill in or NULL if the ring buffer is full.
+	volatile Report *newReport(ReportType type) {
+		Bit32u position = endPosition;
+		if (((position + 1) & RING_BUFFER_MASK) == atomicLoadAcquire(startPosition)) return NULL;
+		volatile Report &report = ringBuffer[position];
+		report.timestamp = synth.getInternalRenderedSampleCount();
+		report.type = type;
+		return &report;
+	}
+
+	// Publishes the record obtained with the last call to newReport().
+	void pushReport() {
+		atomicStoreRelease(endPosition, (endPosition + 1) & RING_BUFFER_MASK);
+	}
+
+	void pushValueReport(ReportType type, Bit8u value) {
+		volatile Report *report = newReport(type);
+		if (report == NULL) return;
+		report->value = value;
+		pushReport();
+	}
+
+	void dispatchReport(const volatile Report &report) {
+		switch (report.type) {
+		case ReportType_LCD_MESSAGE:
+			clientReportHandler->showLCDMessage(const_cast<const char *>(report.text));
+			break;
+		case ReportType_MIDI_MESSAGE_PLAYED:
+			clientReportHandler->onMIDIMessagePlayed();
+			break;
+		case ReportType_DEVICE_RESET:
+			clientReportHandler->onDeviceReset();
+			break;
+		case ReportType_DEVICE_RECONFIG:
+			clientReportHandler->onDeviceReconfig();
+			break;
+		case ReportType_NEW_REVERB_MODE:
+			clientReportHandler->onNewReverbMode(report.value);
+			break;
+		case ReportType_NEW_REVERB_TIME:
+			clientReportHandler->onNewReverbTime(report.value);
+			break;
+		case ReportType_NEW_REVERB_LEVEL:
+			clientReportHandler->onNewReverbLevel(report.value);
+			break;
+		case ReportType_POLY_STATE_CHANGED:
+			clientReportHandler->onPolyStateChanged(report.value);
+			break;
+		case ReportType_PROGRAM_CHANGED:
+			clientReportHandler->onProgramChanged(report.value, report.soundGroupName, const_cast<const char *>(report.text));
+			break;
+		case ReportType_LCD_STATE_UPDATED:
+			clientReportHandler2->onLCDStateUpdated();
+			break;
+		case ReportType_MIDI_MESSAGE_LED_STATE_UPDATED:
+			clientReportHandler2->onMidiMessageLEDStateUpdated(report.value != 0);
+			break;
+		}
+	}
+};
+
 class Extensions {
 public:
 	RendererType selectedRendererType;
@@ -253,10 +508,40 @@ public:
 	Display *display;
 	bool oldMT32DisplayFeatures;
 
+	bool lowLatencyRendering;
+
+	bool partialCulling;
+	Bit32u partialCullingAmpThreshold;
+	Bit64u culledPartialSampleCount;
+
+	// State of the partial limit governor, see setCPUBudget().
+	Bit32u maxPartialLimit;
+	Bit32u cpuBudget;
+	double averageRenderLoad;
+	Bit32u renderLoadHoldCount;
+
 	ReportHandler2 defaultReportHandler;
 	ReportHandler2 *reportHandler2;
+
+	// Handlers supplied by the client, which receive notifications directly unless deferred reports are enabled.
+	ReportHandler *clientReportHandler;
+	ReportHandler2 *clientReportHandler2;
+	DeferredReportHandler *deferredReportHandler;
+	bool deferredReports;
+
+	MidiEventSource *midiEventSource;
+
+	char *sharedROMDataName;
+	SharedPCMROMData *sharedPCMROMData;
+
+	// Caches of all the timbres in mt32ram.timbres, invalidated by writes to the respective memory region.
+	PatchCache (*timbreCaches)[4];
 };
 
+MidiEventSource *Renderer::getMidiEventSource() const {
+	return synth.extensions.midiEventSource;
+}
+
 Bit32u Synth::getLibraryVersionInt() {
 	return MT32EMU_CURRENT_VERSION_INT;
 }
@@ -292,6 +577,14 @@ Synth::Synth(ReportHandler *useReportHandler) :
 
 	reportHandler = useReportHandler != NULL ? useReportHandler : &extensions.defaultReportHandler;
 	extensions.reportHandler2 = &extensions.defaultReportHandler;
+	extensions.clientReportHandler = reportHandler;
+	extensions.clientReportHandler2 = extensions.reportHandler2;
+	extensions.deferredReportHandler = NULL;
+	extensions.deferredReports = false;
+	extensions.midiEventSource = NULL;
+	extensions.sharedROMDataName = NULL;
+	extensions.sharedPCMROMData = NULL;
+	extensions.timbreCaches = NULL;
 
 	extensions.preallocatedReverbMemory = false;
 	for (int i = REVERB_MODE_ROOM; i <= REVERB_MODE_TAP_DELAY; i++) {
@@ -332,10 +625,20 @@ Synth::Synth(ReportHandler *useReportHandler) :
 	renderedSampleCount = 0;
 	extensions.display = NULL;
 	extensions.oldMT32DisplayFeatures = false;
+	extensions.lowLatencyRendering = false;
+	extensions.partialCulling = false;
+	extensions.partialCullingAmpThreshold = DEFAULT_PARTIAL_CULLING_AMP_THRESHOLD;
+	extensions.culledPartialSampleCount = 0;
+	extensions.maxPartialLimit = partialCount;
+	extensions.cpuBudget = 0;
+	extensions.averageRenderLoad = 0.0;
+	extensions.renderLoadHoldCount = 0;
 }
 
 Synth::~Synth() {
 	close(); // Make sure we're closed and everything is freed
+	delete extensions.deferredReportHandler;
+	delete[] extensions.sharedROMDataName;
 	delete &mt32ram;
 	delete &mt32default;
 	delete &extensions;
@@ -343,14 +646,51 @@ Synth::~Synth() {
 
 void Synth::setReportHandler2(ReportHandler2 *reportHandler2) {
 	if (reportHandler2 != NULL) {
-		reportHandler = reportHandler2;
-		extensions.reportHandler2 = reportHandler2;
+		extensions.clientReportHandler = reportHandler2;
+		extensions.clientReportHandler2 = reportHandler2;
+	} else {
+		extensions.clientReportHandler = &extensions.defaultReportHandler;
+		extensions.clientReportHandler2 = &extensions.defaultReportHandler;
+	}
+	installReportHandlers();
+}
+
+void Synth::installReportHandlers() {
+	if (extensions.deferredReports) {
+		extensions.deferredReportHandler->setClientReportHandlers(extensions.clientReportHandler, extensions.clientReportHandler2);
+		reportHandler = extensions.deferredReportHandler;
+		extensions.reportHandler2 = extensions.deferredReportHandler;
 	} else {
-		reportHandler = &extensions.defaultReportHandler;
-		extensions.reportHandler2 = &extensions.defaultReportHandler;
+		reportHandler = extensions.clientReportHandler;
+		extensions.reportHandler2 = extensions.clientReportHandler2;
 	}
 }
 
+void Synth::setDeferredReportsEnabled(bool enabled) {
+	if (extensions.deferredReports == enabled) return;
+	if (enabled && extensions.deferredReportHandler == NULL) {
+		extensions.deferredReportHandler = new DeferredReportHandler(*this);
+	}
+	extensions.deferredReports = enabled;
+	installReportHandlers();
+	// Deliver whatever is left over, so that no notification is lost when switching back to the immediate mode.
+	if (!enabled) extensions.deferredReportHandler->dispatch();
+}
+
+bool Synth::isDeferredReportsEnabled() const {
+	return extensions.deferredReports;
+}
+
+Bit32u Synth::dispatchDeferredReports() {
+	if (extensions.deferredReportHandler == NULL) return 0;
+	return extensions.deferredReportHandler->dispatch();
+}
+
+Bit32u Synth::getDeferredReportTimestamp() const {
+	if (extensions.deferredReportHandler == NULL) return 0;
+	return extensions.deferredReportHandler->getCurrentTimestamp();
+}
+
 void ReportHandler::showLCDMessage(const char *data) {
 	printf("WRITE-LCD: %s\n", data);
 }
@@ -554,6 +894,40 @@ bool Synth::isNicePartialMixingEnabled() const {
 	return extensions.nicePartialMixing;
 }
 
+void Synth::setPartialCullingEnabled(bool enabled) {
+	extensions.partialCulling = enabled;
+}
+
+bool Synth::isPartialCullingEnabled() const {
+	return extensions.partialCulling;
+}
+
+void Synth::setPartialCullingThreshold(float attenuationDB) {
+	float ampThreshold = attenuationDB * PARTIAL_AMP_UNITS_PER_OCTAVE / DECIBELS_PER_OCTAVE;
+	if (ampThreshold < 0.0f) {
+		ampThreshold = 0.0f;
+	} else if (ampThreshold > float(Partial::MAX_AMP)) {
+		ampThreshold = float(Partial::MAX_AMP);
+	}
+	extensions.partialCullingAmpThreshold = Bit32u(ampThreshold);
+}
+
+float Synth::getPartialCullingThreshold() const {
+	return extensions.partialCullingAmpThreshold * DECIBELS_PER_OCTAVE / PARTIAL_AMP_UNITS_PER_OCTAVE;
+}
+
+Bit64u Synth::getCulledPartialSampleCount() const {
+	return extensions.culledPartialSampleCount;
+}
+
+Bit32u Synth::getPartialCullingAmpThreshold() const {
+	return extensions.partialCullingAmpThreshold;
+}
+
+void Synth::partialSamplesCulled(Bit32u count) {
+	extensions.culledPartialSampleCount += count;
+}
+
 bool Synth::loadControlROM(const ROMImage &controlROMImage) {
 	File *file = controlROMImage.getFile();
 	const ROMInfo *controlROMInfo = controlROMImage.getROMInfo();
@@ -607,6 +981,32 @@ bool Synth::loadPCMROM(const ROMImage &pcmROMImage) {
 		return false;
 	}
 	const Bit8u *fileData = file->getData();
+	if (extensions.sharedROMDataName != NULL) {
+		const File::SHA1Digest &romDigest = file->getSHA1();
+		extensions.sharedPCMROMData = SharedPCMROMData::map(extensions.sharedROMDataName, romDigest, pcmROMSize);
+		if (extensions.sharedPCMROMData != NULL) {
+			pcmROMData = extensions.sharedPCMROMData->getData();
+			return true;
+		}
+		// When another process is creating the object concurrently, we simply fall back to private data.
+		extensions.sharedPCMROMData = SharedPCMROMData::create(extensions.sharedROMDataName, romDigest, pcmROMSize);
+		if (extensions.sharedPCMROMData != NULL) {
+			decodePCMROM(fileData, extensions.sharedPCMROMData->getData());
+			if (extensions.sharedPCMROMData->publish()) {
+				pcmROMData = extensions.sharedPCMROMData->getData();
+				return true;
+			}
+			delete extensions.sharedPCMROMData;
+			extensions.sharedPCMROMData = NULL;
+		}
+		printDebug("Shared PCM ROM data unavailable, decoding privately");
+	}
+	pcmROMData = new Bit16s[pcmROMSize];
+	decodePCMROM(fileData, pcmROMData);
+	return true;
+}
+
+void Synth::decodePCMROM(const Bit8u *fileData, Bit16s *decodedData) const {
 	for (size_t i = 0; i < pcmROMSize; i++) {
 		Bit8u s = *(fileData++);
 		Bit8u c = *(fileData++);
@@ -623,9 +1023,8 @@ bool Synth::loadPCMROM(const ROMImage &pcmROMImage) {
 			}
 			log = log | Bit16s(bit << (15 - u));
 		}
-		pcmROMData[i] = log;
+		decodedData[i] = log;
 	}
-	return true;
 }
 
 bool Synth::initPCMList(Bit16u mapAddress, Bit16u count) {
@@ -713,6 +1112,16 @@ void Synth::initSoundGroups(char newSoundGroupNames[][9]) {
 	}
 }
 
+PatchCache *Synth::getTimbreCache(unsigned int absTimbreNum) const {
+	return extensions.timbreCaches[absTimbreNum];
+}
+
+void Synth::invalidateTimbreCaches() {
+	for (size_t i = 0; i < sizeof(mt32ram.timbres) / sizeof(*mt32ram.timbres); i++) {
+		extensions.timbreCaches[i][0].dirty = true;
+	}
+}
+
 bool Synth::open(const ROMImage &controlROMImage, const ROMImage &pcmROMImage, AnalogOutputMode analogOutputMode) {
 	return open(controlROMImage, pcmROMImage, DEFAULT_MAX_PARTIALS, analogOutputMode);
 }
@@ -724,6 +1133,7 @@ bool Synth::open(const ROMImage &controlROMImage, const ROMImage &pcmROMImage, B
 	partialCount = usePartialCount;
 	abortingPoly = NULL;
 	extensions.abortingPartIx = 0;
+	extensions.culledPartialSampleCount = 0;
 
 	// This is to help detect bugs
 	memset(&mt32ram, '?', sizeof(mt32ram));
@@ -744,7 +1154,6 @@ bool Synth::open(const ROMImage &controlROMImage, const ROMImage &pcmROMImage, B
 	// 1MB PCM ROM for CM-32L, LAPC-I, CM-64, CM-500
 	// Note that the size below is given in samples (16-bit), not bytes
 	pcmROMSize = controlROMMap->pcmCount == 256 ? 512 * 1024 : 256 * 1024;
-	pcmROMData = new Bit16s[pcmROMSize];
 
 #if MT32EMU_MONITOR_INIT
 	printDebug("Loading PCM ROM");
@@ -805,7 +1214,13 @@ bool Synth::open(const ROMImage &controlROMImage, const ROMImage &pcmROMImage, B
 	// CM-64 seems to initialise all bytes in this bank to 0.
 	memset(&mt32ram.timbres[128], 0, sizeof(mt32ram.timbres[128]) * 64);
 
+	extensions.timbreCaches = new PatchCache[sizeof(mt32ram.timbres) / sizeof(*mt32ram.timbres)][4];
+	invalidateTimbreCaches();
+
 	partialManager = new PartialManager(this, parts);
+	extensions.maxPartialLimit = partialCount;
+	extensions.averageRenderLoad = 0.0;
+	extensions.renderLoadHoldCount = 0;
 
 	pcmWaves = new PCMWaveEntry[controlROMMap->pcmCount];
 
@@ -961,7 +1376,15 @@ void Synth::dispose() {
 	delete[] pcmWaves;
 	pcmWaves = NULL;
 
-	delete[] pcmROMData;
+	delete[] extensions.timbreCaches;
+	extensions.timbreCaches = NULL;
+
+	if (extensions.sharedPCMROMData != NULL) {
+		delete extensions.sharedPCMROMData;
+		extensions.sharedPCMROMData = NULL;
+	} else {
+		delete[] pcmROMData;
+	}
 	pcmROMData = NULL;
 
 	deleteMemoryRegions();
@@ -992,6 +1415,8 @@ void Synth::flushMIDIQueue() {
 		if (midiEvent == NULL) break;
 		if (midiEvent->sysexData == NULL) {
 			playMsgNow(midiEvent->shortMessageData);
+		} else if (midiEvent->sysexBulk != NULL) {
+			while (!playNextSysexBulkMessage()) {}
 		} else {
 			playSysexNow(midiEvent->sysexData, midiEvent->sysexLength);
 		}
@@ -1033,6 +1458,10 @@ void Synth::configureMIDIEventQueueSysexStorage(Bit32u storageBufferSize) {
 	}
 }
 
+Bit32u Synth::getMIDIEventQueueAllocationCount() const {
+	return midiQueue == NULL ? 0 : midiQueue->getAllocationCount();
+}
+
 Bit32u Synth::getShortMessageLength(Bit32u msg) {
 	if ((msg & 0xF0) == 0xF0) {
 		switch (msg & 0xFF) {
@@ -1050,17 +1479,35 @@ Bit32u Synth::getShortMessageLength(Bit32u msg) {
 	return ((msg & 0xE0) == 0xC0) ? 2 : 3;
 }
 
-Bit32u Synth::addMIDIInterfaceDelay(Bit32u len, Bit32u timestamp) {
+Bit32u Synth::getMIDIInterfaceDelayedTimestamp(Bit32u len, Bit32u timestamp) const {
 	Bit32u transferTime =  Bit32u(double(len) * MIDI_DATA_TRANSFER_RATE);
 	// Dealing with wrapping
 	if (Bit32s(timestamp - lastReceivedMIDIEventTimestamp) < 0) {
 		timestamp = lastReceivedMIDIEventTimestamp;
 	}
-	timestamp += transferTime;
+	return timestamp + transferTime;
+}
+
+Bit32u Synth::addMIDIInterfaceDelay(Bit32u len, Bit32u timestamp) {
+	timestamp = getMIDIInterfaceDelayedTimestamp(len, timestamp);
 	lastReceivedMIDIEventTimestamp = timestamp;
 	return timestamp;
 }
 
+// Adjusts the timestamp of an event retrieved from the MIDI event source according to the MIDI delay mode. Unlike queued events,
+// the delay is only committed once the event is played, as the event may be peeked several times before that.
+// Returns whether the delay applies to the event.
+bool Synth::getMIDIEventSourceDelayedTimestamp(Bit32u &timestamp, Bit32u shortMessage, const Bit8u *sysexData, Bit32u sysexLength) const {
+	if (sysexData == NULL) {
+		if (midiDelayMode == MIDIDelayMode_IMMEDIATE) return false;
+		timestamp = getMIDIInterfaceDelayedTimestamp(getShortMessageLength(shortMessage), timestamp);
+	} else {
+		if (midiDelayMode != MIDIDelayMode_DELAY_ALL) return false;
+		timestamp = getMIDIInterfaceDelayedTimestamp(sysexLength, timestamp);
+	}
+	return true;
+}
+
 Bit32u Synth::getInternalRenderedSampleCount() const {
 	return renderedSampleCount;
 }
@@ -1101,6 +1548,94 @@ bool Synth::playSysex(const Bit8u *sysex, Bit32u len, Bit32u timestamp) {
 	return false;
 }
 
+// Returns the length of the SysEx message including framing found at the beginning of a bulk, or 0 if it lacks either marker.
+static Bit32u getSysexBulkMessageLength(const Bit8u *sysexBulk, Bit32u len) {
+	if (len < 2 || sysexBulk[0] != 0xF0) return 0;
+	const Bit8u *endMarker = static_cast<const Bit8u *>(memchr(sysexBulk + 1, 0xF7, len - 1));
+	return endMarker == NULL ? 0 : Bit32u(endMarker - sysexBulk) + 1;
+}
+
+bool Synth::playSysexBulk(const Bit8u *sysexBulk, Bit32u len, Bit32u timestamp, SysexBulkReleaseCallback releaseCallback, void *instanceData) {
+	if (midiQueue == NULL || sysexBulk == NULL || len == 0 || releaseCallback == NULL) return false;
+	// The whole bulk is validated in a single pass beforehand, so that the messages can be applied in the rendering thread
+	// with no further checks. The message layout is: F0, manufacturer, device, model, command, body, checksum, F7.
+	Bit32u firstMessageLength = 0;
+	Bit32u remainingTransferTime = 0;
+	for (Bit32u position = 0; position < len;) {
+		const Bit8u *message = sysexBulk + position;
+		Bit32u messageLength = getSysexBulkMessageLength(message, len - position);
+		if (messageLength == 0) {
+			printDebug("playSysexBulk: Message at offset %d lacks framing", position);
+			return false;
+		}
+		if (messageLength < 8 || message[1] != SYSEX_MANUFACTURER_ROLAND || message[3] != SYSEX_MDL_MT32 || message[2] > 0x10) {
+			printDebug("playSysexBulk: Message at offset %d is not intended for this device", position);
+			return false;
+		}
+		Bit8u checksum = calcSysexChecksum(message + 5, messageLength - 7);
+		if (checksum != message[messageLength - 2]) {
+			printDebug("playSysexBulk: Message at offset %d has incorrect checksum (provided: %02x, expected: %02x)", position, message[messageLength - 2], checksum);
+			return false;
+		}
+		if (position == 0) {
+			firstMessageLength = messageLength;
+		} else {
+			// Same as in playNextSysexBulkMessage()
+			remainingTransferTime += Bit32u(double(messageLength) * MIDI_DATA_TRANSFER_RATE);
+		}
+		position += messageLength;
+	}
+	if (midiDelayMode == MIDIDelayMode_DELAY_ALL) {
+		timestamp = addMIDIInterfaceDelay(firstMessageLength, timestamp);
+		// Subsequent MIDI events are only received once the entire bulk is transferred.
+		lastReceivedMIDIEventTimestamp += remainingTransferTime;
+	}
+	if (!activated) activated = true;
+	do {
+		if (midiQueue->pushSysexBulk(sysexBulk, len, timestamp, releaseCallback, instanceData)) return true;
+	} while (reportHandler->onMIDIQueueOverflow());
+	return false;
+}
+
+void Synth::setSharedROMDataName(const char *namePrefix) {
+	delete[] extensions.sharedROMDataName;
+	extensions.sharedROMDataName = NULL;
+	if (namePrefix == NULL) return;
+	size_t length = strlen(namePrefix);
+	extensions.sharedROMDataName = new char[length + 1];
+	memcpy(extensions.sharedROMDataName, namePrefix, length + 1);
+}
+
+bool Synth::isUsingSharedROMData() const {
+	return extensions.sharedPCMROMData != NULL;
+}
+
+void Synth::setMidiEventSource(MidiEventSource *midiEventSource) {
+	extensions.midiEventSource = midiEventSource;
+}
+
+MidiEventSource *Synth::getMidiEventSource() const {
+	return extensions.midiEventSource;
+}
+
+bool Synth::playNextSysexBulkMessage() {
+	const volatile MidiEventQueue::MidiEvent *midiEvent = midiQueue->peekMidiEvent();
+	const Bit8u *message = midiEvent->sysexData;
+	Bit32u remainingLength = midiEvent->sysexLength;
+	Bit32u messageLength = getSysexBulkMessageLength(message, remainingLength);
+	// The bulk has been validated when enqueued, so the header and checksum are known to be fine.
+	playSysexCommand(message[2], message[4], message + 5, messageLength - 7);
+	remainingLength -= messageLength;
+	if (remainingLength == 0) return true;
+	message += messageLength;
+	Bit32u timestamp = midiEvent->timestamp;
+	if (midiDelayMode == MIDIDelayMode_DELAY_ALL) {
+		timestamp += Bit32u(double(getSysexBulkMessageLength(message, remainingLength)) * MIDI_DATA_TRANSFER_RATE);
+	}
+	midiQueue->advanceSysexBulk(message, remainingLength, timestamp);
+	return false;
+}
+
 void Synth::playMsgNow(Bit32u msg) {
 	if (!opened) return;
 
@@ -1303,7 +1838,10 @@ void Synth::playSysexWithoutHeader(Bit8u device, Bit8u command, const Bit8u *sys
 		return;
 	}
 	len -= 1; // Exclude checksum
+	playSysexCommand(device, command, sysex, len);
+}
 
+void Synth::playSysexCommand(Bit8u device, Bit8u command, const Bit8u *sysex, Bit32u len) {
 	if (command == SYSEX_CMD_EOD) {
 #if MT32EMU_MONITOR_SYSEX > 0
 		printDebug("playSysexWithoutHeader: Ignored unsupported command %02x", command);
@@ -1627,7 +2165,7 @@ void Synth::writeMemoryRegion(const MemoryRegion *region, Bit32u addr, Bit32u le
 			printDebug("WRITE-PARTTIMBRE (%d-%d@%d..%d): timbre=%d (%s)", first, last, off, off + len, i, instrumentName);
 #endif
 			if (parts[i] != NULL) {
-				parts[i]->refresh();
+				parts[i]->refreshTimbreTemp();
 			}
 		}
 		break;
@@ -1732,6 +2270,7 @@ void Synth::writeMemoryRegion(const MemoryRegion *region, Bit32u addr, Bit32u le
 #undef DT
 #endif
 #endif
+			extensions.timbreCaches[i][0].dirty = true;
 			// FIXME:KG: Not sure if the stuff below should be done (for rhythm and/or parts)...
 			// Does the real MT-32 automatically do this?
 			for (unsigned int part = 0; part < 9; part++) {
@@ -1910,6 +2449,7 @@ void Synth::reset() {
 	reportHandler->onDeviceReset();
 	partialManager->deactivateAll();
 	mt32ram = mt32default;
+	invalidateTimbreCaches();
 	for (int i = 0; i < 9; i++) {
 		parts[i]->reset();
 		if (i != 8) {
@@ -1973,19 +2513,93 @@ public:
 	virtual Bit8u *allocate(Bit32u sysexLength) = 0;
 	virtual void reclaimUnused(const Bit8u *sysexData, Bit32u sysexLength) = 0;
 	virtual void dispose(const Bit8u *sysexData, Bit32u sysexLength) = 0;
+	// Returns the number of heap allocations performed since the storage was created.
+	virtual Bit32u getAllocationCount() const = 0;
 };
 
-/** Storage space for SysEx data is allocated dynamically on demand and is disposed lazily. */
+/**
+ * Storage space for SysEx data is allocated dynamically on demand and is disposed lazily. To avoid hitting the heap
+ * for each SysEx message, blocks of power-of-two sizes are recycled via free lists, which are pre-populated with
+ * a few blocks of common sizes. So, once the pools grow enough to fit the SysEx traffic, no more allocations happen.
+ */
 class DynamicSysexDataStorage : public MidiEventQueue::SysexDataStorage {
 public:
+	DynamicSysexDataStorage() : allocationCount() {
+		for (Bit32u sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; sizeClass++) {
+			freeBlocks[sizeClass] = NULL;
+			if (sizeClass >= PREALLOCATED_SIZE_CLASS_COUNT) continue;
+			for (Bit32u i = 0; i < PREALLOCATED_BLOCK_COUNT; i++) {
+				releaseBlock(new Bit8u[MIN_BLOCK_SIZE << sizeClass], sizeClass);
+			}
+		}
+	}
+
+	~DynamicSysexDataStorage() {
+		for (Bit32u sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; sizeClass++) {
+			while (freeBlocks[sizeClass] != NULL) {
+				Bit8u *block = freeBlocks[sizeClass];
+				freeBlocks[sizeClass] = getNextFreeBlock(block);
+				delete[] block;
+			}
+		}
+	}
+
 	Bit8u *allocate(Bit32u sysexLength) {
-		return new Bit8u[sysexLength];
+		Bit32u sizeClass = getSizeClass(sysexLength);
+		if (sizeClass < SIZE_CLASS_COUNT) {
+			Bit8u *block = freeBlocks[sizeClass];
+			if (block != NULL) {
+				freeBlocks[sizeClass] = getNextFreeBlock(block);
+				return block;
+			}
+		}
+		allocationCount++;
+		return new Bit8u[sizeClass < SIZE_CLASS_COUNT ? MIN_BLOCK_SIZE << sizeClass : sysexLength];
 	}
 
 	void reclaimUnused(const Bit8u *, Bit32u) {}
 
-	void dispose(const Bit8u *sysexData, Bit32u) {
-		delete[] sysexData;
+	void dispose(const Bit8u *sysexData, Bit32u sysexLength) {
+		if (sysexData == NULL) return;
+		Bit32u sizeClass = getSizeClass(sysexLength);
+		if (sizeClass < SIZE_CLASS_COUNT) {
+			releaseBlock(const_cast<Bit8u *>(sysexData), sizeClass);
+		} else {
+			delete[] sysexData;
+		}
+	}
+
+	Bit32u getAllocationCount() const {
+		return allocationCount;
+	}
+
+private:
+	// Blocks range from 16 bytes to MAX_STREAM_BUFFER_SIZE, SysEx messages of larger sizes are rare and not pooled.
+	static const Bit32u MIN_BLOCK_SIZE = 16;
+	static const Bit32u SIZE_CLASS_COUNT = 12;
+	// Blocks up to 1024 bytes are preallocated, that is enough to fit SysEx messages in common use.
+	static const Bit32u PREALLOCATED_SIZE_CLASS_COUNT = 7;
+	static const Bit32u PREALLOCATED_BLOCK_COUNT = 4;
+
+	// Free blocks form singly linked lists, with the link stored at the block beginning.
+	Bit8u *freeBlocks[SIZE_CLASS_COUNT];
+	Bit32u allocationCount;
+
+	static Bit32u getSizeClass(Bit32u sysexLength) {
+		Bit32u sizeClass = 0;
+		while (sizeClass < SIZE_CLASS_COUNT && (MIN_BLOCK_SIZE << sizeClass) < sysexLength) sizeClass++;
+		return sizeClass;
+	}
+
+	static Bit8u *getNextFreeBlock(Bit8u *block) {
+		Bit8u *nextBlock;
+		memcpy(&nextBlock, block, sizeof nextBlock);
+		return nextBlock;
+	}
+
+	void releaseBlock(Bit8u *block, Bit32u sizeClass) {
+		memcpy(block, &freeBlocks[sizeClass], sizeof freeBlocks[sizeClass]);
+		freeBlocks[sizeClass] = block;
 	}
 };
 
@@ -2046,6 +2660,10 @@ public:
 
 	void dispose(const Bit8u *, Bit32u) {}
 
+	Bit32u getAllocationCount() const {
+		return 0;
+	}
+
 private:
 	Bit8u * const storageBuffer;
 	const Bit32u storageBufferSize;
@@ -2068,14 +2686,14 @@ MidiEventQueue::MidiEventQueue(Bit32u useRingBufferSize, Bit32u storageBufferSiz
 {
 	for (Bit32u i = 0; i <= ringBufferMask; i++) {
 		ringBuffer[i].sysexData = NULL;
+		ringBuffer[i].sysexBulk = NULL;
 	}
 	reset();
 }
 
 MidiEventQueue::~MidiEventQueue() {
 	for (Bit32u i = 0; i <= ringBufferMask; i++) {
-		volatile MidiEvent &currentEvent = ringBuffer[i];
-		sysexDataStorage.dispose(currentEvent.sysexData, currentEvent.sysexLength);
+		disposeSysexData(ringBuffer[i]);
 	}
 	delete &sysexDataStorage;
 	delete[] ringBuffer;
@@ -2091,7 +2709,7 @@ bool MidiEventQueue::pushShortMessage(Bit32u shortMessageData, Bit32u timestamp)
 	// If ring buffer is full, bail out.
 	if (startPosition == newEndPosition) return false;
 	volatile MidiEvent &newEvent = ringBuffer[endPosition];
-	sysexDataStorage.dispose(newEvent.sysexData, newEvent.sysexLength);
+	disposeSysexData(newEvent);
 	newEvent.sysexData = NULL;
 	newEvent.shortMessageData = shortMessageData;
 	newEvent.timestamp = timestamp;
@@ -2104,7 +2722,7 @@ bool MidiEventQueue::pushSysex(const Bit8u *sysexData, Bit32u sysexLength, Bit32
 	// If ring buffer is full, bail out.
 	if (startPosition == newEndPosition) return false;
 	volatile MidiEvent &newEvent = ringBuffer[endPosition];
-	sysexDataStorage.dispose(newEvent.sysexData, newEvent.sysexLength);
+	disposeSysexData(newEvent);
 	Bit8u *dstSysexData = sysexDataStorage.allocate(sysexLength);
 	if (dstSysexData == NULL) return false;
 	memcpy(dstSysexData, sysexData, sysexLength);
@@ -2115,6 +2733,30 @@ bool MidiEventQueue::pushSysex(const Bit8u *sysexData, Bit32u sysexLength, Bit32
 	return true;
 }
 
+bool MidiEventQueue::pushSysexBulk(const Bit8u *sysexBulk, Bit32u sysexBulkLength, Bit32u timestamp, SysexBulkReleaseCallback releaseCallback, void *instanceData) {
+	Bit32u newEndPosition = (endPosition + 1) & ringBufferMask;
+	// If ring buffer is full, bail out.
+	if (startPosition == newEndPosition) return false;
+	volatile MidiEvent &newEvent = ringBuffer[endPosition];
+	disposeSysexData(newEvent);
+	newEvent.sysexData = sysexBulk;
+	newEvent.sysexLength = sysexBulkLength;
+	newEvent.timestamp = timestamp;
+	newEvent.sysexBulk = sysexBulk;
+	newEvent.sysexBulkReleaseCallback = releaseCallback;
+	newEvent.sysexBulkInstanceData = instanceData;
+	endPosition = newEndPosition;
+	return true;
+}
+
+void MidiEventQueue::advanceSysexBulk(const Bit8u *remainingSysexData, Bit32u remainingLength, Bit32u timestamp) {
+	if (isEmpty()) return;
+	volatile MidiEvent &currentEvent = ringBuffer[startPosition];
+	currentEvent.sysexData = remainingSysexData;
+	currentEvent.sysexLength = remainingLength;
+	currentEvent.timestamp = timestamp;
+}
+
 const volatile MidiEventQueue::MidiEvent *MidiEventQueue::peekMidiEvent() {
 	return isEmpty() ? NULL : &ringBuffer[startPosition];
 }
@@ -2122,10 +2764,36 @@ const volatile MidiEventQueue::MidiEvent *MidiEventQueue::peekMidiEvent() {
 void MidiEventQueue::dropMidiEvent() {
 	if (isEmpty()) return;
 	volatile MidiEvent &unusedEvent = ringBuffer[startPosition];
-	sysexDataStorage.reclaimUnused(unusedEvent.sysexData, unusedEvent.sysexLength);
+	if (unusedEvent.sysexBulk == NULL) {
+		sysexDataStorage.reclaimUnused(unusedEvent.sysexData, unusedEvent.sysexLength);
+	} else {
+		// A SysEx bulk is owned by the client, so it is handed back right away. The slot must be cleared before it becomes
+		// available to the producer.
+		releaseSysexBulk(unusedEvent);
+	}
 	startPosition = (startPosition + 1) & ringBufferMask;
 }
 
+void MidiEventQueue::disposeSysexData(volatile MidiEvent &midiEvent) {
+	if (midiEvent.sysexBulk == NULL) {
+		sysexDataStorage.dispose(midiEvent.sysexData, midiEvent.sysexLength);
+		return;
+	}
+	// Only happens when the bulk is discarded unplayed, e.g. the queue is destroyed or has been reset.
+	releaseSysexBulk(midiEvent);
+}
+
+void MidiEventQueue::releaseSysexBulk(volatile MidiEvent &midiEvent) {
+	SysexBulkReleaseCallback releaseCallback = midiEvent.sysexBulkReleaseCallback;
+	releaseCallback(midiEvent.sysexBulkInstanceData, midiEvent.sysexBulk);
+	midiEvent.sysexData = NULL;
+	midiEvent.sysexBulk = NULL;
+}
+
+Bit32u MidiEventQueue::getAllocationCount() const {
+	return sysexDataStorage.getAllocationCount();
+}
+
 bool MidiEventQueue::isEmpty() const {
 	return startPosition == endPosition;
 }
@@ -2268,17 +2936,44 @@ template <class Sample>
 void RendererImpl<Sample>::doRenderStreams(const DACOutputStreams<Sample> &streams, Bit32u len)
 {
 	DACOutputStreams<Sample> tmpStreams = streams;
+	getPartialManager().enforcePartialLimit();
 	while (len > 0) {
 		// We need to ensure zero-duration notes will play so add minimum 1-sample delay.
 		Bit32u thisLen = 1;
 		if (!isAbortingPoly()) {
 			const volatile MidiEventQueue::MidiEvent *nextEvent = getMidiQueue().peekMidiEvent();
 			Bit32s samplesToNextEvent = (nextEvent != NULL) ? Bit32s(nextEvent->timestamp - getRenderedSampleCount()) : MAX_SAMPLES_PER_RUN;
-			if (samplesToNextEvent > 0) {
+			MidiEventSource *midiEventSource = getMidiEventSource();
+			Bit32s samplesToNextSourceEvent = MAX_SAMPLES_PER_RUN;
+			Bit32u sourceEventTimestamp, sourceShortMessage, sourceSysexLength;
+			const Bit8u *sourceSysexData = NULL;
+			bool sourceEventDelayed = false;
+			if (midiEventSource != NULL && midiEventSource->peekMidiEvent(sourceEventTimestamp, sourceShortMessage, sourceSysexData, sourceSysexLength)) {
+				sourceEventDelayed = getMIDIEventSourceDelayedTimestamp(sourceEventTimestamp, sourceShortMessage, sourceSysexData, sourceSysexLength);
+				samplesToNextSourceEvent = Bit32s(sourceEventTimestamp - getRenderedSampleCount());
+			}
+			if (samplesToNextSourceEvent <= 0 && samplesToNextSourceEvent <= samplesToNextEvent) {
+				// On a tie, the event from the source wins, there is no way to tell which one was meant to come first anyway.
+				bool played = true;
+				if (sourceSysexData == NULL) {
+					synth.playMsgNow(sourceShortMessage);
+					// As with the queue, the event is retried once the poly abortion is done.
+					played = !isAbortingPoly();
+				} else {
+					synth.playSysexNow(sourceSysexData, sourceSysexLength);
+				}
+				if (played) {
+					if (sourceEventDelayed) setLastReceivedMIDIEventTimestamp(sourceEventTimestamp);
+					midiEventSource->dropMidiEvent();
+				}
+			} else if (samplesToNextEvent > 0) {
 				thisLen = len > MAX_SAMPLES_PER_RUN ? MAX_SAMPLES_PER_RUN : len;
 				if (thisLen > Bit32u(samplesToNextEvent)) {
 					thisLen = samplesToNextEvent;
 				}
+				if (thisLen > Bit32u(samplesToNextSourceEvent)) {
+					thisLen = samplesToNextSourceEvent;
+				}
 			} else {
 				if (nextEvent->sysexData == NULL) {
 					synth.playMsgNow(nextEvent->shortMessageData);
@@ -2287,6 +2982,11 @@ void RendererImpl<Sample>::doRenderStreams(const DACOutputStreams<Sample> &strea
 					if (!isAbortingPoly()) {
 						getMidiQueue().dropMidiEvent();
 					}
+				} else if (nextEvent->sysexBulk != NULL) {
+					// Messages of a bulk are played one at a time, at their own timestamps.
+					if (playNextSysexBulkMessage()) {
+						getMidiQueue().dropMidiEvent();
+					}
 				} else {
 					synth.playSysexNow(nextEvent->sysexData, nextEvent->sysexLength);
 					getMidiQueue().dropMidiEvent();
@@ -2297,6 +2997,7 @@ void RendererImpl<Sample>::doRenderStreams(const DACOutputStreams<Sample> &strea
 		advanceStreams(tmpStreams, thisLen);
 		len -= thisLen;
 	}
+	if (synth.isLowLatencyRenderingEnabled()) updateDisplayState();
 }
 
 template <class Sample>
@@ -2388,6 +3089,14 @@ void Synth::renderStreams(
 	renderStreams(streams, len);
 }
 
+void Synth::setLowLatencyRenderingEnabled(bool enabled) {
+	extensions.lowLatencyRendering = enabled;
+}
+
+bool Synth::isLowLatencyRenderingEnabled() const {
+	return extensions.lowLatencyRendering;
+}
+
 // In GENERATION2 units, the output from LA32 goes to the Boss chip already bit-shifted.
 // In NICE mode, it's also better to increase volume before the reverb processing to preserve accuracy.
 template <>
@@ -2477,13 +3186,7 @@ void RendererImpl<Sample>::produceStreams(const DACOutputStreams<Sample> &stream
 		Synth::muteSampleBuffer(reverbDryLeft, len);
 		Synth::muteSampleBuffer(reverbDryRight, len);
 
-		for (unsigned int i = 0; i < synth.getPartialCount(); i++) {
-			if (getPartialManager().shouldReverb(i)) {
-				getPartialManager().produceOutput(i, reverbDryLeft, reverbDryRight, len);
-			} else {
-				getPartialManager().produceOutput(i, nonReverbLeft, nonReverbRight, len);
-			}
-		}
+		getPartialManager().produceOutput(nonReverbLeft, nonReverbRight, reverbDryLeft, reverbDryRight, len);
 
 		produceLA32Output(reverbDryLeft, len);
 		produceLA32Output(reverbDryRight, len);
@@ -2516,16 +3219,16 @@ void RendererImpl<Sample>::produceStreams(const DACOutputStreams<Sample> &stream
 
 	getPartialManager().clearAlreadyOutputed();
 	incRenderedSampleCount(len);
-	updateDisplayState();
+	if (!synth.isLowLatencyRenderingEnabled()) updateDisplayState();
 }
 
 void Synth::printPartialUsage(Bit32u sampleOffset) {
 	unsigned int partialUsage[9];
 	partialManager->getPerPartPartialUsage(partialUsage);
 	if (sampleOffset > 0) {
-		printDebug("[+%u] Partial Usage: 1:%02d 2:%02d 3:%02d 4:%02d 5:%02d 6:%02d 7:%02d 8:%02d R: %02d  TOTAL: %02d", sampleOffset, partialUsage[0], partialUsage[1], partialUsage[2], partialUsage[3], partialUsage[4], partialUsage[5], partialUsage[6], partialUsage[7], partialUsage[8], getPartialCount() - partialManager->getFreePartialCount());
+		printDebug("[+%u] Partial Usage: 1:%02d 2:%02d 3:%02d 4:%02d 5:%02d 6:%02d 7:%02d 8:%02d R: %02d  TOTAL: %02d", sampleOffset, partialUsage[0], partialUsage[1], partialUsage[2], partialUsage[3], partialUsage[4], partialUsage[5], partialUsage[6], partialUsage[7], partialUsage[8], partialManager->getActivePartialCount());
 	} else {
-		printDebug("Partial Usage: 1:%02d 2:%02d 3:%02d 4:%02d 5:%02d 6:%02d 7:%02d 8:%02d R: %02d  TOTAL: %02d", partialUsage[0], partialUsage[1], partialUsage[2], partialUsage[3], partialUsage[4], partialUsage[5], partialUsage[6], partialUsage[7], partialUsage[8], getPartialCount() - partialManager->getFreePartialCount());
+		printDebug("Partial Usage: 1:%02d 2:%02d 3:%02d 4:%02d 5:%02d 6:%02d 7:%02d 8:%02d R: %02d  TOTAL: %02d", partialUsage[0], partialUsage[1], partialUsage[2], partialUsage[3], partialUsage[4], partialUsage[5], partialUsage[6], partialUsage[7], partialUsage[8], partialManager->getActivePartialCount());
 	}
 }
 
@@ -2548,6 +3251,11 @@ bool Synth::isActive() {
 	if (!midiQueue->isEmpty() || hasActivePartials()) {
 		return true;
 	}
+	if (extensions.midiEventSource != NULL) {
+		Bit32u timestamp, shortMessage, sysexLength;
+		const Bit8u *sysexData;
+		if (extensions.midiEventSource->peekMidiEvent(timestamp, shortMessage, sysexData, sysexLength)) return true;
+	}
 	if (isReverbEnabled() && reverbModel->isActive()) {
 		return true;
 	}
@@ -2559,6 +3267,48 @@ Bit32u Synth::getPartialCount() const {
 	return partialCount;
 }
 
+void Synth::setPartialLimit(Bit32u partialLimit) {
+	if (!opened) return;
+	partialManager->setPartialLimit(partialLimit);
+	extensions.maxPartialLimit = partialManager->getPartialLimit();
+}
+
+Bit32u Synth::getPartialLimit() const {
+	return opened ? partialManager->getPartialLimit() : partialCount;
+}
+
+void Synth::setCPUBudget(Bit32u cpuBudget) {
+	extensions.cpuBudget = cpuBudget;
+	extensions.averageRenderLoad = 0.0;
+	extensions.renderLoadHoldCount = 0;
+	if (opened && cpuBudget == 0) partialManager->setPartialLimit(extensions.maxPartialLimit);
+}
+
+Bit32u Synth::getCPUBudget() const {
+	return extensions.cpuBudget;
+}
+
+void Synth::reportRenderLoad(double renderTime, double renderedDuration) {
+	if (!opened || extensions.cpuBudget == 0 || renderedDuration <= 0.0) return;
+	// Spikes are taken at once while the decay is smoothed out, so that the limit is lowered promptly and restored gradually.
+	double load = 100.0 * renderTime / renderedDuration;
+	double &averageLoad = extensions.averageRenderLoad;
+	averageLoad = load > averageLoad ? load : averageLoad + 0.1 * (load - averageLoad);
+	if (extensions.renderLoadHoldCount > 0) {
+		extensions.renderLoadHoldCount--;
+		return;
+	}
+	Bit32u partialLimit = partialManager->getPartialLimit();
+	if (averageLoad > extensions.cpuBudget) {
+		if (partialLimit <= MIN_GOVERNED_PARTIAL_LIMIT) return;
+		Bit32u newPartialLimit = partialLimit - (partialLimit >> 3);
+		partialManager->setPartialLimit(newPartialLimit < MIN_GOVERNED_PARTIAL_LIMIT ? MIN_GOVERNED_PARTIAL_LIMIT : newPartialLimit);
+		extensions.renderLoadHoldCount = RENDER_LOAD_HOLD_REPORT_COUNT;
+	} else if (averageLoad < 0.75 * extensions.cpuBudget && partialLimit < extensions.maxPartialLimit) {
+		partialManager->setPartialLimit(partialLimit + 1);
+	}
+}
+
 void Synth::getPartStates(bool *partStates) const {
 	if (!opened) {
 		memset(partStates, 0, 9 * sizeof(bool));
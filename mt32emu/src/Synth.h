@@ -28,6 +28,10 @@
 
 namespace MT32Emu {
 
+// Function that is invoked once the synth no longer refers to a buffer passed to Synth::playSysexBulk(),
+// so that the client may dispose of it. The instanceData is the value provided along with the buffer.
+typedef void (*SysexBulkReleaseCallback)(void *instanceData, const Bit8u *sysexBulk);
+
 class Analog;
 class BReverbModel;
 class Extensions;
@@ -53,6 +57,7 @@ struct ControlROMFeatureSet;
 struct ControlROMMap;
 struct PCMWaveEntry;
 struct MemParams;
+struct PatchCache;
 
 const Bit8u SYSEX_MANUFACTURER_ROLAND = 0x41;
 
@@ -128,6 +133,20 @@ public:
 	virtual void onMidiMessageLEDStateUpdated(bool /* ledState */) {}
 };
 
+// Supplies time-sorted MIDI events to the synth on demand during rendering. See Synth::setMidiEventSource().
+class MT32EMU_EXPORT_V(2.8) MidiEventSource {
+public:
+	virtual ~MidiEventSource() {}
+
+	// Retrieves the next pending event without consuming it. The timestamp is expressed in the same units as the value
+	// returned by Synth::getInternalRenderedSampleCount(). For a short message, sysexData is set to NULL, otherwise it points
+	// to a single well formed System Exclusive message of sysexLength bytes, which must remain valid until the event is dropped.
+	// Returns false if there are no pending events at the moment.
+	virtual bool peekMidiEvent(Bit32u &timestamp, Bit32u &shortMessage, const Bit8u *&sysexData, Bit32u &sysexLength) = 0;
+	// Consumes the event last retrieved with peekMidiEvent().
+	virtual void dropMidiEvent() = 0;
+};
+
 class Synth {
 friend class DefaultMidiStreamParser;
 friend class Display;
@@ -212,8 +231,14 @@ private:
 
 	// **************************** Implementation methods **************************
 
+	Bit32u getMIDIInterfaceDelayedTimestamp(Bit32u len, Bit32u timestamp) const;
 	Bit32u addMIDIInterfaceDelay(Bit32u len, Bit32u timestamp);
+	bool getMIDIEventSourceDelayedTimestamp(Bit32u &timestamp, Bit32u shortMessage, const Bit8u *sysexData, Bit32u sysexLength) const;
+	bool playNextSysexBulkMessage();
+	void playSysexCommand(Bit8u device, Bit8u command, const Bit8u *sysex, Bit32u len);
 	bool isAbortingPoly() const { return abortingPoly != NULL; }
+	Bit32u getPartialCullingAmpThreshold() const;
+	void partialSamplesCulled(Bit32u count);
 
 	void writeSysexGlobal(Bit32u addr, const Bit8u *sysex, Bit32u len);
 	void readSysex(Bit8u channel, const Bit8u *sysex, Bit32u len) const;
@@ -225,6 +250,7 @@ private:
 
 	bool loadControlROM(const ROMImage &controlROMImage);
 	bool loadPCMROM(const ROMImage &pcmROMImage);
+	void decodePCMROM(const Bit8u *fileData, Bit16s *decodedData) const;
 
 	bool initPCMList(Bit16u mapAddress, Bit16u count);
 	bool initTimbres(Bit16u mapAddress, Bit16u offset, Bit16u timbreCount, Bit16u startTimbre, bool compressed);
@@ -232,6 +258,10 @@ private:
 	void initReverbModels(bool mt32CompatibleMode);
 	void initSoundGroups(char newSoundGroupNames[][9]);
 
+	// Returns the four-entry cache of the timbre in mt32ram.timbres, which is shared by all the parts playing it.
+	PatchCache *getTimbreCache(unsigned int absTimbreNum) const;
+	void invalidateTimbreCaches();
+
 	void refreshSystemMasterTune();
 	void refreshSystemReverbParameters();
 	void refreshSystemReserveSettings();
@@ -249,6 +279,7 @@ private:
 	const char *getSoundGroupName(const Part *part) const;
 	const char *getSoundGroupName(Bit8u timbreGroup, Bit8u timbreNumber) const;
 	void printDebug(const char *fmt, ...);
+	void installReportHandlers();
 
 	// partNum should be 0..7 for Part 1..8, or 8 for Rhythm
 	const Part *getPart(Bit8u partNum) const;
@@ -314,6 +345,36 @@ public:
 	// If the argument is NULL, the default implementation is installed as a fallback.
 	MT32EMU_EXPORT_V(2.6) void setReportHandler2(ReportHandler2 *reportHandler2);
 
+	// Enables or disables the deferred reports mode. When enabled, notifications issued by the synth while processing
+	// MIDI messages and rendering are recorded into a lock-free ring buffer rather than delivered to the report handler
+	// right away, so that no client code runs in the rendering thread. The recorded notifications are delivered
+	// by dispatchDeferredReports(). Callbacks that return a result or report errors are still invoked immediately.
+	// When disabled, the pending notifications are delivered from the calling thread. This mode is disabled by default.
+	// Must not be called concurrently with rendering or dispatchDeferredReports().
+	MT32EMU_EXPORT_V(2.8) void setDeferredReportsEnabled(bool enabled);
+	// Returns whether the deferred reports mode is enabled.
+	MT32EMU_EXPORT_V(2.8) bool isDeferredReportsEnabled() const;
+	// Invokes the report handler callbacks for the notifications recorded in the deferred reports mode, in the order
+	// they were issued. Intended to be called periodically from a single non-realtime thread, which may run concurrently
+	// with rendering and other calls to the synth, as long as those are serialised among themselves as usual. Note that
+	// callbacks invoked during dispatch still must not access the synth unless synchronised with the rendering thread.
+	// When the ring buffer gets full, subsequent notifications are dropped until it is drained.
+	// Returns the number of notifications delivered.
+	MT32EMU_EXPORT_V(2.8) Bit32u dispatchDeferredReports();
+	// Returns the rendered sample count at the moment the notification being delivered by dispatchDeferredReports()
+	// was issued. Only meaningful when called from within a report handler callback during dispatch.
+	MT32EMU_EXPORT_V(2.8) Bit32u getDeferredReportTimestamp() const;
+
+	// Enables sharing of the decoded PCM ROM data among processes via a POSIX shared memory object. When the synth is opened,
+	// an object named after the specified prefix and the SHA1 digest of the PCM ROM image is mapped read-only if it exists
+	// and passes the integrity check. Otherwise, this process creates and publishes the object for others to use.
+	// Should any of that fail, the data is decoded privately as usual. The name prefix must not contain slashes.
+	// Setting NULL disables sharing, which is the default. This has no effect when the library is built without
+	// shared memory support. Takes effect on subsequent calls to open().
+	MT32EMU_EXPORT_V(2.8) void setSharedROMDataName(const char *namePrefix);
+	// Returns true if the synth is open and uses the decoded PCM ROM data mapped from a shared memory object.
+	MT32EMU_EXPORT_V(2.8) bool isUsingSharedROMData() const;
+
 	// Used to initialise the MT-32. Must be called before any other function.
 	// Returns true if initialization was successful, otherwise returns false.
 	// controlROMImage and pcmROMImage represent full Control and PCM ROM images for use by synth.
@@ -347,8 +408,15 @@ public:
 	// which makes this kind of storage safe for use in a realtime thread. Additionally, the space retained
 	// by a SysEx event, that has been processed and thus is no longer necessary, is disposed instantly.
 	// Note, the queue is flushed and recreated in the process so that its size remains intact.
+	// With the default storage, the buffers are recycled via pools that are pre-sized to fit SysEx messages in common use,
+	// so that heap allocations only happen while the pools grow to fit the actual SysEx traffic.
 	MT32EMU_EXPORT void configureMIDIEventQueueSysexStorage(Bit32u storageBufferSize);
 
+	// Debugging aid for realtime applications. Returns the number of heap allocations performed by the internal MIDI event queue
+	// since it was created, i.e. since the synth was opened or the queue was reconfigured. Once the pools of the default SysEx
+	// storage warm up, the value is expected to stay constant. It always remains 0 with a preallocated SysEx storage buffer.
+	MT32EMU_EXPORT_V(2.8) Bit32u getMIDIEventQueueAllocationCount() const;
+
 	// Returns current value of the global counter of samples rendered since the synth was created (at the native sample rate 32000 Hz).
 	// This method helps to compute accurate timestamp of a MIDI message to use with the methods below.
 	MT32EMU_EXPORT Bit32u getInternalRenderedSampleCount() const;
@@ -371,6 +439,27 @@ public:
 	// Enqueues a single well formed System Exclusive MIDI message to be processed ASAP.
 	MT32EMU_EXPORT bool playSysex(const Bit8u *sysex, Bit32u len);
 
+	// Enqueues a bulk of well formed System Exclusive MIDI messages that follow one another (e.g. contents of a .syx file
+	// or a concatenated memory dump) to play starting at specified time. The messages are validated once beforehand,
+	// and the bulk is rejected as a whole if any of them is malformed, not intended for this device or has a wrong checksum.
+	// Unlike playSysex(), the data is not copied. Instead, the buffer is handed over to the synth until releaseCallback
+	// is invoked with the provided instanceData. Normally, this happens in the rendering thread right after the last message
+	// of the bulk is played. A bulk discarded unplayed is released in the thread that enqueues subsequent MIDI events
+	// or the one that closes the synth. The bulk occupies a single slot in the MIDI event queue, irrespective of its length.
+	// Returns false if the bulk is invalid or the MIDI event queue is full; the callback is never invoked in this case.
+	MT32EMU_EXPORT_V(2.8) bool playSysexBulk(const Bit8u *sysexBulk, Bit32u len, Bit32u timestamp, SysexBulkReleaseCallback releaseCallback, void *instanceData);
+
+	// Installs a source the renderer pulls MIDI events from as it reaches their timestamps, in addition to the events
+	// in the MIDI event queue. This is mainly intended for offline rendering of pre-recorded sequences: there is no need
+	// to copy the events into the queue, handle overflows or split rendering at the event boundaries. The MIDI interface
+	// delays are emulated according to the MIDI delay mode, the same way as for the events played via playMsg() and the likes.
+	// The source is invoked in the rendering thread, and also by isActive(), so while a source is installed, isActive()
+	// must not be called concurrently with rendering. Setting NULL removes the source; pending events that remain in it
+	// are not played. Must not be called concurrently with rendering.
+	MT32EMU_EXPORT_V(2.8) void setMidiEventSource(MidiEventSource *midiEventSource);
+	// Returns the currently installed MIDI event source or NULL if there is none.
+	MT32EMU_EXPORT_V(2.8) MidiEventSource *getMidiEventSource() const;
+
 	// WARNING:
 	// The methods below don't ensure minimum 1-sample delay between sequential MIDI events,
 	// and a sequence of NoteOn and immediately succeeding NoteOff messages is always silent.
@@ -501,6 +590,23 @@ public:
 	// Returns whether NicePartialMixing mode is enabled.
 	MT32EMU_EXPORT bool isNicePartialMixingEnabled() const;
 
+	// Enables culling of partials that have become inaudible in the release phase. When the attenuation of a releasing partial
+	// reaches the culling threshold, its waveform is no longer generated. Its envelopes and the PCM wave position (if any) are still
+	// advanced, so that the partial ends and becomes available for new notes at exactly the same time as it would otherwise.
+	// Only applies to the integer renderer (RendererType_BIT16S) and to partials which are not involved in ring modulation.
+	// This mode is disabled by default.
+	MT32EMU_EXPORT_V(2.8) void setPartialCullingEnabled(bool enabled);
+	// Returns whether culling of inaudible partials is enabled.
+	MT32EMU_EXPORT_V(2.8) bool isPartialCullingEnabled() const;
+	// Sets the attenuation in dB at which releasing partials are culled. The default value of about 78.3 dB corresponds to
+	// the level where the emulated wave generator output is always zero, so that culling is practically lossless. Lower values
+	// cut the release tails shorter, thus saving more time, yet the tails are cut at the level set.
+	MT32EMU_EXPORT_V(2.8) void setPartialCullingThreshold(float attenuationDB);
+	// Returns the attenuation in dB at which releasing partials are culled.
+	MT32EMU_EXPORT_V(2.8) float getPartialCullingThreshold() const;
+	// Returns the total number of samples that were not generated for the partials culled since the synth was opened.
+	MT32EMU_EXPORT_V(2.8) Bit64u getCulledPartialSampleCount() const;
+
 	// Selects new type of the wave generator and renderer to be used during subsequent calls to open().
 	// By default, RendererType_BIT16S is selected.
 	// See RendererType for details.
@@ -532,17 +638,47 @@ public:
 	MT32EMU_EXPORT void renderStreams(float *nonReverbLeft, float *nonReverbRight, float *reverbDryLeft, float *reverbDryRight, float *reverbWetLeft, float *reverbWetRight, Bit32u len);
 	MT32EMU_EXPORT void renderStreams(const DACOutputStreams<float> &streams, Bit32u len);
 
+	// Enables the low-latency rendering mode, which is intended for rendering in small blocks, e.g. of 16 to 128 frames.
+	// In this mode, the display state is checked and the respective ReportHandler2 callbacks are invoked once per rendering call
+	// rather than after each chunk, which the rendered blocks are split into at the MIDI event timestamps. As the display state
+	// changes are timed in milliseconds, this is only noticeable when rendering large blocks. Disabled by default.
+	MT32EMU_EXPORT_V(2.8) void setLowLatencyRenderingEnabled(bool enabled);
+	// Returns whether the low-latency rendering mode is enabled.
+	MT32EMU_EXPORT_V(2.8) bool isLowLatencyRenderingEnabled() const;
+
 	// Returns true when there is at least one active partial, otherwise false.
 	MT32EMU_EXPORT bool hasActivePartials() const;
 
 	// Returns true if the synth is active and subsequent calls to render() may result in non-trivial output (i.e. silence).
-	// The synth is considered active when either there are pending MIDI events in the queue, there is at least one active partial,
-	// or the reverb is (somewhat unreliably) detected as being active.
+	// The synth is considered active when either there are pending MIDI events in the queue or in the MIDI event source,
+	// there is at least one active partial, or the reverb is (somewhat unreliably) detected as being active.
+	// When a MIDI event source is installed, this method must not be invoked concurrently with rendering.
 	MT32EMU_EXPORT bool isActive();
 
 	// Returns the maximum number of partials playing simultaneously.
 	MT32EMU_EXPORT Bit32u getPartialCount() const;
 
+	// Sets the maximum number of partials permitted to play simultaneously, without re-opening the synth. The limit cannot exceed
+	// the number of partials specified when opening the synth, as returned by getPartialCount(), and it is reset to that value
+	// upon opening. When the limit is lowered below the number of partials currently playing, the excess polys are aborted one
+	// by one during rendering, following the same priorities as when partials are stolen to play new notes.
+	// Has no effect unless the synth is open.
+	MT32EMU_EXPORT_V(2.8) void setPartialLimit(Bit32u partialLimit);
+	// Returns the maximum number of partials currently permitted to play simultaneously.
+	MT32EMU_EXPORT_V(2.8) Bit32u getPartialLimit() const;
+
+	// Sets the share of real time, in percent of the duration of the rendered audio, the rendering is allowed to take.
+	// When the render load reported via reportRenderLoad() exceeds the budget, the partial limit is lowered temporarily,
+	// and it is restored gradually up to the value last set via setPartialLimit() as the load drops. Zero disables
+	// the governor and restores the partial limit at once. The budget is kept across re-opening the synth.
+	MT32EMU_EXPORT_V(2.8) void setCPUBudget(Bit32u cpuBudget);
+	// Returns the CPU budget set via setCPUBudget(), zero when the partial limit governor is disabled.
+	MT32EMU_EXPORT_V(2.8) Bit32u getCPUBudget() const;
+	// Feeds the partial limit governor with the time taken to render a chunk of audio along with the duration of the chunk,
+	// both values are expected in the same units. Has no effect unless the synth is open and a non-zero CPU budget is set.
+	// This method must be called from the rendering thread or otherwise synchronised with rendering.
+	MT32EMU_EXPORT_V(2.8) void reportRenderLoad(double renderTime, double renderedDuration);
+
 	// Fills in current states of all the parts into the array provided. The array must have at least 9 entries to fit values for all the parts.
 	// If the value returned for a part is true, there is at least one active non-releasing partial playing on this part.
 	// This info is useful in emulating behaviour of LCD display of the hardware units.
@@ -335,6 +335,14 @@ Bit16u TVP::nextPitch() {
 	return pitch;
 }
 
+Bit32u TVP::getSteadyPitchSampleCount() const {
+	return Bit32u(counter);
+}
+
+void TVP::skipSteadyPitches(Bit32u count) {
+	counter -= int(count);
+}
+
 void TVP::process() {
 	if (phase == 0) {
 		targetPitchOffsetReached();
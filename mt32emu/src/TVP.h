@@ -66,6 +66,11 @@ public:
 	void reset(const Part *part, const TimbreParam::PartialParam *partialParam);
 	Bit32u getBasePitch() const;
 	Bit16u nextPitch();
+	// Returns the number of samples that follow the last one returned by nextPitch(), for which the pitch remains unchanged,
+	// i.e. till the next firing of the process timer.
+	Bit32u getSteadyPitchSampleCount() const;
+	// Same as invoking nextPitch() count times, provided that count does not exceed getSteadyPitchSampleCount().
+	void skipSteadyPitches(Bit32u count);
 	void startDecay();
 }; // class TVP
 
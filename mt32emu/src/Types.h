@@ -27,6 +27,18 @@ typedef   signed short int Bit16s;
 typedef unsigned char      Bit8u;
 typedef   signed char      Bit8s;
 
+// C++98 lacks a 64-bit integer type, yet it is provided as an extension by all the supported compilers.
+#if defined(_MSC_VER)
+typedef unsigned __int64   Bit64u;
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wlong-long"
+typedef unsigned long long Bit64u;
+#pragma GCC diagnostic pop
+#else
+typedef unsigned long long Bit64u;
+#endif
+
 }
 
 #endif
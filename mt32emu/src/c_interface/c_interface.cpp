@@ -43,7 +43,7 @@ static mt32emu_service_version MT32EMU_C_CALL getSynthVersionID(mt32emu_service_
 	return MT32EMU_SERVICE_VERSION_CURRENT;
 }
 
-static const mt32emu_service_i_v6 SERVICE_VTABLE = {
+static const mt32emu_service_i_v7 SERVICE_VTABLE = {
 	getSynthVersionID,
 	mt32emu_get_supported_report_handler_version,
 	mt32emu_get_supported_midi_receiver_version,
@@ -136,7 +136,23 @@ static const mt32emu_service_i_v6 SERVICE_VTABLE = {
 	mt32emu_set_part_volume_override,
 	mt32emu_get_part_volume_override,
 	mt32emu_get_sound_group_name,
-	mt32emu_get_sound_name
+	mt32emu_get_sound_name,
+	mt32emu_get_supported_midi_event_source_version,
+	mt32emu_set_midi_event_source,
+	mt32emu_play_sysex_bulk,
+	mt32emu_set_partial_limit,
+	mt32emu_get_partial_limit,
+	mt32emu_set_cpu_budget,
+	mt32emu_get_cpu_budget,
+	mt32emu_report_render_load,
+	mt32emu_get_midi_allocation_count,
+	mt32emu_set_partial_culling_enabled,
+	mt32emu_is_partial_culling_enabled,
+	mt32emu_set_partial_culling_threshold,
+	mt32emu_get_partial_culling_threshold,
+	mt32emu_get_culled_partial_sample_count,
+	mt32emu_set_low_latency_rendering_enabled,
+	mt32emu_is_low_latency_rendering_enabled
 };
 
 } // namespace MT32Emu
@@ -147,6 +163,7 @@ struct mt32emu_data {
 	const ROMImage *controlROMImage;
 	const ROMImage *pcmROMImage;
 	DefaultMidiStreamParser *midiParser;
+	MidiEventSource *midiEventSource;
 	Bit32u partialCount;
 	AnalogOutputMode analogOutputMode;
 	SamplerateConversionState *srcState;
@@ -332,6 +349,36 @@ private:
 	}
 };
 
+class DelegatingMidiEventSource : public MidiEventSource {
+public:
+	DelegatingMidiEventSource(mt32emu_midi_event_source_i useMIDIEventSource, void *useInstanceData) :
+		delegate(useMIDIEventSource), instanceData(useInstanceData) {}
+
+	bool peekMidiEvent(Bit32u &timestamp, Bit32u &shortMessage, const Bit8u *&sysexData, Bit32u &sysexLength) {
+		return delegate.v0->peekMidiEvent(instanceData, &timestamp, &shortMessage, &sysexData, &sysexLength) != MT32EMU_BOOL_FALSE;
+	}
+
+	void dropMidiEvent() {
+		delegate.v0->dropMidiEvent(instanceData);
+	}
+
+private:
+	mt32emu_midi_event_source_i delegate;
+	void *instanceData;
+};
+
+// Conveys the client callback for a SysEx bulk, since it is invoked with a different calling convention.
+struct SysexBulkReleaseDelegate {
+	mt32emu_sysex_bulk_release_callback releaseCallback;
+	void *instanceData;
+};
+
+static void releaseSysexBulk(void *instanceData, const Bit8u *sysexBulk) {
+	SysexBulkReleaseDelegate *delegate = static_cast<SysexBulkReleaseDelegate *>(instanceData);
+	delegate->releaseCallback(delegate->instanceData, sysexBulk);
+	delete delegate;
+}
+
 static void fillROMInfo(mt32emu_rom_info *rom_info, const ROMInfo *controlROMInfo, const ROMInfo *pcmROMInfo) {
 	if (controlROMInfo != NULL) {
 		rom_info->control_rom_id = controlROMInfo->shortName;
@@ -466,7 +513,7 @@ extern "C" {
 
 mt32emu_service_i MT32EMU_C_CALL mt32emu_get_service_i() {
 	mt32emu_service_i i;
-	i.v6 = &SERVICE_VTABLE;
+	i.v7 = &SERVICE_VTABLE;
 	return i;
 }
 
@@ -478,6 +525,10 @@ mt32emu_midi_receiver_version MT32EMU_C_CALL mt32emu_get_supported_midi_receiver
 	return MT32EMU_MIDI_RECEIVER_VERSION_CURRENT;
 }
 
+mt32emu_midi_event_source_version MT32EMU_C_CALL mt32emu_get_supported_midi_event_source_version() {
+	return MT32EMU_MIDI_EVENT_SOURCE_VERSION_CURRENT;
+}
+
 mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_library_version_int() {
 	return Synth::getLibraryVersionInt();
 }
@@ -551,6 +602,7 @@ mt32emu_context MT32EMU_C_CALL mt32emu_create_context(mt32emu_report_handler_i r
 		data->reportHandler = NULL;
 	}
 	data->midiParser = new DefaultMidiStreamParser(*data->synth);
+	data->midiEventSource = NULL;
 	data->controlROMImage = NULL;
 	data->pcmROMImage = NULL;
 	data->partialCount = DEFAULT_MAX_PARTIALS;
@@ -586,6 +638,8 @@ void MT32EMU_C_CALL mt32emu_free_context(mt32emu_context data) {
 	data->midiParser = NULL;
 	delete data->synth;
 	data->synth = NULL;
+	delete data->midiEventSource;
+	data->midiEventSource = NULL;
 	delete data->reportHandler;
 	data->reportHandler = NULL;
 	delete data;
@@ -726,11 +780,22 @@ void MT32EMU_C_CALL mt32emu_configure_midi_event_queue_sysex_storage(mt32emu_con
 	context->synth->configureMIDIEventQueueSysexStorage(storage_buffer_size);
 }
 
+mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_midi_allocation_count(mt32emu_const_context context) {
+	return context->synth->getMIDIEventQueueAllocationCount() + context->midiParser->getStreamBufferAllocationCount();
+}
+
 void MT32EMU_C_CALL mt32emu_set_midi_receiver(mt32emu_context context, mt32emu_midi_receiver_i midi_receiver, void *instance_data) {
 	delete context->midiParser;
 	context->midiParser = (midi_receiver.v0 != NULL) ? new DelegatingMidiStreamParser(context, midi_receiver, instance_data) : new DefaultMidiStreamParser(*context->synth);
 }
 
+void MT32EMU_C_CALL mt32emu_set_midi_event_source(mt32emu_context context, mt32emu_midi_event_source_i midi_event_source, void *instance_data) {
+	MidiEventSource *oldMIDIEventSource = context->midiEventSource;
+	context->midiEventSource = (midi_event_source.v0 != NULL) ? new DelegatingMidiEventSource(midi_event_source, instance_data) : NULL;
+	context->synth->setMidiEventSource(context->midiEventSource);
+	delete oldMIDIEventSource;
+}
+
 mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_internal_rendered_sample_count(mt32emu_const_context context) {
 	return context->synth->getInternalRenderedSampleCount();
 }
@@ -775,6 +840,17 @@ mt32emu_return_code MT32EMU_C_CALL mt32emu_play_sysex_at(mt32emu_const_context c
 	return (context->synth->playSysex(sysex, len, timestamp)) ? MT32EMU_RC_OK : MT32EMU_RC_QUEUE_FULL;
 }
 
+mt32emu_return_code MT32EMU_C_CALL mt32emu_play_sysex_bulk(mt32emu_const_context context, const mt32emu_bit8u *sysex_bulk, mt32emu_bit32u len, mt32emu_bit32u timestamp, mt32emu_sysex_bulk_release_callback release_callback, void *instance_data) {
+	if (!context->synth->isOpen()) return MT32EMU_RC_NOT_OPENED;
+	if (release_callback == NULL) return MT32EMU_RC_FAILED;
+	SysexBulkReleaseDelegate *delegate = new SysexBulkReleaseDelegate;
+	delegate->releaseCallback = release_callback;
+	delegate->instanceData = instance_data;
+	if (context->synth->playSysexBulk(sysex_bulk, len, timestamp, releaseSysexBulk, delegate)) return MT32EMU_RC_OK;
+	delete delegate;
+	return MT32EMU_RC_FAILED;
+}
+
 void MT32EMU_C_CALL mt32emu_play_msg_now(mt32emu_const_context context, mt32emu_bit32u msg) {
 	context->synth->playMsgNow(msg);
 }
@@ -895,6 +971,34 @@ mt32emu_boolean MT32EMU_C_CALL mt32emu_is_nice_partial_mixing_enabled(mt32emu_co
 	return context->synth->isNicePartialMixingEnabled() ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE;
 }
 
+void MT32EMU_C_CALL mt32emu_set_partial_culling_enabled(mt32emu_const_context context, const mt32emu_boolean enabled) {
+	context->synth->setPartialCullingEnabled(enabled != MT32EMU_BOOL_FALSE);
+}
+
+mt32emu_boolean MT32EMU_C_CALL mt32emu_is_partial_culling_enabled(mt32emu_const_context context) {
+	return context->synth->isPartialCullingEnabled() ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE;
+}
+
+void MT32EMU_C_CALL mt32emu_set_partial_culling_threshold(mt32emu_const_context context, const float attenuation_db) {
+	context->synth->setPartialCullingThreshold(attenuation_db);
+}
+
+float MT32EMU_C_CALL mt32emu_get_partial_culling_threshold(mt32emu_const_context context) {
+	return context->synth->getPartialCullingThreshold();
+}
+
+mt32emu_bit64u MT32EMU_C_CALL mt32emu_get_culled_partial_sample_count(mt32emu_const_context context) {
+	return context->synth->getCulledPartialSampleCount();
+}
+
+void MT32EMU_C_CALL mt32emu_set_low_latency_rendering_enabled(mt32emu_const_context context, const mt32emu_boolean enabled) {
+	context->synth->setLowLatencyRenderingEnabled(enabled != MT32EMU_BOOL_FALSE);
+}
+
+mt32emu_boolean MT32EMU_C_CALL mt32emu_is_low_latency_rendering_enabled(mt32emu_const_context context) {
+	return context->synth->isLowLatencyRenderingEnabled() ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE;
+}
+
 void MT32EMU_C_CALL mt32emu_render_bit16s(mt32emu_const_context context, mt32emu_bit16s *stream, mt32emu_bit32u len) {
 	if (context->srcState->src != NULL) {
 		context->srcState->src->getOutputSamples(stream, len);
@@ -931,6 +1035,26 @@ mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_partial_count(mt32emu_const_context co
 	return context->synth->getPartialCount();
 }
 
+void MT32EMU_C_CALL mt32emu_set_partial_limit(mt32emu_const_context context, mt32emu_bit32u partial_limit) {
+	context->synth->setPartialLimit(partial_limit);
+}
+
+mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_partial_limit(mt32emu_const_context context) {
+	return context->synth->getPartialLimit();
+}
+
+void MT32EMU_C_CALL mt32emu_set_cpu_budget(mt32emu_const_context context, mt32emu_bit32u cpu_budget) {
+	context->synth->setCPUBudget(cpu_budget);
+}
+
+mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_cpu_budget(mt32emu_const_context context) {
+	return context->synth->getCPUBudget();
+}
+
+void MT32EMU_C_CALL mt32emu_report_render_load(mt32emu_const_context context, double render_time, double rendered_duration) {
+	context->synth->reportRenderLoad(render_time, rendered_duration);
+}
+
 mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_part_states(mt32emu_const_context context) {
 	return context->synth->getPartStates();
 }
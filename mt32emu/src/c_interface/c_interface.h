@@ -58,6 +58,12 @@ MT32EMU_EXPORT mt32emu_report_handler_version MT32EMU_C_CALL mt32emu_get_support
  */
 MT32EMU_EXPORT mt32emu_midi_receiver_version MT32EMU_C_CALL mt32emu_get_supported_midi_receiver_version(void);
 
+/**
+ * Returns the version ID of mt32emu_midi_event_source_i interface the library has been compiled with.
+ * This allows a client to fall-back gracefully to enqueueing MIDI events when the interface is unsupported.
+ */
+MT32EMU_EXPORT_V(2.8) mt32emu_midi_event_source_version MT32EMU_C_CALL mt32emu_get_supported_midi_event_source_version(void);
+
 /* === Utility === */
 
 /**
@@ -302,6 +308,14 @@ MT32EMU_EXPORT mt32emu_bit32u MT32EMU_C_CALL mt32emu_set_midi_event_queue_size(m
  */
 MT32EMU_EXPORT void MT32EMU_C_CALL mt32emu_configure_midi_event_queue_sysex_storage(mt32emu_const_context context, const mt32emu_bit32u storage_buffer_size);
 
+/**
+ * Debugging aid for realtime applications. Returns the number of heap allocations performed on the MIDI input path
+ * of the context, i.e. by the SysEx storage of the internal MIDI event queue since it was created and by the MIDI stream
+ * parser since it was installed. Once the synth is opened and the SysEx storage pools warm up, the value is expected
+ * to stay constant.
+ */
+MT32EMU_EXPORT_V(2.8) mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_midi_allocation_count(mt32emu_const_context context);
+
 /**
  * Installs custom MIDI receiver object intended for receiving MIDI messages generated by MIDI stream parser.
  * MIDI stream parser is involved when functions mt32emu_parse_stream() and mt32emu_play_short_message() or the likes are called.
@@ -310,6 +324,14 @@ MT32EMU_EXPORT void MT32EMU_C_CALL mt32emu_configure_midi_event_queue_sysex_stor
  */
 MT32EMU_EXPORT void MT32EMU_C_CALL mt32emu_set_midi_receiver(mt32emu_context context, mt32emu_midi_receiver_i midi_receiver, void *instance_data);
 
+/**
+ * Installs custom MIDI event source object the synth pulls timestamped MIDI events from while rendering, as an alternative
+ * to enqueueing them beforehand. The source is invoked in the rendering thread and by mt32emu_is_active(), hence the latter
+ * must not be called concurrently with rendering while a source is installed. Events from the source are played alongside
+ * those in the input MIDI queue. If midi_event_source argument is set to NULL, the installed source is removed.
+ */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_set_midi_event_source(mt32emu_context context, mt32emu_midi_event_source_i midi_event_source, void *instance_data);
+
 /**
  * Returns current value of the global counter of samples rendered since the synth was created (at the native sample rate 32000 Hz).
  * This method helps to compute accurate timestamp of a MIDI message to use with the methods below.
@@ -365,6 +387,16 @@ MT32EMU_EXPORT mt32emu_return_code MT32EMU_C_CALL mt32emu_play_msg_at(mt32emu_co
 /** Enqueues a single well formed System Exclusive MIDI message to play at specified time. */
 MT32EMU_EXPORT mt32emu_return_code MT32EMU_C_CALL mt32emu_play_sysex_at(mt32emu_const_context context, const mt32emu_bit8u *sysex, mt32emu_bit32u len, mt32emu_bit32u timestamp);
 
+/**
+ * Enqueues a bulk of well formed System Exclusive MIDI messages that follow one another (e.g. contents of a .syx file
+ * or a concatenated memory dump) to play starting at specified time. The data is not copied, instead, the buffer is handed
+ * over to the synth until release_callback is invoked with the provided instance_data. Normally, this happens in the rendering
+ * thread right after the last message of the bulk is played. The bulk is validated beforehand and rejected as a whole
+ * with MT32EMU_RC_FAILED if any message is malformed, not intended for this device or has a wrong checksum, as well as
+ * when the MIDI event queue is full. The callback is never invoked if the bulk is rejected.
+ */
+MT32EMU_EXPORT_V(2.8) mt32emu_return_code MT32EMU_C_CALL mt32emu_play_sysex_bulk(mt32emu_const_context context, const mt32emu_bit8u *sysex_bulk, mt32emu_bit32u len, mt32emu_bit32u timestamp, mt32emu_sysex_bulk_release_callback release_callback, void *instance_data);
+
 /* WARNING:
  * The methods below don't ensure minimum 1-sample delay between sequential MIDI events,
  * and a sequence of NoteOn and immediately succeeding NoteOff messages is always silent.
@@ -521,6 +553,30 @@ MT32EMU_EXPORT void MT32EMU_C_CALL mt32emu_set_nice_partial_mixing_enabled(mt32e
 /** Returns whether NicePartialMixing mode is enabled. */
 MT32EMU_EXPORT mt32emu_boolean MT32EMU_C_CALL mt32emu_is_nice_partial_mixing_enabled(mt32emu_const_context context);
 
+/**
+ * Enables culling of partials that have become inaudible in the release phase. The waveform of a culled partial
+ * is no longer generated, yet it ends at exactly the same time as it would otherwise.
+ * Only applies to the integer renderer. This mode is disabled by default.
+ */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_set_partial_culling_enabled(mt32emu_const_context context, const mt32emu_boolean enabled);
+/** Returns whether culling of inaudible partials is enabled. */
+MT32EMU_EXPORT_V(2.8) mt32emu_boolean MT32EMU_C_CALL mt32emu_is_partial_culling_enabled(mt32emu_const_context context);
+/** Sets the attenuation in dB at which releasing partials are culled. The default value is about 78.3 dB. */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_set_partial_culling_threshold(mt32emu_const_context context, const float attenuation_db);
+/** Returns the attenuation in dB at which releasing partials are culled. */
+MT32EMU_EXPORT_V(2.8) float MT32EMU_C_CALL mt32emu_get_partial_culling_threshold(mt32emu_const_context context);
+/** Returns the total number of samples that were not generated for the partials culled since the synth was opened. */
+MT32EMU_EXPORT_V(2.8) mt32emu_bit64u MT32EMU_C_CALL mt32emu_get_culled_partial_sample_count(mt32emu_const_context context);
+
+/**
+ * Enables the low-latency rendering mode, which is intended for rendering in small blocks, e.g. of 16 to 128 frames.
+ * In this mode, the display state is checked once per rendering call rather than after each chunk, which the rendered blocks
+ * are split into at the MIDI event timestamps. This mode is disabled by default.
+ */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_set_low_latency_rendering_enabled(mt32emu_const_context context, const mt32emu_boolean enabled);
+/** Returns whether the low-latency rendering mode is enabled. */
+MT32EMU_EXPORT_V(2.8) mt32emu_boolean MT32EMU_C_CALL mt32emu_is_low_latency_rendering_enabled(mt32emu_const_context context);
+
 /**
  * Renders samples to the specified output stream as if they were sampled at the analog stereo output at the desired sample rate.
  * If the output sample rate is not specified explicitly, the default output sample rate is used which depends on the current
@@ -550,6 +606,29 @@ MT32EMU_EXPORT mt32emu_boolean MT32EMU_C_CALL mt32emu_is_active(mt32emu_const_co
 /** Returns the maximum number of partials playing simultaneously. */
 MT32EMU_EXPORT mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_partial_count(mt32emu_const_context context);
 
+/**
+ * Sets the maximum number of partials permitted to play simultaneously, without re-opening the synth.
+ * The limit cannot exceed the partial count the synth was opened with, and it is reset to that value upon opening.
+ * Has no effect unless the synth is open.
+ */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_set_partial_limit(mt32emu_const_context context, mt32emu_bit32u partial_limit);
+/** Returns the maximum number of partials currently permitted to play simultaneously. */
+MT32EMU_EXPORT_V(2.8) mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_partial_limit(mt32emu_const_context context);
+
+/**
+ * Sets the share of real time, in percent of the duration of the rendered audio, the rendering is allowed to take.
+ * While the load reported via mt32emu_report_render_load() exceeds the budget, the partial limit is lowered temporarily.
+ * Zero disables the governor and restores the partial limit set via mt32emu_set_partial_limit().
+ */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_set_cpu_budget(mt32emu_const_context context, mt32emu_bit32u cpu_budget);
+/** Returns the CPU budget set via mt32emu_set_cpu_budget(), zero when the partial limit governor is disabled. */
+MT32EMU_EXPORT_V(2.8) mt32emu_bit32u MT32EMU_C_CALL mt32emu_get_cpu_budget(mt32emu_const_context context);
+/**
+ * Reports the time taken to render a chunk of audio along with the duration of the chunk, in the same units.
+ * Must be called from the rendering thread or otherwise synchronised with rendering.
+ */
+MT32EMU_EXPORT_V(2.8) void MT32EMU_C_CALL mt32emu_report_render_load(mt32emu_const_context context, double render_time, double rendered_duration);
+
 /**
  * Returns current states of all the parts as a bit set. The least significant bit corresponds to the state of part 1,
  * total of 9 bits hold the states of all the parts. If the returned bit for a part is set, there is at least one active
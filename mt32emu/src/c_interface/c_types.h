@@ -40,6 +40,18 @@ typedef   signed short int mt32emu_bit16s;
 typedef unsigned char      mt32emu_bit8u;
 typedef   signed char      mt32emu_bit8s;
 
+/* C89 lacks a 64-bit integer type, yet it is provided as an extension by all the supported compilers. */
+#if defined(_MSC_VER)
+typedef unsigned __int64   mt32emu_bit64u;
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wlong-long"
+typedef unsigned long long mt32emu_bit64u;
+#pragma GCC diagnostic pop
+#else
+typedef unsigned long long mt32emu_bit64u;
+#endif
+
 typedef char mt32emu_sha1_digest[41];
 
 typedef enum {
@@ -72,6 +84,12 @@ typedef enum {
 typedef struct mt32emu_data *mt32emu_context;
 typedef const struct mt32emu_data *mt32emu_const_context;
 
+/**
+ * Function that is invoked once the synth no longer refers to a buffer passed to mt32emu_play_sysex_bulk(),
+ * so that the client may dispose of it. The instance_data is the value provided along with the buffer.
+ */
+typedef void (MT32EMU_C_CALL *mt32emu_sysex_bulk_release_callback)(void *instance_data, const mt32emu_bit8u *sysex_bulk);
+
 /* Convenience aliases */
 #ifndef __cplusplus
 typedef enum mt32emu_analog_output_mode mt32emu_analog_output_mode;
@@ -127,6 +145,12 @@ typedef enum {
 	MT32EMU_MIDI_RECEIVER_VERSION_CURRENT = MT32EMU_MIDI_RECEIVER_VERSION_0
 } mt32emu_midi_receiver_version;
 
+/** MIDI event source interface versions */
+typedef enum {
+	MT32EMU_MIDI_EVENT_SOURCE_VERSION_0 = 0,
+	MT32EMU_MIDI_EVENT_SOURCE_VERSION_CURRENT = MT32EMU_MIDI_EVENT_SOURCE_VERSION_0
+} mt32emu_midi_event_source_version;
+
 /** Synth interface versions */
 typedef enum {
 	MT32EMU_SERVICE_VERSION_0 = 0,
@@ -136,7 +160,8 @@ typedef enum {
 	MT32EMU_SERVICE_VERSION_4 = 4,
 	MT32EMU_SERVICE_VERSION_5 = 5,
 	MT32EMU_SERVICE_VERSION_6 = 6,
-	MT32EMU_SERVICE_VERSION_CURRENT = MT32EMU_SERVICE_VERSION_6
+	MT32EMU_SERVICE_VERSION_7 = 7,
+	MT32EMU_SERVICE_VERSION_CURRENT = MT32EMU_SERVICE_VERSION_7
 } mt32emu_service_version;
 
 /* === Report Handler Interface === */
@@ -238,6 +263,38 @@ union mt32emu_midi_receiver_i {
 	const mt32emu_midi_receiver_i_v0 *v0;
 };
 
+/* === MIDI Event Source Interface === */
+
+typedef union mt32emu_midi_event_source_i mt32emu_midi_event_source_i;
+
+/**
+ * Interface for supplying timestamped MIDI events that the synth pulls in the rendering thread (initial version).
+ * Events must be supplied in the order of non-decreasing timestamps.
+ */
+typedef struct {
+	/** Returns the actual interface version ID */
+	mt32emu_midi_event_source_version (MT32EMU_C_CALL *getVersionID)(mt32emu_midi_event_source_i i);
+
+	/**
+	 * Invoked to look at the next pending MIDI event without consuming it. Returns MT32EMU_BOOL_FALSE if there are no
+	 * pending events. Otherwise, fills in the timestamp and either a short message (when sysex_data is set to NULL)
+	 * or a System Exclusive message that must remain valid until the event is dropped.
+	 */
+	mt32emu_boolean (MT32EMU_C_CALL *peekMidiEvent)(void *instance_data, mt32emu_bit32u *timestamp, mt32emu_bit32u *short_message, const mt32emu_bit8u **sysex_data, mt32emu_bit32u *sysex_length);
+
+	/** Invoked when the event last returned by peekMidiEvent() is consumed by the synth. */
+	void (MT32EMU_C_CALL *dropMidiEvent)(void *instance_data);
+} mt32emu_midi_event_source_i_v0;
+
+/**
+ * Extensible interface for supplying MIDI events.
+ * Union intended to view an interface of any subsequent version as any parent interface not requiring a cast.
+ * It is caller's responsibility to check the actual interface version in runtime using the getVersionID() method.
+ */
+union mt32emu_midi_event_source_i {
+	const mt32emu_midi_event_source_i_v0 *v0;
+};
+
 /* === Service Interface === */
 
 typedef union mt32emu_service_i mt32emu_service_i;
@@ -370,6 +427,24 @@ typedef union mt32emu_service_i mt32emu_service_i;
 	mt32emu_boolean (MT32EMU_C_CALL *getSoundGroupName)(mt32emu_const_context context, char *sound_group_name, mt32emu_bit8u timbre_group, mt32emu_bit8u timbre_number); \
 	mt32emu_boolean (MT32EMU_C_CALL *getSoundName)(mt32emu_const_context context, char *sound_name, mt32emu_bit8u timbre_group, mt32emu_bit8u timbre_number);
 
+#define MT32EMU_SERVICE_I_V7 \
+	mt32emu_midi_event_source_version (MT32EMU_C_CALL *getSupportedMIDIEventSourceVersionID)(void); \
+	void (MT32EMU_C_CALL *setMIDIEventSource)(mt32emu_context context, mt32emu_midi_event_source_i midi_event_source, void *instance_data); \
+	mt32emu_return_code (MT32EMU_C_CALL *playSysexBulk)(mt32emu_const_context context, const mt32emu_bit8u *sysex_bulk, mt32emu_bit32u len, mt32emu_bit32u timestamp, mt32emu_sysex_bulk_release_callback release_callback, void *instance_data); \
+	void (MT32EMU_C_CALL *setPartialLimit)(mt32emu_const_context context, mt32emu_bit32u partial_limit); \
+	mt32emu_bit32u (MT32EMU_C_CALL *getPartialLimit)(mt32emu_const_context context); \
+	void (MT32EMU_C_CALL *setCPUBudget)(mt32emu_const_context context, mt32emu_bit32u cpu_budget); \
+	mt32emu_bit32u (MT32EMU_C_CALL *getCPUBudget)(mt32emu_const_context context); \
+	void (MT32EMU_C_CALL *reportRenderLoad)(mt32emu_const_context context, double render_time, double rendered_duration); \
+	mt32emu_bit32u (MT32EMU_C_CALL *getMIDIAllocationCount)(mt32emu_const_context context); \
+	void (MT32EMU_C_CALL *setPartialCullingEnabled)(mt32emu_const_context context, const mt32emu_boolean enabled); \
+	mt32emu_boolean (MT32EMU_C_CALL *isPartialCullingEnabled)(mt32emu_const_context context); \
+	void (MT32EMU_C_CALL *setPartialCullingThreshold)(mt32emu_const_context context, const float attenuation_db); \
+	float (MT32EMU_C_CALL *getPartialCullingThreshold)(mt32emu_const_context context); \
+	mt32emu_bit64u (MT32EMU_C_CALL *getCulledPartialSampleCount)(mt32emu_const_context context); \
+	void (MT32EMU_C_CALL *setLowLatencyRenderingEnabled)(mt32emu_const_context context, const mt32emu_boolean enabled); \
+	mt32emu_boolean (MT32EMU_C_CALL *isLowLatencyRenderingEnabled)(mt32emu_const_context context);
+
 typedef struct {
 	MT32EMU_SERVICE_I_V0
 } mt32emu_service_i_v0;
@@ -419,6 +494,17 @@ typedef struct {
 	MT32EMU_SERVICE_I_V6
 } mt32emu_service_i_v6;
 
+typedef struct {
+	MT32EMU_SERVICE_I_V0
+	MT32EMU_SERVICE_I_V1
+	MT32EMU_SERVICE_I_V2
+	MT32EMU_SERVICE_I_V3
+	MT32EMU_SERVICE_I_V4
+	MT32EMU_SERVICE_I_V5
+	MT32EMU_SERVICE_I_V6
+	MT32EMU_SERVICE_I_V7
+} mt32emu_service_i_v7;
+
 /**
  * Extensible interface for all the library services.
  * Union intended to view an interface of any subsequent version as any parent interface not requiring a cast.
@@ -432,6 +518,7 @@ union mt32emu_service_i {
 	const mt32emu_service_i_v4 *v4;
 	const mt32emu_service_i_v5 *v5;
 	const mt32emu_service_i_v6 *v6;
+	const mt32emu_service_i_v7 *v7;
 };
 
 #undef MT32EMU_SERVICE_I_V0
@@ -441,5 +528,6 @@ union mt32emu_service_i {
 #undef MT32EMU_SERVICE_I_V4
 #undef MT32EMU_SERVICE_I_V5
 #undef MT32EMU_SERVICE_I_V6
+#undef MT32EMU_SERVICE_I_V7
 
 #endif /* #ifndef MT32EMU_C_TYPES_H */
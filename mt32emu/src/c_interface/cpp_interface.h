@@ -37,6 +37,7 @@ mt32emu_service_i mt32emu_get_service_i();
 
 #define mt32emu_get_supported_report_handler_version i.v0->getSupportedReportHandlerVersionID
 #define mt32emu_get_supported_midi_receiver_version i.v0->getSupportedMIDIReceiverVersionID
+#define mt32emu_get_supported_midi_event_source_version iV7()->getSupportedMIDIEventSourceVersionID
 #define mt32emu_get_library_version_int i.v0->getLibraryVersionInt
 #define mt32emu_get_library_version_string i.v0->getLibraryVersionString
 #define mt32emu_get_stereo_output_samplerate i.v0->getStereoOutputSamplerate
@@ -68,7 +69,9 @@ mt32emu_service_i mt32emu_get_service_i();
 #define mt32emu_flush_midi_queue i.v0->flushMIDIQueue
 #define mt32emu_set_midi_event_queue_size i.v0->setMIDIEventQueueSize
 #define mt32emu_configure_midi_event_queue_sysex_storage iV3()->configureMIDIEventQueueSysexStorage
+#define mt32emu_get_midi_allocation_count iV7()->getMIDIAllocationCount
 #define mt32emu_set_midi_receiver i.v0->setMIDIReceiver
+#define mt32emu_set_midi_event_source iV7()->setMIDIEventSource
 #define mt32emu_get_internal_rendered_sample_count iV2()->getInternalRenderedSampleCount
 #define mt32emu_parse_stream i.v0->parseStream
 #define mt32emu_parse_stream_at i.v0->parseStream_At
@@ -78,6 +81,7 @@ mt32emu_service_i mt32emu_get_service_i();
 #define mt32emu_play_sysex i.v0->playSysex
 #define mt32emu_play_msg_at i.v0->playMsgAt
 #define mt32emu_play_sysex_at i.v0->playSysexAt
+#define mt32emu_play_sysex_bulk iV7()->playSysexBulk
 #define mt32emu_play_msg_now i.v0->playMsgNow
 #define mt32emu_play_msg_on_part i.v0->playMsgOnPart
 #define mt32emu_play_sysex_now i.v0->playSysexNow
@@ -108,6 +112,13 @@ mt32emu_service_i mt32emu_get_service_i();
 #define mt32emu_is_nice_panning_enabled iV3()->isNicePanningEnabled
 #define mt32emu_set_nice_partial_mixing_enabled iV3()->setNicePartialMixingEnabled
 #define mt32emu_is_nice_partial_mixing_enabled iV3()->isNicePartialMixingEnabled
+#define mt32emu_set_partial_culling_enabled iV7()->setPartialCullingEnabled
+#define mt32emu_is_partial_culling_enabled iV7()->isPartialCullingEnabled
+#define mt32emu_set_partial_culling_threshold iV7()->setPartialCullingThreshold
+#define mt32emu_get_partial_culling_threshold iV7()->getPartialCullingThreshold
+#define mt32emu_get_culled_partial_sample_count iV7()->getCulledPartialSampleCount
+#define mt32emu_set_low_latency_rendering_enabled iV7()->setLowLatencyRenderingEnabled
+#define mt32emu_is_low_latency_rendering_enabled iV7()->isLowLatencyRenderingEnabled
 #define mt32emu_render_bit16s i.v0->renderBit16s
 #define mt32emu_render_float i.v0->renderFloat
 #define mt32emu_render_bit16s_streams i.v0->renderBit16sStreams
@@ -115,6 +126,11 @@ mt32emu_service_i mt32emu_get_service_i();
 #define mt32emu_has_active_partials i.v0->hasActivePartials
 #define mt32emu_is_active i.v0->isActive
 #define mt32emu_get_partial_count i.v0->getPartialCount
+#define mt32emu_set_partial_limit iV7()->setPartialLimit
+#define mt32emu_get_partial_limit iV7()->getPartialLimit
+#define mt32emu_set_cpu_budget iV7()->setCPUBudget
+#define mt32emu_get_cpu_budget iV7()->getCPUBudget
+#define mt32emu_report_render_load iV7()->reportRenderLoad
 #define mt32emu_get_part_states i.v0->getPartStates
 #define mt32emu_get_partial_states i.v0->getPartialStates
 #define mt32emu_get_playing_notes i.v0->getPlayingNotes
@@ -141,6 +157,7 @@ namespace CppInterfaceImpl {
 static const mt32emu_report_handler_i NULL_REPORT_HANDLER = { NULL };
 static mt32emu_report_handler_i getReportHandlerThunk(mt32emu_report_handler_version);
 static mt32emu_midi_receiver_i getMidiReceiverThunk();
+static mt32emu_midi_event_source_i getMidiEventSourceThunk();
 
 }
 
@@ -198,6 +215,17 @@ protected:
 	~IMidiReceiver() {}
 };
 
+// Defines the interface for supplying timestamped MIDI events pulled by the synth while rendering.
+// Corresponds to the current version of mt32emu_midi_event_source_i interface.
+class IMidiEventSource {
+public:
+	virtual bool peekMidiEvent(Bit32u &timestamp, Bit32u &shortMessage, const Bit8u *&sysexData, Bit32u &sysexLength) = 0;
+	virtual void dropMidiEvent() = 0;
+
+protected:
+	~IMidiEventSource() {}
+};
+
 // Defines all the library services.
 // Corresponds to the current version of mt32emu_service_i interface.
 class Service {
@@ -216,6 +244,7 @@ public:
 #endif
 	mt32emu_report_handler_version getSupportedReportHandlerVersionID() { return mt32emu_get_supported_report_handler_version(); }
 	mt32emu_midi_receiver_version getSupportedMIDIReceiverVersionID() { return mt32emu_get_supported_midi_receiver_version(); }
+	mt32emu_midi_event_source_version getSupportedMIDIEventSourceVersionID() { return mt32emu_get_supported_midi_event_source_version(); }
 
 	Bit32u getLibraryVersionInt() { return mt32emu_get_library_version_int(); }
 	const char *getLibraryVersionString() { return mt32emu_get_library_version_string(); }
@@ -257,8 +286,11 @@ public:
 	void flushMIDIQueue() { mt32emu_flush_midi_queue(c); }
 	Bit32u setMIDIEventQueueSize(const Bit32u queue_size) { return mt32emu_set_midi_event_queue_size(c, queue_size); }
 	void configureMIDIEventQueueSysexStorage(const Bit32u storage_buffer_size) { mt32emu_configure_midi_event_queue_sysex_storage(c, storage_buffer_size); }
+	Bit32u getMIDIAllocationCount() { return mt32emu_get_midi_allocation_count(c); }
 	void setMIDIReceiver(mt32emu_midi_receiver_i midi_receiver, void *instance_data) { mt32emu_set_midi_receiver(c, midi_receiver, instance_data); }
 	void setMIDIReceiver(IMidiReceiver &midi_receiver) { setMIDIReceiver(CppInterfaceImpl::getMidiReceiverThunk(), &midi_receiver); }
+	void setMIDIEventSource(mt32emu_midi_event_source_i midi_event_source, void *instance_data) { mt32emu_set_midi_event_source(c, midi_event_source, instance_data); }
+	void setMIDIEventSource(IMidiEventSource &midi_event_source) { setMIDIEventSource(CppInterfaceImpl::getMidiEventSourceThunk(), &midi_event_source); }
 
 	Bit32u getInternalRenderedSampleCount() { return mt32emu_get_internal_rendered_sample_count(c); }
 	void parseStream(const Bit8u *stream, Bit32u length) { mt32emu_parse_stream(c, stream, length); }
@@ -269,6 +301,7 @@ public:
 	mt32emu_return_code playSysex(const Bit8u *sysex, Bit32u len) { return mt32emu_play_sysex(c, sysex, len); }
 	mt32emu_return_code playMsgAt(Bit32u msg, Bit32u timestamp) { return mt32emu_play_msg_at(c, msg, timestamp); }
 	mt32emu_return_code playSysexAt(const Bit8u *sysex, Bit32u len, Bit32u timestamp) { return mt32emu_play_sysex_at(c, sysex, len, timestamp); }
+	mt32emu_return_code playSysexBulk(const Bit8u *sysex_bulk, Bit32u len, Bit32u timestamp, mt32emu_sysex_bulk_release_callback release_callback, void *instance_data) { return mt32emu_play_sysex_bulk(c, sysex_bulk, len, timestamp, release_callback, instance_data); }
 
 	void playMsgNow(Bit32u msg) { mt32emu_play_msg_now(c, msg); }
 	void playMsgOnPart(Bit8u part, Bit8u code, Bit8u note, Bit8u velocity) { mt32emu_play_msg_on_part(c, part, code, note, velocity); }
@@ -309,6 +342,14 @@ public:
 
 	void setNicePartialMixingEnabled(const bool enabled) { mt32emu_set_nice_partial_mixing_enabled(c, enabled ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE); }
 	bool isNicePartialMixingEnabled() { return mt32emu_is_nice_partial_mixing_enabled(c) != MT32EMU_BOOL_FALSE; }
+	void setPartialCullingEnabled(const bool enabled) { mt32emu_set_partial_culling_enabled(c, enabled ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE); }
+	bool isPartialCullingEnabled() { return mt32emu_is_partial_culling_enabled(c) != MT32EMU_BOOL_FALSE; }
+	void setPartialCullingThreshold(const float attenuation_db) { mt32emu_set_partial_culling_threshold(c, attenuation_db); }
+	float getPartialCullingThreshold() { return mt32emu_get_partial_culling_threshold(c); }
+	Bit64u getCulledPartialSampleCount() { return mt32emu_get_culled_partial_sample_count(c); }
+
+	void setLowLatencyRenderingEnabled(const bool enabled) { mt32emu_set_low_latency_rendering_enabled(c, enabled ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE); }
+	bool isLowLatencyRenderingEnabled() { return mt32emu_is_low_latency_rendering_enabled(c) != MT32EMU_BOOL_FALSE; }
 
 	void renderBit16s(Bit16s *stream, Bit32u len) { mt32emu_render_bit16s(c, stream, len); }
 	void renderFloat(float *stream, Bit32u len) { mt32emu_render_float(c, stream, len); }
@@ -318,6 +359,11 @@ public:
 	bool hasActivePartials() { return mt32emu_has_active_partials(c) != MT32EMU_BOOL_FALSE; }
 	bool isActive() { return mt32emu_is_active(c) != MT32EMU_BOOL_FALSE; }
 	Bit32u getPartialCount() { return mt32emu_get_partial_count(c); }
+	void setPartialLimit(Bit32u partial_limit) { mt32emu_set_partial_limit(c, partial_limit); }
+	Bit32u getPartialLimit() { return mt32emu_get_partial_limit(c); }
+	void setCPUBudget(Bit32u cpu_budget) { mt32emu_set_cpu_budget(c, cpu_budget); }
+	Bit32u getCPUBudget() { return mt32emu_get_cpu_budget(c); }
+	void reportRenderLoad(double render_time, double rendered_duration) { mt32emu_report_render_load(c, render_time, rendered_duration); }
 	Bit32u getPartStates() { return mt32emu_get_part_states(c); }
 	void getPartialStates(Bit8u *partial_states) { mt32emu_get_partial_states(c, partial_states); }
 	Bit32u getPlayingNotes(Bit8u part_number, Bit8u *keys, Bit8u *velocities) { return mt32emu_get_playing_notes(c, part_number, keys, velocities); }
@@ -346,6 +392,7 @@ private:
 	const mt32emu_service_i_v4 *iV4() { return (getVersionID() < MT32EMU_SERVICE_VERSION_4) ? NULL : i.v4; }
 	const mt32emu_service_i_v5 *iV5() { return (getVersionID() < MT32EMU_SERVICE_VERSION_5) ? NULL : i.v5; }
 	const mt32emu_service_i_v6 *iV6() { return (getVersionID() < MT32EMU_SERVICE_VERSION_6) ? NULL : i.v6; }
+	const mt32emu_service_i_v7 *iV7() { return (getVersionID() < MT32EMU_SERVICE_VERSION_7) ? NULL : i.v7; }
 #endif
 
 	Service(const Service &);            // prevent copy-construction
@@ -490,6 +537,30 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 	return MIDI_RECEIVER_THUNK;
 }
 
+static mt32emu_midi_event_source_version MT32EMU_C_CALL getMidiEventSourceVersionID(mt32emu_midi_event_source_i) {
+	return MT32EMU_MIDI_EVENT_SOURCE_VERSION_CURRENT;
+}
+
+static mt32emu_boolean MT32EMU_C_CALL peekMidiEvent(void *instance_data, mt32emu_bit32u *timestamp, mt32emu_bit32u *short_message, const mt32emu_bit8u **sysex_data, mt32emu_bit32u *sysex_length) {
+	return static_cast<IMidiEventSource *>(instance_data)->peekMidiEvent(*timestamp, *short_message, *sysex_data, *sysex_length) ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE;
+}
+
+static void MT32EMU_C_CALL dropMidiEvent(void *instance_data) {
+	static_cast<IMidiEventSource *>(instance_data)->dropMidiEvent();
+}
+
+static mt32emu_midi_event_source_i getMidiEventSourceThunk() {
+	static const mt32emu_midi_event_source_i_v0 MIDI_EVENT_SOURCE_V0_THUNK = {
+		getMidiEventSourceVersionID,
+		peekMidiEvent,
+		dropMidiEvent
+	};
+
+	static const mt32emu_midi_event_source_i MIDI_EVENT_SOURCE_THUNK = { &MIDI_EVENT_SOURCE_V0_THUNK };
+
+	return MIDI_EVENT_SOURCE_THUNK;
+}
+
 } // namespace CppInterfaceImpl
 
 } // namespace MT32Emu
@@ -498,6 +569,7 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 
 #undef mt32emu_get_supported_report_handler_version
 #undef mt32emu_get_supported_midi_receiver_version
+#undef mt32emu_get_supported_midi_event_source_version
 #undef mt32emu_get_library_version_int
 #undef mt32emu_get_library_version_string
 #undef mt32emu_get_stereo_output_samplerate
@@ -529,7 +601,9 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 #undef mt32emu_flush_midi_queue
 #undef mt32emu_set_midi_event_queue_size
 #undef mt32emu_configure_midi_event_queue_sysex_storage
+#undef mt32emu_get_midi_allocation_count
 #undef mt32emu_set_midi_receiver
+#undef mt32emu_set_midi_event_source
 #undef mt32emu_get_internal_rendered_sample_count
 #undef mt32emu_parse_stream
 #undef mt32emu_parse_stream_at
@@ -539,6 +613,7 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 #undef mt32emu_play_sysex
 #undef mt32emu_play_msg_at
 #undef mt32emu_play_sysex_at
+#undef mt32emu_play_sysex_bulk
 #undef mt32emu_play_msg_now
 #undef mt32emu_play_msg_on_part
 #undef mt32emu_play_sysex_now
@@ -567,6 +642,13 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 #undef mt32emu_is_nice_panning_enabled
 #undef mt32emu_set_nice_partial_mixing_enabled
 #undef mt32emu_is_nice_partial_mixing_enabled
+#undef mt32emu_set_partial_culling_enabled
+#undef mt32emu_is_partial_culling_enabled
+#undef mt32emu_set_partial_culling_threshold
+#undef mt32emu_get_partial_culling_threshold
+#undef mt32emu_get_culled_partial_sample_count
+#undef mt32emu_set_low_latency_rendering_enabled
+#undef mt32emu_is_low_latency_rendering_enabled
 #undef mt32emu_render_bit16s
 #undef mt32emu_render_float
 #undef mt32emu_render_bit16s_streams
@@ -574,6 +656,11 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 #undef mt32emu_has_active_partials
 #undef mt32emu_is_active
 #undef mt32emu_get_partial_count
+#undef mt32emu_set_partial_limit
+#undef mt32emu_get_partial_limit
+#undef mt32emu_set_cpu_budget
+#undef mt32emu_get_cpu_budget
+#undef mt32emu_report_render_load
 #undef mt32emu_get_part_states
 #undef mt32emu_get_partial_states
 #undef mt32emu_get_playing_notes
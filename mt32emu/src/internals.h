@@ -87,12 +87,49 @@
 #define MT32EMU_BOSS_REVERB_PRECISE_MODE 0
 #endif
 
+// Hints the CPU to fetch the memory at the address into the cache. No-op where unsupported by the compiler.
+#if defined(__GNUC__) || defined(__clang__)
+#define MT32EMU_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define MT32EMU_PREFETCH(address)
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 namespace MT32Emu {
 
 typedef Bit16s IntSample;
 typedef Bit32s IntSampleEx;
 typedef float FloatSample;
 
+// Loads a 32-bit value shared with another thread, such that memory operations that follow in program order
+// cannot be reordered before the load. Pairs with atomicStoreRelease() in lock-free single-producer / single-consumer
+// queues: the consumer observes the data published by the producer once it observes the updated position.
+static inline Bit32u atomicLoadAcquire(const volatile Bit32u &value) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+	// A locked no-op acts as a full memory barrier on any architecture MSVC targets.
+	return Bit32u(_InterlockedCompareExchange((volatile long *)&value, 0, 0));
+#else
+	return value;
+#endif
+}
+
+// Stores a 32-bit value shared with another thread, such that memory operations that precede in program order
+// cannot be reordered after the store.
+static inline void atomicStoreRelease(volatile Bit32u &value, Bit32u newValue) {
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(&value, newValue, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+	_InterlockedExchange((volatile long *)&value, long(newValue));
+#else
+	value = newValue;
+#endif
+}
+
 enum PolyState {
 	POLY_Playing,
 	POLY_Held, // This marks keys that have been released on the keyboard, but are being held by the pedal
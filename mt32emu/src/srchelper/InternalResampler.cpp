@@ -20,6 +20,7 @@
 #include "srctools/include/ResamplerModel.h"
 
 #include "../Synth.h"
+#include "../SampleRateConverter.h"
 
 using namespace SRCTools;
 
@@ -37,6 +38,23 @@ public:
 	}
 };
 
+class SynthOutputSourceWrapper : public FloatSampleProvider {
+	SynthOutputSource &synthOutputSource;
+
+public:
+	SynthOutputSourceWrapper(SynthOutputSource &useSynthOutputSource) : synthOutputSource(useSynthOutputSource)
+	{}
+
+	void getOutputSamples(FloatSample *outBuffer, unsigned int size) {
+		synthOutputSource.getSynthOutputSamples(outBuffer, size);
+	}
+};
+
+static FloatSampleProvider &createSynthSource(Synth &synth, SynthOutputSource *synthOutputSource) {
+	if (synthOutputSource != NULL) return *new SynthOutputSourceWrapper(*synthOutputSource);
+	return *new SynthWrapper(synth);
+}
+
 static FloatSampleProvider &createModel(Synth &synth, SRCTools::FloatSampleProvider &synthSource, double targetSampleRate, SamplerateConversionQuality quality) {
 	static const double MAX_AUDIBLE_FREQUENCY = 20000.0;
 
@@ -59,8 +77,8 @@ static FloatSampleProvider &createModel(Synth &synth, SRCTools::FloatSampleProvi
 
 using namespace MT32Emu;
 
-InternalResampler::InternalResampler(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality) :
-	synthSource(*new SynthWrapper(synth)),
+InternalResampler::InternalResampler(Synth &synth, SynthOutputSource *synthOutputSource, double targetSampleRate, SamplerateConversionQuality quality) :
+	synthSource(createSynthSource(synth, synthOutputSource)),
 	model(createModel(synth, synthSource, targetSampleRate, quality))
 {}
 
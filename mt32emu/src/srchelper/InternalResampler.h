@@ -24,10 +24,11 @@
 namespace MT32Emu {
 
 class Synth;
+class SynthOutputSource;
 
 class InternalResampler {
 public:
-	InternalResampler(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality);
+	InternalResampler(Synth &synth, SynthOutputSource *synthOutputSource, double targetSampleRate, SamplerateConversionQuality quality);
 	~InternalResampler();
 
 	void getOutputSamples(float *buffer, unsigned int length);
@@ -17,6 +17,7 @@
 #include "SamplerateAdapter.h"
 
 #include "../Synth.h"
+#include "../SampleRateConverter.h"
 
 using namespace MT32Emu;
 
@@ -25,14 +26,19 @@ static const unsigned int CHANNEL_COUNT = 2;
 long SamplerateAdapter::getInputSamples(void *cb_data, float **data) {
 	SamplerateAdapter *instance = static_cast<SamplerateAdapter *>(cb_data);
 	unsigned int length = instance->inBufferSize < 1 ? 1 : (MAX_SAMPLES_PER_RUN < instance->inBufferSize ? MAX_SAMPLES_PER_RUN : instance->inBufferSize);
-	instance->synth.render(instance->inBuffer, length);
+	if (instance->synthOutputSource != NULL) {
+		instance->synthOutputSource->getSynthOutputSamples(instance->inBuffer, length);
+	} else {
+		instance->synth.render(instance->inBuffer, length);
+	}
 	*data = instance->inBuffer;
 	instance->inBufferSize -= length;
 	return length;
 }
 
-SamplerateAdapter::SamplerateAdapter(Synth &useSynth, double targetSampleRate, SamplerateConversionQuality quality) :
+SamplerateAdapter::SamplerateAdapter(Synth &useSynth, SynthOutputSource *useSynthOutputSource, double targetSampleRate, SamplerateConversionQuality quality) :
 	synth(useSynth),
+	synthOutputSource(useSynthOutputSource),
 	inBuffer(new float[CHANNEL_COUNT * MAX_SAMPLES_PER_RUN]),
 	inBufferSize(MAX_SAMPLES_PER_RUN),
 	inputToOutputRatio(useSynth.getStereoOutputSampleRate() / targetSampleRate),
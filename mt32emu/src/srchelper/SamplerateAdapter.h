@@ -24,16 +24,18 @@
 namespace MT32Emu {
 
 class Synth;
+class SynthOutputSource;
 
 class SamplerateAdapter {
 public:
-	SamplerateAdapter(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality);
+	SamplerateAdapter(Synth &synth, SynthOutputSource *synthOutputSource, double targetSampleRate, SamplerateConversionQuality quality);
 	~SamplerateAdapter();
 
 	void getOutputSamples(float *outBuffer, unsigned int length);
 
 private:
 	Synth &synth;
+	SynthOutputSource * const synthOutputSource;
 	float * const inBuffer;
 	unsigned int inBufferSize;
 	const double inputToOutputRatio;
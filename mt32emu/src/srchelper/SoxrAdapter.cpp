@@ -17,6 +17,7 @@
 #include "SoxrAdapter.h"
 
 #include "../Synth.h"
+#include "../SampleRateConverter.h"
 
 using namespace MT32Emu;
 
@@ -25,13 +26,18 @@ static const unsigned int CHANNEL_COUNT = 2;
 size_t SoxrAdapter::getInputSamples(void *input_fn_state, soxr_in_t *data, size_t requested_len) {
 	unsigned int length = requested_len < 1 ? 1 : (MAX_SAMPLES_PER_RUN < requested_len ? MAX_SAMPLES_PER_RUN : static_cast<unsigned int>(requested_len));
 	SoxrAdapter *instance = static_cast<SoxrAdapter *>(input_fn_state);
-	instance->synth.render(instance->inBuffer, length);
+	if (instance->synthOutputSource != NULL) {
+		instance->synthOutputSource->getSynthOutputSamples(instance->inBuffer, length);
+	} else {
+		instance->synth.render(instance->inBuffer, length);
+	}
 	*data = instance->inBuffer;
 	return length;
 }
 
-SoxrAdapter::SoxrAdapter(Synth &useSynth, double targetSampleRate, SamplerateConversionQuality quality) :
+SoxrAdapter::SoxrAdapter(Synth &useSynth, SynthOutputSource *useSynthOutputSource, double targetSampleRate, SamplerateConversionQuality quality) :
 	synth(useSynth),
+	synthOutputSource(useSynthOutputSource),
 	inBuffer(new float[CHANNEL_COUNT * MAX_SAMPLES_PER_RUN])
 {
 	soxr_io_spec_t ioSpec = soxr_io_spec(SOXR_FLOAT32_I, SOXR_FLOAT32_I);
@@ -24,16 +24,18 @@
 namespace MT32Emu {
 
 class Synth;
+class SynthOutputSource;
 
 class SoxrAdapter {
 public:
-	SoxrAdapter(Synth &synth, double targetSampleRate, SamplerateConversionQuality quality);
+	SoxrAdapter(Synth &synth, SynthOutputSource *synthOutputSource, double targetSampleRate, SamplerateConversionQuality quality);
 	~SoxrAdapter();
 
 	void getOutputSamples(float *buffer, unsigned int length);
 
 private:
 	Synth &synth;
+	SynthOutputSource * const synthOutputSource;
 	float * const inBuffer;
 	soxr_t resampler;
 
@@ -628,19 +628,15 @@ static inline void get_msg(snd_seq_event_t *seq_ev, midiev_t *ev)
 	    case SND_SEQ_EVENT_REGPARAM:
 		// The real hardware units support only RPN 0 (pitch bender range) and only MSB matters
 		if (seq_ev->data.control.param == 0) {
-			unsigned int *msg_buffer = new unsigned int[3];
-			unsigned int msg = (0x0000B0 | seq_ev->data.control.channel);
-			msg_buffer[0] = msg | 0x006400;
-			msg_buffer[1] = msg | 0x006500;
-			msg_buffer[2] = msg | 0x000600 | ((seq_ev->data.control.value >> 7) & 0x7F) << 16;
+			/* The triplet of control changes is only expanded when played, to avoid allocating a buffer here */
+			ev->msg = 0x0000B0 | seq_ev->data.control.channel;
+			ev->msg |= ((seq_ev->data.control.value >> 7) & 0x7F) << 16;
 
 			debug_msg("RPN: channel:%d param:%d value:%d\n",
 				   seq_ev->data.control.channel, seq_ev->data.control.param,
 				   seq_ev->data.control.value);
 
 			ev->type = EVENT_MIDI_TRIPLET;
-			ev->sysex_len = 3 * sizeof(unsigned int);
-			ev->sysex = msg_buffer;
 		} else {
 			ev->type = EVENT_NONE;
 		}
@@ -1164,11 +1160,11 @@ int process_loop(int rv)
 			break;
 			
 		    case EVENT_MIDI_TRIPLET: {
-			unsigned int *msg_buffer = (unsigned int *)newev.sysex;
-			for(int i = 0; i < 3; i++) {
-				mt32->playMsg(msg_buffer[i]);
-			}
-			delete[] msg_buffer;
+			/* RPN 0 MSB, RPN 0 LSB, Data Entry MSB with the value */
+			unsigned int status = newev.msg & 0xFF;
+			mt32->playMsg(status | 0x006400);
+			mt32->playMsg(status | 0x006500);
+			mt32->playMsg(newev.msg | 0x000600);
 			break;
 		    }
 
@@ -226,14 +226,14 @@ void AudioFileRenderer::run() {
 		return;
 	}
 	MasterClockNanos startNanos = MasterClock::getClockNanos();
-	MasterClockNanos firstSampleNanos = 0;
+	quint64 renderedFrames = 0;
 	MasterClockNanos midiTick = 0;
 	MasterClockNanos midiNanos = 0;
 	QMidiEventList midiEvents;
 	int midiEventIx = 0;
 	uint parserIx = 0;
 	if (realtimeMode) {
-		firstSampleNanos = startNanos;
+		startNanos = audioRenderer.audioStream->getStartNanos();
 	} else {
 		midiEvents = parsers[parserIx].getMIDIEvents();
 		midiTick = parsers[parserIx].getMidiTick();
@@ -242,24 +242,23 @@ void AudioFileRenderer::run() {
 	while (!stopProcessing) {
 		uint frameCount = 0;
 		if (realtimeMode) {
-			frameCount = uint((sampleRate * (MasterClock::getClockNanos() - firstSampleNanos)) / MasterClock::NANOS_PER_SECOND);
-			if (frameCount < bufferSize) {
-				usleep(ulong((MasterClock::MICROS_PER_SECOND * (bufferSize - frameCount)) / sampleRate));
-				continue;
-			} else {
-				frameCount = bufferSize;
-			}
+			// Deadlines are computed from the total number of frames rendered, so that no timing error accumulates.
+			// If the thread falls behind, the missed blocks are rendered without sleeping.
+			MasterClock::sleepUntilClockNanos(startNanos + MasterClock::framesToNanos(renderedFrames + bufferSize, sampleRate));
+			if (stopProcessing) break;
+			frameCount = bufferSize;
 		} else {
 			while (midiEventIx < midiEvents.count()) {
 				const QMidiEvent &e = midiEvents.at(midiEventIx);
 				bool eventPushed = true;
 				MasterClockNanos nextEventNanos = midiNanos + e.getTimestamp() * midiTick;
-				quint32 nextEventFrames = quint32(((double)sampleRate * nextEventNanos) / MasterClock::NANOS_PER_SECOND);
-				frameCount = uint((sampleRate * (nextEventNanos - firstSampleNanos)) / MasterClock::NANOS_PER_SECOND);
-				if (bufferSize < frameCount) {
+				quint64 nextEventFrames = MasterClock::nanosToFrames(nextEventNanos, sampleRate);
+				quint64 framesToNextEvent = nextEventFrames > renderedFrames ? nextEventFrames - renderedFrames : 0;
+				if (bufferSize < framesToNextEvent) {
 					frameCount = bufferSize;
 					break;
 				}
+				frameCount = uint(framesToNextEvent);
 				switch (e.getType()) {
 					case SHORT_MESSAGE:
 						eventPushed = audioRenderer.synth->playMIDIShortMessage(e.getShortMessage(), nextEventFrames);
@@ -303,9 +302,9 @@ void AudioFileRenderer::run() {
 				emit conversionFinished();
 				return;
 			}
-			firstSampleNanos += MasterClock::NANOS_PER_SECOND * framesToRender / sampleRate;
+			renderedFrames += framesToRender;
 			frameCount -= framesToRender;
-			if (!realtimeMode) qDebug() << "AudioFileWriter: Rendering time:" << (double)firstSampleNanos / MasterClock::NANOS_PER_SECOND;
+			if (!realtimeMode) qDebug() << "AudioFileWriter: Rendering time:" << (double)renderedFrames / sampleRate;
 		}
 	}
 	qDebug() << "AudioFileRenderer: Rendering finished";
@@ -154,9 +154,15 @@ quint32 JACKClient::getFramesSinceCycleStart() const {
 
 void JACKClient::process(jack_nframes_t nframes) {
 	if (midiSession != NULL) {
-		quint32 cycleStartFrameTime = audioStream != NULL ? 0 : jack_last_frame_time(client);
-		jack_time_t jackTimeNow = audioStream != NULL ? 0 : jack_get_time();
-		MasterClockNanos nanosNow = audioStream != NULL ? 0 : MasterClock::getClockNanos();
+		quint32 cycleStartFrameTime = 0;
+		MasterClockNanos nanosNow = 0;
+		if (audioStream == NULL) {
+			cycleStartFrameTime = jack_last_frame_time(client);
+			MasterClockNanos nanosBefore = MasterClock::getClockNanos();
+			jack_time_t jackTimeNow = jack_get_time();
+			nanosNow = MasterClock::getClockNanos();
+			clockSync.update(MasterClockNanos(jackTimeNow) * MasterClock::NANOS_PER_MICROSECOND, nanosBefore, nanosNow);
+		}
 		void *midiInBuffer = jack_port_get_buffer(midiInPort, nframes);
 		uint eventCount = uint(jack_midi_get_event_count(midiInBuffer));
 		for (uint eventIx = 0; eventIx < eventCount; eventIx++) {
@@ -170,7 +176,7 @@ void JACKClient::process(jack_nframes_t nframes) {
 			} else {
 				quint32 eventFrameTime = cycleStartFrameTime + eventData.time;
 				quint64 eventJackTime = jack_frames_to_time(client, eventFrameTime);
-				MasterClockNanos eventNanoTime = JACKMidiDriver::jackFrameTimeToMasterClockNanos(nanosNow, eventJackTime, jackTimeNow);
+				MasterClockNanos eventNanoTime = clockSync.toClockNanos(MasterClockNanos(eventJackTime) * MasterClock::NANOS_PER_MICROSECOND, nanosNow);
 				eventConsumed = JACKMidiDriver::pushMIDIMessage(midiSession, eventNanoTime, eventData.size, eventData.buffer);
 			}
 			if (!eventConsumed) break;
@@ -6,6 +6,8 @@
 #include <jack/jack.h>
 #include <jack/midiport.h>
 
+#include "MasterClock.h"
+
 enum JACKClientState {
 	JACKClientState_OPEN,
 	JACKClientState_CLOSING,
@@ -39,6 +41,7 @@ private:
 	jack_port_t *leftAudioOutPort;
 	jack_port_t *rightAudioOutPort;
 	quint32 bufferSize;
+	MasterClockSync clockSync;
 
 	static int onJACKProcess(jack_nframes_t nframes, void *instance);
 	static int onBufferSizeChange(jack_nframes_t newFrameSize, void *instance);
@@ -14,6 +14,8 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdio>
+
 #include <QSystemTrayIcon>
 #include <QDropEvent>
 #include <QMessageBox>
@@ -49,6 +51,7 @@
 #endif
 
 #include "audiodrv/AudioFileWriterDriver.h"
+#include "audiodrv/MixerAudioDriver.h"
 
 #ifdef WITH_WIN32_MIDI_DRIVER
 #include "mididrv/Win32Driver.h"
@@ -68,6 +71,20 @@ static const int ACTUAL_SETTINGS_VERSION = 2;
 
 static Master *instance = NULL;
 
+static QString htmlToPlainText(QString text) {
+	static const char * const BLOCK_END_TAGS[] = {"</h3>", "</pre>", "</p>", "</li>"};
+	for (uint i = 0; i < sizeof BLOCK_END_TAGS / sizeof *BLOCK_END_TAGS; i++) {
+		text.replace(BLOCK_END_TAGS[i], "\n", Qt::CaseInsensitive);
+	}
+	int tagStart;
+	while ((tagStart = text.indexOf('<')) != -1) {
+		int tagEnd = text.indexOf('>', tagStart);
+		if (tagEnd == -1) break;
+		text.remove(tagStart, tagEnd - tagStart + 1);
+	}
+	return text.replace("&lt;", "<").replace("&gt;", ">").replace("&amp;", "&");
+}
+
 static void migrateSettings(QSettings &settings, const int fromVersion) {
 	qDebug() << "Migrating settings from version" << fromVersion << "to version" << ACTUAL_SETTINGS_VERSION;
 	switch (fromVersion) {
@@ -77,14 +94,14 @@ static void migrateSettings(QSettings &settings, const int fromVersion) {
 		break;
 	default:
 		qDebug() << "Migration failed";
-		QMessageBox::warning(NULL, "Unsupported settings version",
+		Master::showWarning("Unsupported settings version",
 			"Unable to load application settings of unsupported version " + QString().setNum(fromVersion) + ".\n"
 			"Please, check the settings!");
 		break;
 	}
 }
 
-Master::Master() {
+Master::Master(bool useHeadless) {
 	if (instance != NULL) {
 		qFatal("Master already instantiated!");
 		// Do nothing if ignored
@@ -92,6 +109,7 @@ Master::Master() {
 	}
 	instance = this;
 	maxSessions = 0;
+	headless = useHeadless;
 
 	moveToThread(QCoreApplication::instance()->thread());
 
@@ -120,6 +138,9 @@ Master::Master() {
 	qRegisterMetaType<MidiSession *>("MidiSession*");
 	qRegisterMetaType<MidiSession **>("MidiSession**");
 	qRegisterMetaType<SynthState>("SynthState");
+
+	statusReportTimer.setInterval(1000 * settings->value("Master/headlessStatusInterval", 0).toInt());
+	connect(&statusReportTimer, SIGNAL(timeout()), SLOT(printStatusReport()));
 }
 
 Master::~Master() {
@@ -177,7 +198,8 @@ void Master::initAudioDrivers() {
 	audioDrivers.append(new PulseAudioDriver(this));
 #endif
 #ifdef WITH_JACK_AUDIO_DRIVER
-	audioDrivers.append(new JACKAudioDriver(this));
+	AudioDriver *jackAudioDriver = new JACKAudioDriver(this);
+	audioDrivers.append(jackAudioDriver);
 #endif
 #ifdef WITH_PORT_AUDIO_DRIVER
 	audioDrivers.append(new PortAudioDriver(this));
@@ -185,6 +207,12 @@ void Master::initAudioDrivers() {
 #ifdef WITH_QT_AUDIO_DRIVER
 	audioDrivers.append(new QtAudioDriver(this));
 #endif
+	QList<AudioDriver *> mixerTargetDrivers = audioDrivers;
+#ifdef WITH_JACK_AUDIO_DRIVER
+	// JACK server mixes the streams of its clients already.
+	mixerTargetDrivers.removeOne(jackAudioDriver);
+#endif
+	audioDrivers.append(new MixerAudioDriver(this, mixerTargetDrivers));
 	audioDrivers.append(new AudioFileWriterDriver(this));
 }
 
@@ -218,9 +246,42 @@ Master *Master::getInstance() {
 	return instance;
 }
 
+bool Master::isHeadlessModeRequested(int argv, char **args) {
+	for (int i = 1; i < argv; i++) {
+		if (qstricmp(args[i], "-headless") == 0) return true;
+	}
+	// The application object doesn't exist yet, so the settings location is specified explicitly.
+	return QSettings("muntemu.org", "Munt mt32emu-qt").value("Master/headless", false).toBool();
+}
+
+void Master::showInformation(const QString &title, const QString &text) {
+	if (instance != NULL && instance->headless) {
+		printf("%s: %s\n", qPrintable(title), qPrintable(htmlToPlainText(text)));
+		fflush(stdout);
+		return;
+	}
+	QMessageBox::information(NULL, title, text);
+}
+
+void Master::showWarning(const QString &title, const QString &text) {
+	if (instance != NULL && instance->headless) {
+		qWarning("%s: %s", qPrintable(title), qPrintable(htmlToPlainText(text)));
+		return;
+	}
+	QMessageBox::warning(NULL, title, text);
+}
+
+void Master::showCritical(const QString &title, const QString &text) {
+	if (instance != NULL && instance->headless) {
+		qCritical("%s: %s", qPrintable(title), qPrintable(htmlToPlainText(text)));
+		return;
+	}
+	QMessageBox::critical(NULL, title, text);
+}
+
 void Master::showCommandLineHelp() {
 	QString appName = QFileInfo(QCoreApplication::arguments().at(0)).fileName();
-	QMessageBox::information(NULL, "Information",
+	showInformation("Information",
 		"<h3>Command line format:</h3>"
 		"<pre><code>" + appName + " [option...] [&lt;command&gt; [parameters...]]</code></pre>"
 		"<h3>Options:</h3>"
@@ -228,6 +289,11 @@ void Master::showCommandLineHelp() {
 		"<p>override default synth profile with specified profile during this run only.</p>"
 		"<p><code>-max_sessions &lt;number of sessions&gt;</code></p>"
 		"<p>exit after this number of MIDI sessions are finished.</p>"
+		"<p><code>-headless</code></p>"
+		"<p>run as a background service without GUI. Synths are started on demand by MIDI sessions, messages are printed"
+		" to the console. This mode can also be enabled permanently with the Master/headless setting.</p>"
+		"<p><code>-status_interval &lt;seconds&gt;</code></p>"
+		"<p>in headless mode, print the state of running synths to the console periodically.</p>"
 #ifdef WITH_JACK_MIDI_DRIVER
 		"<p><code>-jack_midi_clients &lt;number of MIDI ports&gt;</code></p>"
 		"<p>create the specified number of JACK MIDI ports that may be connected to any synth.</p>"
@@ -262,6 +328,10 @@ bool Master::processCommandLine(QStringList args) {
 			handleCLIOptionProfile(args, argIx);
 		} else if (QString::compare(command, "-max_sessions", Qt::CaseInsensitive) == 0) {
 			handleCLIOptionMaxSessions(args, argIx);
+		} else if (QString::compare(command, "-headless", Qt::CaseInsensitive) == 0) {
+			// Already handled at startup.
+		} else if (QString::compare(command, "-status_interval", Qt::CaseInsensitive) == 0) {
+			handleCLIOptionStatusInterval(args, argIx);
 #ifdef WITH_JACK_MIDI_DRIVER
 		} else if (QString::compare(command, "-jack_midi_clients", Qt::CaseInsensitive) == 0) {
 			handleCLIOptionJackMidiClients(args, argIx);
@@ -269,7 +339,7 @@ bool Master::processCommandLine(QStringList args) {
 			handleCLIOptionJackSyncClients(args, argIx);
 #endif
 		} else {
-			QMessageBox::warning(NULL, "Error", "Illegal command line option " + command + " specified.");
+			showWarning("Error", "Illegal command line option " + command + " specified.");
 			showCommandLineHelp();
 		}
 		if (args.count() == argIx) return true;
@@ -284,7 +354,7 @@ bool Master::processCommandLine(QStringList args) {
 	} else if (QString::compare(command, "connect_midi", Qt::CaseInsensitive) == 0) {
 		handleCLIConnectMidi(args, argIx);
 	} else {
-		QMessageBox::warning(NULL, "Error", "Illegal command " + command + " specified in command line.");
+		showWarning("Error", "Illegal command " + command + " specified in command line.");
 		showCommandLineHelp();
 	}
 	return true;
@@ -292,7 +362,7 @@ bool Master::processCommandLine(QStringList args) {
 
 void Master::handleCLIOptionProfile(const QStringList &args, int &argIx) {
 	if (args.count() == argIx) {
-		QMessageBox::warning(NULL, "Error", "The profile name must be specified in command line with \"-profile\" option.");
+		showWarning("Error", "The profile name must be specified in command line with \"-profile\" option.");
 		showCommandLineHelp();
 		return;
 	}
@@ -300,39 +370,55 @@ void Master::handleCLIOptionProfile(const QStringList &args, int &argIx) {
 	if (enumSynthProfiles().contains(profile, Qt::CaseInsensitive)) {
 		synthProfileName = profile;
 	} else {
-		QMessageBox::warning(NULL, "Error", "The profile name specified in command line is invalid.\nOption \"-profile\" ignored.");
+		showWarning("Error", "The profile name specified in command line is invalid.\nOption \"-profile\" ignored.");
 	}
 }
 
 void Master::handleCLIOptionMaxSessions(const QStringList &args, int &argIx) {
 	if (args.count() == argIx) {
-		QMessageBox::warning(NULL, "Error", "The maximum number of sessions must be specified in command line\n"
+		showWarning("Error", "The maximum number of sessions must be specified in command line\n"
 			"with \"-max_sessions\" option.");
 		showCommandLineHelp();
 		return;
 	}
 	maxSessions = args.at(argIx++).toUInt();
-	if (maxSessions == 0) QMessageBox::warning(NULL, "Error", "The maximum number of sessions specified in command line is invalid.\n"
+	if (maxSessions == 0) showWarning("Error", "The maximum number of sessions specified in command line is invalid.\n"
 		"Option \"-max_sessions\" ignored.");
 }
 
+void Master::handleCLIOptionStatusInterval(const QStringList &args, int &argIx) {
+	if (args.count() == argIx) {
+		showWarning("Error", "The status report interval must be specified in command line\n"
+			"with \"-status_interval\" option.");
+		showCommandLineHelp();
+		return;
+	}
+	int interval = args.at(argIx++).toInt();
+	if (interval <= 0) {
+		showWarning("Error", "The status report interval specified in command line is invalid.\n"
+			"Option \"-status_interval\" ignored.");
+		return;
+	}
+	statusReportTimer.setInterval(1000 * interval);
+}
+
 #ifdef WITH_JACK_MIDI_DRIVER
 
 void Master::handleCLIOptionJackMidiClients(const QStringList &args, int &argIx) {
 	if (args.count() == argIx) {
-		QMessageBox::warning(NULL, "Error", "The number of JACK MIDI clients must be specified in command line\n"
+		showWarning("Error", "The number of JACK MIDI clients must be specified in command line\n"
 			"with \"-jack_midi_clients\" option.");
 		showCommandLineHelp();
 		return;
 	}
 	int ports = args.at(argIx++).toInt();
 	if (ports <= 0) {
-		QMessageBox::warning(NULL, "Error", "The number of JACK MIDI clients specified in command line is invalid.\n"
+		showWarning("Error", "The number of JACK MIDI clients specified in command line is invalid.\n"
 			"Option \"-jack_midi_clients\" ignored.");
 		return;
 	}
 	if (ports > 99) {
-		QMessageBox::warning(NULL, "Error", "The number of JACK MIDI clients specified in command line is too big.\n"
+		showWarning("Error", "The number of JACK MIDI clients specified in command line is too big.\n"
 			"Option \"-jack_midi_clients\" ignored.");
 		return;
 	}
@@ -342,19 +428,19 @@ void Master::handleCLIOptionJackMidiClients(const QStringList &args, int &argIx)
 
 void Master::handleCLIOptionJackSyncClients(const QStringList &args, int &argIx) {
 	if (args.count() == argIx) {
-		QMessageBox::warning(NULL, "Error", "The number of JACK sync clients must be specified in command line\n"
+		showWarning("Error", "The number of JACK sync clients must be specified in command line\n"
 			"with \"-jack_sync_clients\" option.");
 		showCommandLineHelp();
 		return;
 	}
 	int ports = args.at(argIx++).toInt();
 	if (ports <= 0) {
-		QMessageBox::warning(NULL, "Error", "The number of JACK sync clients specified in command line is invalid.\n"
+		showWarning("Error", "The number of JACK sync clients specified in command line is invalid.\n"
 			"Option \"-jack_sync_clients\" ignored.");
 		return;
 	}
 	if (ports > 99) {
-		QMessageBox::warning(NULL, "Error", "The number of JACK sync clients specified in command line is too big.\n"
+		showWarning("Error", "The number of JACK sync clients specified in command line is too big.\n"
 			"Option \"-jack_sync_clients\" ignored.");
 		return;
 	}
@@ -364,8 +450,12 @@ void Master::handleCLIOptionJackSyncClients(const QStringList &args, int &argIx)
 #endif
 
 void Master::handleCLICommandPlay(const QStringList &args, int &argIx) {
+	if (headless) {
+		showWarning("Error", "The play command is not supported in headless mode.");
+		return;
+	}
 	if (args.count() == argIx) {
-		QMessageBox::warning(NULL, "Error", "The file list must be specified in command line with play command.");
+		showWarning("Error", "The file list must be specified in command line with play command.");
 		showCommandLineHelp();
 		return;
 	}
@@ -373,17 +463,21 @@ void Master::handleCLICommandPlay(const QStringList &args, int &argIx) {
 }
 
 void Master::handleCLICommandConvert(const QStringList &args, int &argIx) {
+	if (headless) {
+		showWarning("Error", "The convert command is not supported in headless mode.");
+		return;
+	}
 	if (args.count() > (argIx + 1)) {
 		emit convertMidiFiles(args.mid(argIx));
 		return;
 	}
-	QMessageBox::warning(NULL, "Error", "The file list must be specified in command line with convert command.");
+	showWarning("Error", "The file list must be specified in command line with convert command.");
 	showCommandLineHelp();
 }
 
 bool Master::handleCLICommandReset(const QStringList &args, int &argIx) {
 	if (args.count() != (argIx + 1)) {
-		QMessageBox::warning(NULL, "Error", "The settings scope must be specified in command line with reset command.");
+		showWarning("Error", "The settings scope must be specified in command line with reset command.");
 		showCommandLineHelp();
 		return true;
 	}
@@ -405,24 +499,24 @@ bool Master::handleCLICommandReset(const QStringList &args, int &argIx) {
 		settings->remove("Audio");
 		qDebug() << "Audio devices settings reset";
 	} else {
-		QMessageBox::warning(NULL, "Error", "The settings scope specified in command line is invalid.\n"
+		showWarning("Error", "The settings scope specified in command line is invalid.\n"
 			"Command reset ignored.");
 		showCommandLineHelp();
 		return true;
 	}
-	QMessageBox::information(NULL, "Information", "Requested settings reset completed.\n"
+	showInformation("Information", "Requested settings reset completed.\n"
 		"Please, restart the application.");
 	return false;
 }
 
 void Master::handleCLIConnectMidi(const QStringList &args, int &argIx) {
 	if (args.count() == argIx) {
-		QMessageBox::warning(NULL, "Error", "The MIDI port list must be specified in command line with connect_midi command.");
+		showWarning("Error", "The MIDI port list must be specified in command line with connect_midi command.");
 		showCommandLineHelp();
 		return;
 	}
 	if (!midiDriver->canCreatePort()) {
-		QMessageBox::warning(NULL, "Error", "The MIDI driver does not support creation of MIDI ports.");
+		showWarning("Error", "The MIDI driver does not support creation of MIDI ports.");
 		return;
 	}
 
@@ -497,6 +591,16 @@ QSettings *Master::getSettings() const {
 	return settings;
 }
 
+bool Master::isHeadless() const {
+	return headless;
+}
+
+void Master::startStatusReporting() {
+	if (!headless || statusReportTimer.interval() <= 0) return;
+	printStatusReport();
+	statusReportTimer.start();
+}
+
 QString Master::getDefaultSynthProfileName() {
 	return synthProfileName;
 }
@@ -613,6 +717,8 @@ void Master::loadSynthProfile(SynthProfile &synthProfile, QString name) {
 	synthProfile.analogOutputMode = (MT32Emu::AnalogOutputMode)settings->value("analogOutputMode", MT32Emu::AnalogOutputMode_ACCURATE).toInt();
 	synthProfile.rendererType = (MT32Emu::RendererType)settings->value("rendererType", MT32Emu::RendererType_BIT16S).toInt();
 	synthProfile.partialCount = settings->value("partialCount", MT32Emu::DEFAULT_MAX_PARTIALS).toInt();
+	synthProfile.cpuBudget = settings->value("cpuBudget", 0).toInt();
+	synthProfile.pipelinedRendering = settings->value("pipelinedRendering", false).toBool();
 	synthProfile.reverbCompatibilityMode = (ReverbCompatibilityMode)settings->value("reverbCompatibilityMode", ReverbCompatibilityMode_DEFAULT).toInt();
 	synthProfile.reverbEnabled = settings->value("reverbEnabled", true).toBool();
 	synthProfile.reverbOverridden = settings->value("reverbOverridden", false).toBool();
@@ -648,6 +754,8 @@ void Master::storeSynthProfile(const SynthProfile &synthProfile, QString name) c
 	settings->setValue("analogOutputMode", synthProfile.analogOutputMode);
 	settings->setValue("rendererType", synthProfile.rendererType);
 	settings->setValue("partialCount", synthProfile.partialCount);
+	settings->setValue("cpuBudget", synthProfile.cpuBudget);
+	settings->setValue("pipelinedRendering", synthProfile.pipelinedRendering);
 	settings->setValue("reverbCompatibilityMode", synthProfile.reverbCompatibilityMode);
 	settings->setValue("reverbEnabled", synthProfile.reverbEnabled);
 	settings->setValue("reverbOverridden", synthProfile.reverbOverridden);
@@ -719,6 +827,24 @@ void Master::updateMainWindowTitleContribution(const QString &titleContribution)
 	emit mainWindowTitleUpdated(title);
 }
 
+void Master::printStatusReport() {
+	static const char * const STATE_NAMES[] = {"closed", "opening", "open", "closing"};
+	printf("Synth routes running: %i\n", synthRoutes.count());
+	for (int routeIx = 0; routeIx < synthRoutes.count(); routeIx++) {
+		const SynthRoute *synthRoute = synthRoutes.at(routeIx);
+		QVector<MT32Emu::PartialState> partialStates(synthRoute->getPartialCount());
+		synthRoute->getPartialStates(partialStates.data());
+		int activePartialCount = partialStates.count() - partialStates.count(MT32Emu::PartialState_INACTIVE);
+		char lcdText[21] = "";
+		synthRoute->getDisplayState(lcdText);
+		lcdText[20] = 0;
+		printf("  #%i: %s%s, MIDI sessions: %s, active partials: %i/%i, LCD: \"%s\"\n", routeIx + 1,
+			STATE_NAMES[synthRoute->getState()], synthRoute == pinnedSynthRoute ? " (pinned)" : "",
+			synthRoute->hasMIDISessions() ? "yes" : "no", activePartialCount, partialStates.count(), lcdText);
+	}
+	fflush(stdout);
+}
+
 void Master::createMidiSession(MidiSession **returnVal, MidiDriver *midiDriver, QString name) {
 	SynthRoute *synthRoute = startSynthRoute();
 	MidiSession *midiSession = new MidiSession(this, midiDriver, name, synthRoute);
@@ -34,7 +34,10 @@ private:
 
 	unsigned int maxSessions;
 
-	explicit Master();
+	bool headless;
+	QTimer statusReportTimer;
+
+	explicit Master(bool useHeadless = false);
 	explicit Master(Master &);
 	~Master();
 
@@ -50,6 +53,10 @@ public:
 	static QStringList parseMidiListFromPathName(const QString pathName);
 	static const QByteArray getROMPathNameLocal(const QDir &romDir, const QString romFileName);
 	static void showCommandLineHelp();
+	static bool isHeadlessModeRequested(int argv, char **args);
+	static void showInformation(const QString &title, const QString &text);
+	static void showWarning(const QString &title, const QString &text);
+	static void showCritical(const QString &title, const QString &text);
 
 	// May only be called from the application thread
 	const QList<const AudioDevice *> getAudioDevices();
@@ -65,6 +72,8 @@ public:
 	bool handleROMSLoadFailed(QString usedSynthProfileName);
 	QSystemTrayIcon *getTrayIcon() const;
 	QSettings *getSettings() const;
+	bool isHeadless() const;
+	void startStatusReporting();
 	bool isPinned(const SynthRoute *synthRoute) const;
 	void setPinned(SynthRoute *synthRoute);
 	void startPinnedSynthRoute();
@@ -72,6 +81,7 @@ public:
 	bool processCommandLine(const QStringList args);
 	void handleCLIOptionProfile(const QStringList &args, int &argIx);
 	void handleCLIOptionMaxSessions(const QStringList &args, int &argIx);
+	void handleCLIOptionStatusInterval(const QStringList &args, int &argIx);
 	void handleCLIOptionJackMidiClients(const QStringList &args, int &argIx);
 	void handleCLIOptionJackSyncClients(const QStringList &args, int &argIx);
 	void handleCLICommandPlay(const QStringList &args, int &argIx);
@@ -94,6 +104,7 @@ private slots:
 	void deleteMidiSession(MidiSession *midiSession);
 	void showBalloon(const QString &title, const QString &text);
 	void updateMainWindowTitleContribution(const QString &titleContribution);
+	void printStatusReport();
 
 signals:
 	void synthRouteAdded(SynthRoute *route, const AudioDevice *audioDevice, bool pinnable);
@@ -237,3 +237,37 @@ void MasterClock::cleanup() {
 #endif // (QT_VERSION < QT_VERSION_CHECK(4, 7, 0))
 
 #endif // defined WITH_POSIX_CLOCK_NANOSLEEP || defined WITH_WINMMTIMER
+
+// Readings that took longer than this were most probably interrupted and are too imprecise to use.
+static const MasterClockNanos MAX_SYNC_READING_NANOS = 200 * MasterClock::NANOS_PER_MICROSECOND;
+// Offset errors beyond this are considered a discontinuity of either clock rather than a drift, so the offset is reset.
+static const MasterClockNanos MAX_SYNC_OFFSET_ERROR_NANOS = 20 * MasterClock::NANOS_PER_MILLISECOND;
+// Only this fraction of the offset error found by a reading is applied to the estimation.
+static const MasterClockNanos SYNC_OFFSET_SMOOTHING_FACTOR = 16;
+
+MasterClockSync::MasterClockSync() {
+	reset();
+}
+
+void MasterClockSync::reset() {
+	synced = false;
+	offsetNanos = 0;
+}
+
+void MasterClockSync::update(MasterClockNanos externalNanos, MasterClockNanos clockNanosBefore, MasterClockNanos clockNanosAfter) {
+	MasterClockNanos readingNanos = clockNanosAfter - clockNanosBefore;
+	if (synced && readingNanos > MAX_SYNC_READING_NANOS) return;
+	MasterClockNanos measuredOffsetNanos = clockNanosBefore + readingNanos / 2 - externalNanos;
+	MasterClockNanos offsetErrorNanos = measuredOffsetNanos - offsetNanos;
+	if (!synced || qAbs(offsetErrorNanos) > MAX_SYNC_OFFSET_ERROR_NANOS) {
+		offsetNanos = measuredOffsetNanos;
+		synced = true;
+		return;
+	}
+	offsetNanos += offsetErrorNanos / SYNC_OFFSET_SMOOTHING_FACTOR;
+}
+
+MasterClockNanos MasterClockSync::toClockNanos(MasterClockNanos externalNanos, MasterClockNanos clockNanosNow) const {
+	if (!synced) return clockNanosNow;
+	return qMin(externalNanos + offsetNanos, clockNanosNow);
+}
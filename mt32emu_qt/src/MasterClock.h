@@ -19,9 +19,42 @@ public:
 	static void sleepUntilClockNanos(MasterClockNanos clockNanos);
 	static MasterClockNanos getClockNanos();
 
+	// Exact integer conversions between non-negative durations and frame counts, that don't overflow for many years of audio.
+	static quint64 nanosToFrames(MasterClockNanos nanos, quint32 sampleRate) {
+		return quint64(nanos / NANOS_PER_SECOND) * sampleRate + quint64((nanos % NANOS_PER_SECOND) * sampleRate / NANOS_PER_SECOND);
+	}
+
+	static MasterClockNanos framesToNanos(quint64 frames, quint32 sampleRate) {
+		return MasterClockNanos(frames / sampleRate) * NANOS_PER_SECOND + MasterClockNanos(frames % sampleRate) * NANOS_PER_SECOND / sampleRate;
+	}
+
 private:
 	static void init();
 	static void cleanup();
 };
 
+// Maps timestamps provided by an external clock (e.g. by a MIDI driver) to MasterClock time.
+// The offset between the clocks is estimated from simultaneous readings of both and smoothed over time,
+// so that the jitter of the readings is filtered out while the drift of the clocks is still followed.
+class MasterClockSync {
+public:
+	MasterClockSync();
+	void reset();
+
+	// Updates the offset estimation with a reading of the external clock taken between two readings of MasterClock.
+	void update(MasterClockNanos externalNanos, MasterClockNanos clockNanosBefore, MasterClockNanos clockNanosAfter);
+
+	// Returns MasterClock time that corresponds to the external timestamp, limited by clockNanosNow to ensure it isn't in the future.
+	// If the clocks aren't synchronised yet, clockNanosNow is returned.
+	MasterClockNanos toClockNanos(MasterClockNanos externalNanos, MasterClockNanos clockNanosNow) const;
+
+	bool isSynced() const {
+		return synced;
+	}
+
+private:
+	bool synced;
+	MasterClockNanos offsetNanos;
+};
+
 #endif
@@ -328,10 +328,12 @@ bool MidiParser::doParse() {
 
 bool MidiParser::parse(const QString fileName) {
 	midiEventList.clear();
+	timeIndex.clear();
 	file.setFileName(fileName);
 	file.open(QIODevice::ReadOnly);
 	bool parseResult = doParse();
 	file.close();
+	if (parseResult) timeIndex.build(*this);
 	return parseResult;
 }
 
@@ -355,6 +357,10 @@ MasterClockNanos MidiParser::getMidiTick(uint tempo) const {
 	}
 }
 
+const MidiEventTimeIndex *MidiParser::getTimeIndex() const {
+	return &timeIndex;
+}
+
 void MidiParser::addChannelsReset() {
 	for (quint8 i = 0; i < 16; i++) {
 		// All notes off
@@ -365,4 +371,5 @@ void MidiParser::addChannelsReset() {
 		msg = 0x79B0 | i;
 		midiEventList.newMidiEvent().assignShortMessage(0, msg);
 	}
+	timeIndex.build(*this);
 }
@@ -11,11 +11,13 @@ public:
 	const QString getStreamName() const;
 	const QMidiEventList &getMIDIEvents() const;
 	MasterClockNanos getMidiTick(uint tempo = DEFAULT_TEMPO) const;
+	const MidiEventTimeIndex *getTimeIndex() const;
 	void addChannelsReset();
 
 private:
 	QFile file;
 	QMidiEventList midiEventList;
+	MidiEventTimeIndex timeIndex;
 
 	unsigned int format;
 	unsigned int numberOfTracks;
@@ -18,6 +18,7 @@
 
 #include "MidiRecorder.h"
 
+#include "Master.h"
 #include "MidiEventLayout.h"
 #include "QAtomicHelper.h"
 #include "RealtimeLocker.h"
@@ -39,6 +40,7 @@ static const MasterClockNanos DEFAULT_NANOS_PER_QUARTER_NOTE = 500000000;
 
 static const uint DATA_CHUNK_SIZE = 32768;
 static const int DATA_CHUNK_ALLOCATION_PERIOD_MILLIS = 4000;
+static const unsigned long DATA_CHUNK_STREAMING_PERIOD_MILLIS = 2000;
 static const quint32 MESSAGE_DATA_ALIGNMENT = quint32(sizeof(MasterClockNanos));
 
 // A chunk of byte data. Chunks can be bound into a semi-lock-free linked list.
@@ -72,7 +74,36 @@ public:
 	}
 };
 
-MidiRecorder::MidiRecorder() : startNanos(), endNanos(), allocationTimer(this) {
+// Periodically encodes the completed chunks of recorded data to the temporary track files in the background.
+class MidiRecordingStreamer : public QThread {
+private:
+	MidiRecorder &midiRecorder;
+	QMutex stopMutex;
+	QWaitCondition stopCondition;
+	bool stopRequested;
+
+	void run() {
+		QMutexLocker stopLocker(&stopMutex);
+		while (!stopRequested) {
+			stopCondition.wait(&stopMutex, DATA_CHUNK_STREAMING_PERIOD_MILLIS);
+			if (!stopRequested) midiRecorder.streamCompletedChunks();
+		}
+	}
+
+public:
+	MidiRecordingStreamer(MidiRecorder &useMidiRecorder) : midiRecorder(useMidiRecorder), stopRequested() {}
+
+	void stop() {
+		{
+			QMutexLocker stopLocker(&stopMutex);
+			stopRequested = true;
+			stopCondition.wakeAll();
+		}
+		wait();
+	}
+};
+
+MidiRecorder::MidiRecorder() : startNanos(), endNanos(), midiTick(), division(), allocationTimer(this), streamer(), streamingFailed() {
 	allocationTimer.setInterval(DATA_CHUNK_ALLOCATION_PERIOD_MILLIS);
 	connect(&allocationTimer, SIGNAL(timeout()), SLOT(handleAllocationTimer()));
 }
@@ -83,13 +114,30 @@ MidiRecorder::~MidiRecorder() {
 
 void MidiRecorder::reset() {
 	status.fetchAndStoreOrdered(MidiRecorderStatus_EMPTY);
+	stopStreaming();
+	streamingFailed = false;
 	while (!midiTrackRecorders.isEmpty()) {
 		delete midiTrackRecorders.takeLast();
 	}
 	allocationTimer.stop();
 }
 
-void MidiRecorder::startRecording() {
+void MidiRecorder::startRecording(MasterClockNanos useMidiTick) {
+	// The track data is encoded while recording, so the timing resolution has to be known in advance.
+	division = uint(DEFAULT_NANOS_PER_QUARTER_NOTE / useMidiTick);
+
+	// Clamp division to fit to 16-bit signed integer
+	if (division > 32767) {
+		division = 32767;
+		useMidiTick = DEFAULT_NANOS_PER_QUARTER_NOTE / division;
+	}
+	midiTick = useMidiTick;
+
+	// Temporary files are created in the system temp directory by default, which may reside in RAM.
+	QString streamFileDir = Master::getInstance()->getSettings()->value("Master/midiRecordingTempDir").toString();
+	if (streamFileDir.isEmpty()) streamFileDir = QDir::tempPath();
+	streamFileTemplate = QDir(streamFileDir).filePath("mt32emu-qt-midi-recording-XXXXXX");
+
 	startNanos = MasterClock::getClockNanos();
 	if (!status.testAndSetOrdered(MidiRecorderStatus_EMPTY, MidiRecorderStatus_RECORDING)) {
 		qWarning() << "MidiRecorder: Attempted to start recording while was in status" << int(status) << "-> resetting";
@@ -97,6 +145,8 @@ void MidiRecorder::startRecording() {
 		return;
 	}
 	allocationTimer.start();
+	streamer = new MidiRecordingStreamer(*this);
+	streamer->start(QThread::LowPriority);
 }
 
 bool MidiRecorder::stopRecording() {
@@ -114,6 +164,7 @@ bool MidiRecorder::stopRecording() {
 
 	endNanos = MasterClock::getClockNanos();
 	allocationTimer.stop();
+	stopStreaming();
 	return newStatus == MidiRecorderStatus_HAS_DATA_PENDING_WRITE;
 }
 
@@ -131,11 +182,72 @@ bool MidiRecorder::hasPendingData() const {
 
 MidiTrackRecorder *MidiRecorder::addTrack() {
 	MidiTrackRecorder *midiTrackRecorder = new MidiTrackRecorder(*this);
+	QMutexLocker tracksLocker(&tracksMutex);
 	midiTrackRecorders << midiTrackRecorder;
 	return midiTrackRecorder;
 }
 
-bool MidiRecorder::saveSMF(QString fileName, MasterClockNanos midiTick) {
+void MidiRecorder::stopStreaming() {
+	if (streamer == NULL) return;
+	streamer->stop();
+	delete streamer;
+	streamer = NULL;
+}
+
+// Only called from the streamer thread.
+void MidiRecorder::streamCompletedChunks() {
+	QMutexLocker tracksLocker(&tracksMutex);
+	if (streamingFailed) return;
+	for (int i = 0; i < midiTrackRecorders.size(); i++) {
+		MidiTrackRecorder *midiTrackRecorder = midiTrackRecorders.at(i);
+		// Chunks preceding the current one are completed by the MIDI driver thread and no longer accessed there.
+		const DataChunk *currentChunk = QAtomicHelper::loadAcquire(midiTrackRecorder->currentChunk);
+		if (midiTrackRecorder->readChunk == currentChunk) continue;
+		if (!midiTrackRecorder->streamFile.isOpen()) {
+			midiTrackRecorder->streamFile.setFileTemplate(streamFileTemplate);
+			if (!midiTrackRecorder->streamFile.open()) {
+				// Recorded data simply remains in memory until saved.
+				qDebug() << "MidiRecorder: Failed to create temporary track file" << midiTrackRecorder->streamFile.errorString();
+				continue;
+			}
+		}
+		if (!streamTrack(midiTrackRecorder, currentChunk)) {
+			// The data streamed so far remains valid, the rest is kept in memory until saved.
+			qWarning() << "MidiRecorder: Failed to write temporary track file" << midiTrackRecorder->streamFile.fileName();
+			streamingFailed = true;
+			return;
+		}
+	}
+}
+
+// Encodes the completed chunks of a track to the temporary file and releases them, once the data is safely written.
+// On failure, the encoding state is rolled back, so that the events are encoded again from the chunks retained in memory.
+bool MidiRecorder::streamTrack(MidiTrackRecorder *midiTrackRecorder, const DataChunk *endChunk) {
+	DataChunk *readChunk = midiTrackRecorder->readChunk;
+	quint32 readPosition = midiTrackRecorder->readPosition;
+	quint32 eventTicks = midiTrackRecorder->eventTicks;
+	uint runningStatus = midiTrackRecorder->runningStatus;
+	quint32 eventsProcessed = midiTrackRecorder->eventsProcessed;
+	QTemporaryFile &streamFile = midiTrackRecorder->streamFile;
+	if (!writeEvents(streamFile, midiTrackRecorder, endChunk, 0) || !streamFile.flush()) {
+		midiTrackRecorder->readChunk = readChunk;
+		midiTrackRecorder->readPosition = readPosition;
+		midiTrackRecorder->eventTicks = eventTicks;
+		midiTrackRecorder->runningStatus = runningStatus;
+		midiTrackRecorder->eventsProcessed = eventsProcessed;
+		return false;
+	}
+	midiTrackRecorder->streamedLength = streamFile.pos();
+	while (midiTrackRecorder->firstChunk != midiTrackRecorder->readChunk) {
+		DataChunk *processedChunk = midiTrackRecorder->firstChunk;
+		midiTrackRecorder->firstChunk = processedChunk->getNextChunk();
+		processedChunk->setNextChunk(NULL);
+		delete processedChunk;
+	}
+	return true;
+}
+
+bool MidiRecorder::saveSMF(QString fileName) {
 	if (!hasPendingData()) {
 		qWarning() << "MidiRecorder: Attempted to save SMF while was in status" << int(status) << "-> resetting";
 		reset();
@@ -146,21 +258,12 @@ bool MidiRecorder::saveSMF(QString fileName, MasterClockNanos midiTick) {
 		reset();
 		return true;
 	}
-
-	uint division = uint(DEFAULT_NANOS_PER_QUARTER_NOTE / midiTick);
-
-	// Clamp division to fit to 16-bit signed integer
-	if (division > 32767) {
-		division = 32767;
-		midiTick = DEFAULT_NANOS_PER_QUARTER_NOTE / division;
-	}
-
 	QFile file(fileName);
 	if (!file.open(QIODevice::WriteOnly)) return false;
-	if (!writeHeader(file, midiTrackRecorders.size(), division)) return false;
+	if (!writeHeader(file, midiTrackRecorders.size())) return false;
 	while (!midiTrackRecorders.isEmpty()) {
 		MidiTrackRecorder *trackRecorder = midiTrackRecorders.takeFirst();
-		bool result = writeTrack(file, trackRecorder, midiTick);
+		bool result = writeTrack(file, trackRecorder);
 		delete trackRecorder;
 		if (!result) {
 			reset();
@@ -171,7 +274,7 @@ bool MidiRecorder::saveSMF(QString fileName, MasterClockNanos midiTick) {
 	return true;
 }
 
-bool MidiRecorder::writeHeader(QFile &file, const int numberOfTracks, uint division) {
+bool MidiRecorder::writeHeader(QFile &file, const int numberOfTracks) {
 	if (!writeFile(file, headerID, 8)) return false;
 	char header[6];
 	qToBigEndian<quint16>(numberOfTracks > 1 ? 1 : 0, (uchar *)&header[0]); // format
@@ -180,28 +283,51 @@ bool MidiRecorder::writeHeader(QFile &file, const int numberOfTracks, uint divis
 	return writeFile(file, header, 6);
 }
 
-bool MidiRecorder::writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder, const MasterClockNanos midiTick) {
+bool MidiRecorder::writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder) {
 	// Writing track header, we'll fill length field later
 	if (!writeFile(file, trackID, 4)) return false;
 	quint64 trackLenPos = file.pos();
 	quint32 trackLen = 0;
 	if (!writeFile(file, (char *)&trackLen, 4)) return false;
 
-	// Writing actual MIDI events
-	uint runningStatus = 0;
-	quint32 eventsProcessed = 0;
-	quint32 eventTicks = 0; // Number of ticks from start of track
-	uchar eventData[16]; // Buffer for single short event / sysex header
-	DataChunk *chunk = midiTrackRecorder->firstChunk;
+	// Writing actual MIDI events, starting with those streamed while recording
+	if (midiTrackRecorder->streamFile.isOpen() && !copyStreamedEvents(file, midiTrackRecorder)) return false;
 	DataChunk *lastChunk = QAtomicHelper::loadRelaxed(midiTrackRecorder->currentChunk);
-	quint32 readPosition = 0;
-	while (chunk != lastChunk || readPosition < midiTrackRecorder->writePosition) {
+	if (!writeEvents(file, midiTrackRecorder, lastChunk, midiTrackRecorder->writePosition)) return false;
+
+	// Writing end-of-track meta-event
+	uchar eventData[16];
+	uchar *data = eventData;
+	writeMessageTimestamp(data, midiTrackRecorder->eventTicks, endNanos);
+	qToLittleEndian<quint32>(0x002FFF, data);
+	data += 3;
+	if (!writeFile(file, (char *)eventData, data - eventData)) return false;
+
+	// Writing track length
+	quint64 trackEndPos = file.pos();
+	trackLen = quint32(trackEndPos - trackLenPos - 4);
+	qToBigEndian<quint32>(trackLen, eventData);
+	file.seek(trackLenPos);
+	if (!writeFile(file, (char *)eventData, 4)) return false;
+	file.seek(trackEndPos);
+	qDebug() << "MidiRecorder: Processed" << midiTrackRecorder->eventsProcessed << "MIDI events, written" << trackLen << "bytes";
+	return true;
+}
+
+// Encodes the recorded events of a track up to the specified position, continuing from where the previous call ended.
+bool MidiRecorder::writeEvents(QFile &file, MidiTrackRecorder *midiTrackRecorder, const DataChunk *endChunk, const quint32 endPosition) {
+	uchar eventData[16]; // Buffer for single short event / sysex header
+	DataChunk *&chunk = midiTrackRecorder->readChunk;
+	quint32 &readPosition = midiTrackRecorder->readPosition;
+	uint &runningStatus = midiTrackRecorder->runningStatus;
+	while (chunk != endChunk || readPosition < endPosition) {
 		const uchar *readBuffer = chunk->getByteBuffer() + readPosition;
 		const MidiEventHeader *eventHeader = reinterpret_cast<const MidiEventHeader *>(readBuffer);
 		if (eventHeader->eventType == MidiEventLayout::MidiEventType_PAD) {
+			DataChunk *nextChunk = chunk->getNextChunk();
+			if (nextChunk == NULL) break;
 			readPosition = 0;
-			chunk = chunk->getNextChunk();
-			if (chunk == NULL) break;
+			chunk = nextChunk;
 			continue;
 		}
 
@@ -217,7 +343,7 @@ bool MidiRecorder::writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder,
 				qDebug() << "MidiRecorder: wrong sysex skipped at:" << (sysexMessageHeader->timestamp - startNanos) * 1e-6 << "millis, length:" << sysexLength;
 				continue;
 			}
-			writeMessageTimestamp(data, eventTicks, sysexMessageHeader->timestamp, midiTick);
+			writeMessageTimestamp(data, midiTrackRecorder->eventTicks, sysexMessageHeader->timestamp);
 			*(data++) = sysexData[0];
 			writeVarLenInt(data, sysexLength - 1);
 			if (!writeFile(file, (char *)eventData, data - eventData)) return false;
@@ -234,7 +360,7 @@ bool MidiRecorder::writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder,
 				qDebug() << "MidiRecorder: unsupported System message skipped at:" << (shortMessageEntry->timestamp - startNanos) * 1e-6 << "millis, code:" << newStatus;
 				continue;
 			}
-			writeMessageTimestamp(data, eventTicks, shortMessageEntry->timestamp, midiTick);
+			writeMessageTimestamp(data, midiTrackRecorder->eventTicks, shortMessageEntry->timestamp);
 			if (newStatus == runningStatus) {
 				message >>= 8;
 				if ((newStatus & 0xE0) == 0xC0) {
@@ -259,24 +385,21 @@ bool MidiRecorder::writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder,
 			}
 			if (!writeFile(file, (char *)eventData, data - eventData)) return false;
 		}
-		eventsProcessed++;
+		midiTrackRecorder->eventsProcessed++;
 	}
+	return true;
+}
 
-	// Writing end-of-track meta-event
-	uchar *data = eventData;
-	writeMessageTimestamp(data, eventTicks, endNanos, midiTick);
-	qToLittleEndian<quint32>(0x002FFF, data);
-	data += 3;
-	if (!writeFile(file, (char *)eventData, data - eventData)) return false;
-
-	// Writing track length
-	quint64 trackEndPos = file.pos();
-	trackLen = quint32(trackEndPos - trackLenPos - 4);
-	qToBigEndian<quint32>(trackLen, eventData);
-	file.seek(trackLenPos);
-	if (!writeFile(file, (char *)eventData, 4)) return false;
-	file.seek(trackEndPos);
-	qDebug() << "MidiRecorder: Processed" << eventsProcessed << "MIDI events, written" << trackLen << "bytes";
+// Only copies the data written successfully, anything after that is encoded again from the chunks retained in memory.
+bool MidiRecorder::copyStreamedEvents(QFile &file, MidiTrackRecorder *midiTrackRecorder) {
+	QTemporaryFile &streamFile = midiTrackRecorder->streamFile;
+	if (!streamFile.seek(0)) return false;
+	qint64 remainingLength = midiTrackRecorder->streamedLength;
+	while (remainingLength > 0) {
+		QByteArray block = streamFile.read(qMin(remainingLength, qint64(DATA_CHUNK_SIZE)));
+		if (block.isEmpty() || !writeFile(file, block.constData(), block.size())) return false;
+		remainingLength -= block.size();
+	}
 	return true;
 }
 
@@ -287,7 +410,7 @@ bool MidiRecorder::writeFile(QFile &file, const char *data, qint64 len) {
 	return false;
 }
 
-void MidiRecorder::writeMessageTimestamp(uchar * &data, quint32 &lastEventTicks, const MasterClockNanos timestamp, const MasterClockNanos midiTick) {
+void MidiRecorder::writeMessageTimestamp(uchar * &data, quint32 &lastEventTicks, const MasterClockNanos timestamp) {
 	quint32 thisEventTicks = qMax(quint32((timestamp - startNanos) / midiTick), lastEventTicks);
 	quint32 deltaTicks = thisEventTicks - lastEventTicks;
 	lastEventTicks = thisEventTicks;
@@ -329,7 +452,13 @@ MidiTrackRecorder::MidiTrackRecorder(MidiRecorder &useMidiRecorder) :
 	midiRecorder(useMidiRecorder),
 	firstChunk(new DataChunk(DATA_CHUNK_SIZE)),
 	currentChunk(firstChunk),
-	writePosition()
+	writePosition(),
+	streamedLength(),
+	readChunk(firstChunk),
+	readPosition(),
+	eventTicks(),
+	runningStatus(),
+	eventsProcessed()
 {}
 
 MidiTrackRecorder::~MidiTrackRecorder() {
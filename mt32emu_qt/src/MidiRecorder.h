@@ -7,15 +7,18 @@
 
 class DataChunk;
 class MidiTrackRecorder;
+class MidiRecordingStreamer;
 
 class MidiRecorder : public QObject {
 	Q_OBJECT
+friend class MidiRecordingStreamer;
+
 public:
 	MidiRecorder();
 	~MidiRecorder();
 
 	void reset();
-	void startRecording();
+	void startRecording(MasterClockNanos midiTick);
 	bool stopRecording();
 	bool isEmpty() const;
 	bool isRecording() const;
@@ -23,20 +26,32 @@ public:
 
 	// Methods below are only invoked from the main thread.
 	MidiTrackRecorder *addTrack();
-	bool saveSMF(QString fileName, MasterClockNanos midiTick);
+	bool saveSMF(QString fileName);
 
 private:
 	QAtomicInt status;
 
-	// Fields below are only accessed from the main thread.
-	MasterClockNanos startNanos, endNanos;
-	QList<MidiTrackRecorder *> midiTrackRecorders;
+	// Fields below are only modified from the main thread.
+	MasterClockNanos startNanos, endNanos, midiTick;
+	uint division;
 	QTimer allocationTimer;
+	MidiRecordingStreamer *streamer;
+	QString streamFileTemplate;
 
-	bool writeHeader(QFile &file, const int numberOfTracks, uint division);
-	bool writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder, const MasterClockNanos midiTick);
+	// Protects the list of track recorders and their encoding state against concurrent access from the streamer thread.
+	QMutex tracksMutex;
+	QList<MidiTrackRecorder *> midiTrackRecorders;
+	bool streamingFailed;
+
+	void stopStreaming();
+	void streamCompletedChunks();
+	bool streamTrack(MidiTrackRecorder *midiTrackRecorder, const DataChunk *endChunk);
+	bool writeHeader(QFile &file, const int numberOfTracks);
+	bool writeTrack(QFile &file, MidiTrackRecorder *midiTrackRecorder);
+	bool writeEvents(QFile &file, MidiTrackRecorder *midiTrackRecorder, const DataChunk *endChunk, const quint32 endPosition);
+	bool copyStreamedEvents(QFile &file, MidiTrackRecorder *midiTrackRecorder);
 	bool writeFile(QFile &file, const char *data, qint64 len);
-	void writeMessageTimestamp(uchar * &data, quint32 &eventTicks, const MasterClockNanos timestamp, const MasterClockNanos midiTick);
+	void writeMessageTimestamp(uchar * &data, quint32 &eventTicks, const MasterClockNanos timestamp);
 	void writeVarLenInt(uchar * &data, quint32 value);
 
 private slots:
@@ -46,6 +61,9 @@ private slots:
 // A semi-lock-free MIDI stream buffer capable to grow as it gets filled up.
 // Memory is allocated upfront by chunks of predefined size in the main thread.
 // This property makes it suitable for using directly from a realtime thread.
+// While recording, the completed chunks are encoded to a temporary file and released,
+// so that memory consumption doesn't grow with the length of recording. Should this fail,
+// the chunks are no longer released, and the recorded data is kept in memory until saved.
 class MidiTrackRecorder {
 friend class MidiRecorder;
 
@@ -60,12 +78,21 @@ public:
 private:
 	MidiRecorder &midiRecorder;
 	QMutex trackMutex;
-	DataChunk * const firstChunk;
+	DataChunk *firstChunk;
 	QAtomicPointer<DataChunk> currentChunk;
 
 	// This field is only accessed from the MIDI driver thread.
 	quint32 writePosition;
 
+	// Fields below represent the state of encoding recorded events to SMF track data.
+	QTemporaryFile streamFile;
+	qint64 streamedLength;
+	DataChunk *readChunk;
+	quint32 readPosition;
+	quint32 eventTicks;
+	uint runningStatus;
+	quint32 eventsProcessed;
+
 	uchar *requireBufferSpace(quint32 byteLength);
 };
 
@@ -65,7 +65,8 @@ void MidiSession::setName(const QString &newName) {
 	name = newName;
 }
 
-QMidiStreamParser::QMidiStreamParser(MidiSession &useMidiSession) : midiSession(useMidiSession) {}
+// The stream buffer is allocated at full size upfront, so that it never grows on a MIDI driver thread.
+QMidiStreamParser::QMidiStreamParser(MidiSession &useMidiSession) : MidiStreamParser(MAX_STREAM_BUFFER_SIZE), midiSession(useMidiSession) {}
 
 void QMidiStreamParser::setTimestamp(MasterClockNanos newTimestamp) {
 	timestamp = newTimestamp;
@@ -73,6 +73,17 @@ static inline T *loadRelaxed(const QAtomicPointer<T> &atomicPointer) {
 #endif // QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
 }
 
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+template <class T>
+static inline T *loadAcquire(QAtomicPointer<T> &atomicPointer) {
+	return atomicPointer.fetchAndAddAcquire(0);
+#else
+template <class T>
+static inline T *loadAcquire(const QAtomicPointer<T> &atomicPointer) {
+	return atomicPointer.loadAcquire();
+#endif
+}
+
 template <class T>
 static inline void storeRelease(QAtomicPointer<T> &atomicPointer, T *value) {
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
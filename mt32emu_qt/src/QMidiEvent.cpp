@@ -14,36 +14,17 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "QMidiEvent.h"
+#include <algorithm>
 
-#include <cstring>
+#include "QMidiEvent.h"
 
 using namespace MT32Emu;
 
 QMidiEvent::QMidiEvent() :
 	type(SHORT_MESSAGE),
-	msg(),
-	sysexData()
+	msg()
 {}
 
-QMidiEvent::QMidiEvent(const QMidiEvent &copyOf) :
-	timestamp(copyOf.timestamp),
-	type(copyOf.type)
-{
-	if (type == SYSEX && copyOf.sysexData != NULL) {
-		sysexLen = copyOf.sysexLen;
-		sysexData = new uchar[sysexLen];
-		memcpy(sysexData, copyOf.sysexData, sysexLen);
-	} else {
-		msg = copyOf.msg;
-		sysexData = NULL;
-	}
-}
-
-QMidiEvent::~QMidiEvent() {
-	delete[] sysexData;
-}
-
 SynthTimestamp QMidiEvent::getTimestamp() const {
 	return timestamp;
 }
@@ -52,8 +33,8 @@ MidiEventType QMidiEvent::getType() const {
 	return type;
 }
 
-uchar *QMidiEvent::getSysexData() const {
-	return sysexData;
+const uchar *QMidiEvent::getSysexData() const {
+	return sysexData.isNull() ? NULL : reinterpret_cast<const uchar *>(sysexData.constData());
 }
 
 Bit32u QMidiEvent::getShortMessage() const {
@@ -72,37 +53,87 @@ void QMidiEvent::assignShortMessage(SynthTimestamp newTimestamp, Bit32u newMsg)
 	timestamp = newTimestamp;
 	type = SHORT_MESSAGE;
 	msg = newMsg;
-	delete[] sysexData;
-	sysexData = NULL;
+	sysexData.clear();
 }
 
 void QMidiEvent::assignSysex(SynthTimestamp newTimestamp, uchar const * const newSysexData, Bit32u newSysexLen) {
 	timestamp = newTimestamp;
 	type = SYSEX;
 	sysexLen = newSysexLen;
-	delete[] sysexData;
-	uchar *copy = new uchar[newSysexLen];
-	memcpy(copy, newSysexData, newSysexLen);
-	sysexData = copy;
+	sysexData = QByteArray(reinterpret_cast<const char *>(newSysexData), int(newSysexLen));
 }
 
 void QMidiEvent::assignSetTempoMessage(SynthTimestamp newTimestamp, MT32Emu::Bit32u newTempo) {
 	timestamp = newTimestamp;
 	type = SET_TEMPO;
 	msg = newTempo;
-	delete[] sysexData;
-	sysexData = NULL;
+	sysexData.clear();
 }
 
 void QMidiEvent::assignSyncMessage(SynthTimestamp newTimestamp) {
 	timestamp = newTimestamp;
 	type = SYNC;
 	msg = 0;
-	delete[] sysexData;
-	sysexData = NULL;
+	sysexData.clear();
 }
 
 QMidiEvent &QMidiEventList::newMidiEvent() {
 	resize(size() + 1U);
 	return last();
 }
+
+void MidiEventTimeIndex::build(const MidiStreamSource &midiStreamSource) {
+	clear();
+	const QMidiEventList &midiEvents = midiStreamSource.getMIDIEvents();
+	eventTicks.reserve(midiEvents.count());
+	eventNanos.reserve(midiEvents.count());
+	MasterClockNanos midiTick = midiStreamSource.getMidiTick();
+	SynthTimestamp ticks = 0;
+	MasterClockNanos nanos = 0;
+	for (int i = 0; i < midiEvents.count(); i++) {
+		const QMidiEvent &e = midiEvents.at(i);
+		ticks += e.getTimestamp();
+		nanos += e.getTimestamp() * midiTick;
+		eventTicks.append(ticks);
+		eventNanos.append(nanos);
+		if (e.getType() == SET_TEMPO) {
+			tempoChangeIxs.append(i);
+			tempos.append(e.getShortMessage());
+			midiTick = midiStreamSource.getMidiTick(e.getShortMessage());
+		}
+	}
+}
+
+void MidiEventTimeIndex::clear() {
+	eventTicks.clear();
+	eventNanos.clear();
+	tempoChangeIxs.clear();
+	tempos.clear();
+}
+
+MasterClockNanos MidiEventTimeIndex::getEventNanos(int eventIx) const {
+	return eventNanos.at(eventIx);
+}
+
+MasterClockNanos MidiEventTimeIndex::getTotalNanos() const {
+	return eventNanos.isEmpty() ? 0 : eventNanos.last();
+}
+
+int MidiEventTimeIndex::findEvent(MasterClockNanos nanos) const {
+	if (eventNanos.isEmpty()) return 0;
+	int eventIx = int(std::lower_bound(eventNanos.constBegin(), eventNanos.constEnd(), nanos) - eventNanos.constBegin());
+	return qMin(eventIx, eventNanos.count() - 1);
+}
+
+uint MidiEventTimeIndex::getTempo(int eventIx) const {
+	int tempoIx = int(std::lower_bound(tempoChangeIxs.constBegin(), tempoChangeIxs.constEnd(), eventIx) - tempoChangeIxs.constBegin());
+	return tempoIx == 0 ? 0 : tempos.at(tempoIx - 1);
+}
+
+MasterClockNanos MidiEventTimeIndex::getRemainingNanos(int eventIx, MasterClockNanos midiTick) const {
+	if (eventNanos.count() <= eventIx) return 0;
+	SynthTimestamp precedingEventTicks = eventIx > 0 ? eventTicks.at(eventIx - 1) : 0;
+	int tempoIx = int(std::lower_bound(tempoChangeIxs.constBegin(), tempoChangeIxs.constEnd(), eventIx) - tempoChangeIxs.constBegin());
+	int tempoChangeIx = tempoIx < tempoChangeIxs.count() ? tempoChangeIxs.at(tempoIx) : eventNanos.count() - 1;
+	return (eventTicks.at(tempoChangeIx) - precedingEventTicks) * midiTick + getTotalNanos() - eventNanos.at(tempoChangeIx);
+}
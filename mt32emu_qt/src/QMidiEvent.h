@@ -2,6 +2,7 @@
 #define QMIDI_EVENT_H
 
 #include <QtGlobal>
+#include <QByteArray>
 #include <QVector>
 
 #include <mt32emu/mt32emu.h>
@@ -25,18 +26,17 @@ private:
 		MT32Emu::Bit32u msg;
 		MT32Emu::Bit32u sysexLen;
 	};
-	uchar *sysexData;
+	// Implicitly shared, so that copying events (e.g. while a QMidiEventList grows) involves no allocations.
+	QByteArray sysexData;
 
 public:
 	QMidiEvent();
-	QMidiEvent(const QMidiEvent &copyOf);
-	~QMidiEvent();
 
 	SynthTimestamp getTimestamp() const;
 	MidiEventType getType() const;
 	MT32Emu::Bit32u getShortMessage() const;
 	MT32Emu::Bit32u getSysexLen() const;
-	uchar *getSysexData() const;
+	const uchar *getSysexData() const;
 
 	void setTimestamp(SynthTimestamp newTimestamp);
 	void assignShortMessage(SynthTimestamp newTimestamp, MT32Emu::Bit32u newMsg);
@@ -50,6 +50,35 @@ public:
 	QMidiEvent &newMidiEvent();
 };
 
+class MidiStreamSource;
+
+// Keeps the absolute time of each event in a QMidiEventList, at the tempo set by the events themselves, along with the tempo map.
+// Once built, it allows looking up events by time and estimating playback time without scanning through the events.
+class MidiEventTimeIndex {
+public:
+	void build(const MidiStreamSource &midiStreamSource);
+	void clear();
+
+	MasterClockNanos getEventNanos(int eventIx) const;
+	MasterClockNanos getTotalNanos() const;
+
+	// Returns the index of the first event that occurs at or after the specified time, or the index of the last event if there is none.
+	int findEvent(MasterClockNanos nanos) const;
+
+	// Returns the tempo in effect right before the event at the specified index, or zero if the default tempo is in effect.
+	uint getTempo(int eventIx) const;
+
+	// Returns the time from the event preceding the one at the specified index till the end of the stream,
+	// provided that the events up to the next tempo change are timed using the specified MIDI tick.
+	MasterClockNanos getRemainingNanos(int eventIx, MasterClockNanos midiTick) const;
+
+private:
+	QVector<SynthTimestamp> eventTicks;
+	QVector<MasterClockNanos> eventNanos;
+	QVector<int> tempoChangeIxs;
+	QVector<uint> tempos;
+};
+
 class MidiStreamSource {
 public:
 	static const quint32 DEFAULT_BPM = 120;
@@ -60,6 +89,9 @@ public:
 	virtual const QString getStreamName() const = 0;
 	virtual const QMidiEventList &getMIDIEvents() const = 0;
 	virtual MasterClockNanos getMidiTick(uint tempo = DEFAULT_TEMPO) const = 0;
+
+	// Returns the time index of the MIDI events, or NULL if the source doesn't maintain one.
+	virtual const MidiEventTimeIndex *getTimeIndex() const { return NULL; }
 };
 
 #endif
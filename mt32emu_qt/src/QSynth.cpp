@@ -16,13 +16,13 @@
 
 #include <cstring>
 #include <QtGlobal>
-#include <QMessageBox>
 
 #include "QSynth.h"
 #include "AudioFileWriter.h"
 #include "Master.h"
 #include "MasterClock.h"
-#include "RealtimeLocker.h"
+#include "QAtomicHelper.h"
+#include "QMidiBuffer.h"
 
 using namespace MT32Emu;
 
@@ -34,7 +34,9 @@ const int VOICE_PART_COUNT = 8;
 const int PART_COUNT = VOICE_PART_COUNT + 1;
 const int SOUND_GROUP_NAME_LENGTH = 9; // 0-terminated
 const int TIMBRE_NAME_LENGTH = 11; // 0-terminated
+const int PATCH_NAME_LENGTH = 11; // 0-terminated
 const int NO_UPDATE_VALUE = -1;
+const int DEFERRED_REPORTS_DISPATCH_PERIOD_MILLIS = 10;
 
 static const ROMImage *makeROMImage(const QDir &romDir, QString romFileName, QString romFileName2) {
 	if (romFileName2.isEmpty()) {
@@ -108,6 +110,176 @@ static void makeSoundGroups(Synth &synth, QVector<SoundGroup> &groups) {
 	}
 }
 
+// Renders the synth output (including the reverb and the analogue circuit emulation) in a worker thread about one audio block
+// ahead of the sample rate conversion, so that the synth and the resampler run in parallel on two cores. The worker only accesses
+// the synth while the rendering thread is converting the samples rendered previously, and the rendering thread waits for the worker
+// to complete before returning, so no additional synchronisation is needed with other users of the synth. The rendered samples are
+// passed via a lock-free single-producer single-consumer FIFO. Because the synth runs ahead, the MIDI events must be scheduled later
+// by getLatencyFrames() to keep their timing. The latency is established by the first audio block and stays constant afterwards:
+// it comprises the length of that block and the resampler input headroom, which is MAX_SAMPLES_PER_RUN synth frames as no converter
+// ever pulls more input at once. For instance, at the default synth sample rate 32 kHz and 44.1 kHz output with 512-frame blocks,
+// the latency adds up to 372 + 4096 synth frames, that is about 140 ms. Should the resampler still run short of the rendered samples,
+// e.g. because the audio block length grows, the rest is rendered synchronously, so the latency never changes mid-stream.
+// Only accessed from the rendering thread, or while rendering is impossible.
+class RenderPipeline : public QThread, public SynthOutputSource {
+private:
+	// FIFO capacity in stereo frames, must be a power of 2.
+	static const quint32 FIFO_SIZE = 65536;
+	// The worker publishes the rendered samples in chunks of this many frames.
+	static const quint32 RENDER_CHUNK_SIZE = 256;
+	// Additional frames rendered ahead, as the resampler may demand more input than the nominal block length.
+	static const quint32 HEADROOM = MAX_SAMPLES_PER_RUN;
+
+	Synth &synth;
+	const double synthFramesPerOutputFrame;
+	float * const fifo;
+	QAtomicInt fifoWritePosition;
+	quint32 fifoReadPosition;
+	quint32 framesToRender;
+	// FIFO level maintained before each sample rate conversion, zero until the first audio block arrives.
+	quint32 targetLevel;
+	QAtomicInt latencyFrames;
+	bool workerBusy;
+	bool stopProcessing;
+	QSemaphore renderRequested;
+	QSemaphore renderCompleted;
+
+	void run() {
+		forever {
+			renderRequested.acquire();
+			if (stopProcessing) return;
+			quint32 writePosition = QAtomicHelper::loadRelaxed(fifoWritePosition);
+			while (framesToRender > 0) {
+				quint32 offset = writePosition & (FIFO_SIZE - 1);
+				quint32 chunkSize = qMin(qMin(framesToRender, RENDER_CHUNK_SIZE), FIFO_SIZE - offset);
+				synth.render(fifo + 2 * offset, chunkSize);
+				writePosition += chunkSize;
+				framesToRender -= chunkSize;
+				QAtomicHelper::storeRelease(fifoWritePosition, writePosition);
+			}
+			renderCompleted.release();
+		}
+	}
+
+	void waitForWorker() {
+		if (!workerBusy) return;
+		renderCompleted.acquire();
+		workerBusy = false;
+	}
+
+public:
+	RenderPipeline(Synth &useSynth, uint outputSampleRate) :
+		synth(useSynth),
+		synthFramesPerOutputFrame(double(useSynth.getStereoOutputSampleRate()) / outputSampleRate),
+		fifo(new float[2 * FIFO_SIZE]),
+		fifoWritePosition(0),
+		fifoReadPosition(0),
+		framesToRender(0),
+		targetLevel(0),
+		latencyFrames(0),
+		workerBusy(false),
+		stopProcessing(false)
+	{
+		start(QThread::TimeCriticalPriority);
+	}
+
+	~RenderPipeline() {
+		waitForWorker();
+		stopProcessing = true;
+		renderRequested.release();
+		wait();
+		delete[] fifo;
+	}
+
+	// Returns the number of synth frames the synth output is rendered ahead of the sample rate conversion.
+	// May be invoked from any thread.
+	quint32 getLatencyFrames() const {
+		return QAtomicHelper::loadRelaxed(latencyFrames);
+	}
+
+	template <class Sample>
+	void render(SampleRateConverter &sampleRateConverter, Sample *buffer, uint length) {
+		// Render enough to cover the next block after the resampler consumes this one.
+		quint32 blockFrames = quint32(length * synthFramesPerOutputFrame) + 1;
+		if (targetLevel == 0) {
+			targetLevel = blockFrames + HEADROOM;
+			QAtomicHelper::storeRelease(latencyFrames, targetLevel);
+		}
+		quint32 level = QAtomicHelper::loadAcquire(fifoWritePosition) - fifoReadPosition;
+		if (level < targetLevel + blockFrames) {
+			framesToRender = qMin(targetLevel + blockFrames - level, FIFO_SIZE - level);
+			workerBusy = true;
+			renderRequested.release();
+		}
+		sampleRateConverter.getOutputSamples(buffer, length);
+		waitForWorker();
+	}
+
+	void getSynthOutputSamples(float *buffer, unsigned int length) {
+		while (length > 0) {
+			quint32 available = QAtomicHelper::loadAcquire(fifoWritePosition) - fifoReadPosition;
+			if (available == 0) {
+				if (workerBusy) {
+					// The worker is still rendering the next chunk.
+					if (renderCompleted.tryAcquire()) {
+						workerBusy = false;
+					} else {
+						yieldCurrentThread();
+					}
+					continue;
+				}
+				// The resampler demands more than was rendered ahead. As the worker is idle, render the rest right here.
+				synth.render(buffer, length);
+				fifoReadPosition += length;
+				QAtomicHelper::storeRelease(fifoWritePosition, fifoReadPosition);
+				return;
+			}
+			quint32 offset = fifoReadPosition & (FIFO_SIZE - 1);
+			quint32 count = qMin(qMin(available, quint32(length)), FIFO_SIZE - offset);
+			memcpy(buffer, fifo + 2 * offset, 2 * count * sizeof(float));
+			buffer += 2 * count;
+			length -= count;
+			fifoReadPosition += count;
+		}
+	}
+};
+
+// Measures the time spent rendering each audio block and reports it to the synth, which adapts the partial limit
+// to keep the rendering within the configured CPU budget. Only accessed from the rendering thread, or while rendering is impossible.
+class RenderLoadMeter {
+private:
+	uint sampleRate;
+
+public:
+	RenderLoadMeter() : sampleRate() {}
+
+	// Invoked when the synth is opened.
+	void reset(uint useSampleRate) {
+		sampleRate = useSampleRate;
+	}
+
+	template <class Sample>
+	void render(SampleRateConverter &sampleRateConverter, RenderPipeline *renderPipeline, Synth &synth, Sample *buffer, uint length) {
+		if (synth.getCPUBudget() == 0 || length == 0) {
+			renderOutput(sampleRateConverter, renderPipeline, buffer, length);
+			return;
+		}
+		MasterClockNanos startNanos = MasterClock::getClockNanos();
+		renderOutput(sampleRateConverter, renderPipeline, buffer, length);
+		MasterClockNanos renderNanos = MasterClock::getClockNanos() - startNanos;
+		synth.reportRenderLoad(double(renderNanos), double(MasterClock::framesToNanos(length, sampleRate)));
+	}
+
+	template <class Sample>
+	static void renderOutput(SampleRateConverter &sampleRateConverter, RenderPipeline *renderPipeline, Sample *buffer, uint length) {
+		if (renderPipeline != NULL) {
+			renderPipeline->render(sampleRateConverter, buffer, length);
+		} else {
+			sampleRateConverter.getOutputSamples(buffer, length);
+		}
+	}
+};
+
 class RealtimeHelper : public QThread {
 private:
 	enum SynthControlEvent {
@@ -118,6 +290,7 @@ private:
 		REVERB_ENABLED_CHANGED,
 		REVERB_OVERRIDDEN_CHANGED,
 		REVERB_SETTINGS_CHANGED,
+		REVERB_COMPATIBILITY_MODE_CHANGED,
 		PART_VOLUME_OVERRIDE_CHANGED,
 		PART_TIMBRE_CHANGED,
 		REVERSED_STEREO_ENABLED_CHANGED,
@@ -127,35 +300,91 @@ private:
 		EMU_DAC_INPUT_MODE_CHANGED,
 		MIDI_DELAY_MODE_CHANGED,
 		MIDI_CHANNELS_ASSIGNMENT_RESET,
+		MIDI_QUEUE_FLUSH,
 		DISPLAY_RESET,
-		DISPLAY_COMPATIBILITY_MODE_CHANGED
+		DISPLAY_COMPATIBILITY_MODE_CHANGED,
+		PARTIAL_LIMIT_CHANGED,
+		CPU_BUDGET_CHANGED,
+		SYNTH_CONTROL_EVENT_COUNT
+	};
+
+	// A self-contained command, so that the rendering thread never needs to look into the settings
+	// that are concurrently modified by other threads.
+	struct SynthControlCommand {
+		SynthControlEvent event;
+		int intValues[3];
+		float floatValue;
+	};
+
+	// Each event takes one slot, except for the per-part events which take one slot per part.
+	static const int SYNTH_CONTROL_SLOT_COUNT = SYNTH_CONTROL_EVENT_COUNT + 2 * PART_COUNT;
+	static const int STATE_SNAPSHOT_COUNT = 3;
+	static const int STATE_SNAPSHOT_FRESH_FLAG = 4;
+
+	// Synth state snapshot, published by the rendering thread and consumed by this helper thread.
+	struct StateSnapshot {
+		char lcdMessage[LCD_MESSAGE_LENGTH];
+		char lcdState[LCD_MESSAGE_LENGTH];
+		bool lcdStateUpdated;
+		bool midiMessageLEDState;
+		bool midiMessageLEDStateUpdated;
+		int masterVolumeUpdate;
+		int reverbMode;
+		int reverbTime;
+		int reverbLevel;
+		bool activityUpdated;
+		bool active;
+		struct {
+			bool polyStateChanged;
+			bool programChanged;
+			char soundGroupName[SOUND_GROUP_NAME_LENGTH];
+			char timbreName[TIMBRE_NAME_LENGTH];
+			char patchName[PATCH_NAME_LENGTH];
+			Bit32u playingNotesCount;
+			Bit8u keysOfPlayingNotes[MAX_PARTIAL_COUNT];
+			Bit8u velocitiesOfPlayingNotes[MAX_PARTIAL_COUNT];
+		} partStates[PART_COUNT];
+		PartialState partialStates[MAX_PARTIAL_COUNT];
 	};
 
 	QSynth &qsynth;
 	bool stopProcessing;
 
-	QQueue<SynthControlEvent> synthControlEvents;
+	// Latest pending synth control commands, coalesced per setting and guarded by settingsMutex. The indices of the slots
+	// with a pending command are kept in the order of their most recent update, so that the commands are applied in sequence.
+	// As there is a slot for each setting, no change is ever lost, no matter how long the rendering thread is late.
+	SynthControlCommand synthControlSlots[SYNTH_CONTROL_SLOT_COUNT];
+	int pendingSynthControlSlotIxs[SYNTH_CONTROL_SLOT_COUNT];
+	int pendingSynthControlSlotCount;
+	// Set whenever there are pending commands, so that the rendering thread only tries to lock settingsMutex when necessary.
+	QAtomicInt synthControlCommandsPending;
 
-	// Synth settings, guarded by settingsMutex.
-	int masterVolume;
+	// Counter of MIDI messages dropped by the producers due to overflow, reported by this helper thread.
+	QAtomicInt droppedImmediateMidiMessagesCount;
+
+	// Set when the activity of the synth is queried, so that the rendering thread only evaluates it when needed.
+	QAtomicInt activityQueried;
+
+	// Synth settings as requested most recently, guarded by settingsMutex. Never accessed from the rendering thread.
 	float outputGain;
 	float reverbOutputGain;
 	bool reverbEnabled;
 	bool reverbOverridden;
-	int partVolumeOverride[PART_COUNT];
-	struct {
-		quint8 changed : 1;
-		quint8 group : 2;
-		quint8 number : 6;
-	} partTimbres[VOICE_PART_COUNT];
 	bool reversedStereoEnabled;
 	bool niceAmpRampEnabled;
 	bool nicePanningEnabled;
 	bool nicePartialMixingEnabled;
 	DACInputMode emuDACInputMode;
 	MIDIDelayMode midiDelayMode;
-	bool midiChannelsAssignmentChannel1Engaged;
-	DisplayCompatibilityMode displayCompatibilityMode;
+
+	// MIDI messages to be played immediately at the beginning of the next rendering pass.
+	// The producer side is serialised by immediateMidiMutex.
+	QMidiBuffer immediateMidiBuffer;
+
+	// Rendering is only performed while the synth is open. The rendering thread flags each rendering pass,
+	// so that the synth can be safely closed without ever blocking that thread.
+	mutable QAtomicInt renderingEnabled;
+	QAtomicInt renderingPassActive;
 
 	// Temp synth state collected while rendering, only accessed from the rendering thread.
 	// On backpressure, the latest values are kept.
@@ -176,176 +405,307 @@ private:
 		} partStates[PART_COUNT];
 	} tempState;
 
-	// Synth state snapshot, guarded by stateSnapshotMutex.
+	// Triple buffer of state snapshots. The rendering thread owns the back snapshot, this helper thread owns the front one,
+	// and the index of the remaining snapshot is exchanged atomically, along with a flag indicating that it is fresh.
+	// A snapshot that is returned to the rendering thread unconsumed retains its pending updates, so that none is lost.
+	StateSnapshot stateSnapshots[STATE_SNAPSHOT_COUNT];
+	int backStateSnapshotIx;
+	int frontStateSnapshotIx;
+	QAtomicInt middleStateSnapshotIx;
+
+	// The latest synth state to be queried by the UI, guarded by stateSnapshotMutex.
 	struct {
-		char lcdMessage[LCD_MESSAGE_LENGTH];
 		char lcdState[LCD_MESSAGE_LENGTH];
-		bool lcdStateUpdated;
 		bool midiMessageLEDState;
-		bool midiMessageLEDStateUpdated;
-		int masterVolumeUpdate;
-		int reverbMode;
-		int reverbTime;
-		int reverbLevel;
+		bool active;
 		struct {
-			bool polyStateChanged;
-			bool programChanged;
-			char soundGroupName[SOUND_GROUP_NAME_LENGTH];
-			char timbreName[TIMBRE_NAME_LENGTH];
+			char patchName[PATCH_NAME_LENGTH];
 			Bit32u playingNotesCount;
 			Bit8u keysOfPlayingNotes[MAX_PARTIAL_COUNT];
 			Bit8u velocitiesOfPlayingNotes[MAX_PARTIAL_COUNT];
 		} partStates[PART_COUNT];
 		PartialState partialStates[MAX_PARTIAL_COUNT];
-	} stateSnapshot;
+	} uiState;
 
-	/** Ensures atomicity of collecting changes to be applied to the synth settings. */
+	/** Ensures atomicity of collecting changes to be applied to the synth settings. Only try-locked by the rendering thread. */
 	QMutex settingsMutex;
-	/** Ensures atomicity of handling the output signals of the synth and capturing its internal state. */
+	/** Serialises the threads that submit MIDI messages for immediate playback. Never locked by the rendering thread. */
+	QMutex immediateMidiMutex;
+	/** Ensures atomicity of accessing the synth state exposed to the UI. Never locked by the rendering thread. */
 	QMutex stateSnapshotMutex;
+	/** Held by this thread while handling the output signals of the synth. */
+	QMutex renderCompleteMutex;
 	/** Used to block this thread until each rendering pass completes. */
 	QWaitCondition renderCompleteCondition;
 
 	QVector<SoundGroup> soundGroupCache;
 
+	void enqueueSynthControlEvent(SynthControlEvent event, int value1 = 0, int value2 = 0, int value3 = 0) {
+		SynthControlCommand command = {event, {value1, value2, value3}, 0.0f};
+		enqueueSynthControlCommand(command);
+	}
+
+	void enqueueSynthControlEvent(SynthControlEvent event, float value) {
+		SynthControlCommand command = {event, {0, 0, 0}, value};
+		enqueueSynthControlCommand(command);
+	}
+
+	static int getSynthControlSlotIx(const SynthControlCommand &command) {
+		switch (command.event) {
+		case PART_VOLUME_OVERRIDE_CHANGED:
+			return SYNTH_CONTROL_EVENT_COUNT + command.intValues[0];
+		case PART_TIMBRE_CHANGED:
+			return SYNTH_CONTROL_EVENT_COUNT + PART_COUNT + command.intValues[0];
+		default:
+			return command.event;
+		}
+	}
+
+	// Must be invoked with settingsMutex locked. A command that supersedes a pending one is moved to the end of the sequence.
+	void enqueueSynthControlCommand(const SynthControlCommand &command) {
+		if ((command.event == PART_VOLUME_OVERRIDE_CHANGED || command.event == PART_TIMBRE_CHANGED)
+			&& (command.intValues[0] < 0 || PART_COUNT <= command.intValues[0])) return;
+		int slotIx = getSynthControlSlotIx(command);
+		int pendingIx = 0;
+		while (pendingIx < pendingSynthControlSlotCount && pendingSynthControlSlotIxs[pendingIx] != slotIx) pendingIx++;
+		if (pendingIx < pendingSynthControlSlotCount) {
+			pendingSynthControlSlotCount--;
+			memmove(&pendingSynthControlSlotIxs[pendingIx], &pendingSynthControlSlotIxs[pendingIx + 1], (pendingSynthControlSlotCount - pendingIx) * sizeof(int));
+		}
+		synthControlSlots[slotIx] = command;
+		pendingSynthControlSlotIxs[pendingSynthControlSlotCount++] = slotIx;
+		QAtomicHelper::storeRelease(synthControlCommandsPending, 1);
+	}
+
 	void applyChangesRealtime() {
-		RealtimeLocker settingsLocker(settingsMutex);
-		if (!settingsLocker.isLocked()) return;
+		if (QAtomicHelper::loadAcquire(synthControlCommandsPending) == 0) return;
+		// When the settings are being modified concurrently, the pending commands are picked up during one of the next passes.
+		if (!settingsMutex.tryLock()) return;
+		SynthControlCommand commands[SYNTH_CONTROL_SLOT_COUNT];
+		int commandCount = pendingSynthControlSlotCount;
+		for (int pendingIx = 0; pendingIx < commandCount; pendingIx++) {
+			commands[pendingIx] = synthControlSlots[pendingSynthControlSlotIxs[pendingIx]];
+		}
+		pendingSynthControlSlotCount = 0;
+		QAtomicHelper::storeRelease(synthControlCommandsPending, 0);
+		settingsMutex.unlock();
+
 		Synth *synth = qsynth.synth;
-		while (!synthControlEvents.isEmpty()) {
-			switch (synthControlEvents.dequeue()) {
+		for (int commandIx = 0; commandIx < commandCount; commandIx++) {
+			const SynthControlCommand &command = commands[commandIx];
+			switch (command.event) {
 			case SYNTH_RESET:
 				writeSystemResetSysex(synth);
 				break;
 			case MASTER_VOLUME_CHANGED:
-				writeMasterVolumeSysex(synth, masterVolume);
+				writeMasterVolumeSysex(synth, command.intValues[0]);
 				break;
 			case OUTPUT_GAIN_CHANGED:
-				synth->setOutputGain(outputGain);
+				synth->setOutputGain(command.floatValue);
 				break;
 			case REVERB_OUTPUT_GAIN_CHANGED:
-				synth->setReverbOutputGain(reverbOutputGain);
+				synth->setReverbOutputGain(command.floatValue);
 				break;
 			case REVERB_ENABLED_CHANGED:
-				synth->setReverbEnabled(reverbEnabled);
+				synth->setReverbEnabled(command.intValues[0] != 0);
 				break;
 			case REVERB_OVERRIDDEN_CHANGED:
-				synth->setReverbOverridden(reverbOverridden);
+				synth->setReverbOverridden(command.intValues[0] != 0);
 				break;
 			case REVERB_SETTINGS_CHANGED:
-				overrideReverbSettings(synth, qsynth.reverbMode, qsynth.reverbTime, qsynth.reverbLevel);
+				overrideReverbSettings(synth, command.intValues[0], command.intValues[1], command.intValues[2]);
+				break;
+			case REVERB_COMPATIBILITY_MODE_CHANGED:
+				synth->setReverbCompatibilityMode(command.intValues[0] != 0);
 				break;
 			case PART_VOLUME_OVERRIDE_CHANGED:
-				for (int i = 0; i < PART_COUNT; i++) {
-					if (NO_UPDATE_VALUE != partVolumeOverride[i]) {
-						synth->setPartVolumeOverride(i, partVolumeOverride[i]);
-						partVolumeOverride[i] = NO_UPDATE_VALUE;
-					}
-				}
+				synth->setPartVolumeOverride(Bit8u(command.intValues[0]), Bit8u(command.intValues[1]));
 				break;
 			case PART_TIMBRE_CHANGED:
-				for (int i = 0; i < VOICE_PART_COUNT; i++) {
-					if (partTimbres[i].changed) {
-						partTimbres[i].changed = 0;
-						writeTimbreSelectionOnPartSysex(synth, i, partTimbres[i].group, partTimbres[i].number);
-					}
-				}
+				writeTimbreSelectionOnPartSysex(synth, quint8(command.intValues[0]), quint8(command.intValues[1]), quint8(command.intValues[2]));
 				break;
 			case REVERSED_STEREO_ENABLED_CHANGED:
-				synth->setReversedStereoEnabled(reversedStereoEnabled);
+				synth->setReversedStereoEnabled(command.intValues[0] != 0);
 				break;
 			case NICE_AMP_RAMP_ENABLED_CHANGED:
-				synth->setNiceAmpRampEnabled(niceAmpRampEnabled);
+				synth->setNiceAmpRampEnabled(command.intValues[0] != 0);
 				break;
 			case NICE_PANNING_ENABLED_CHANGED:
-				synth->setNicePanningEnabled(nicePanningEnabled);
+				synth->setNicePanningEnabled(command.intValues[0] != 0);
 				break;
 			case NICE_PARTIAL_MIXING_ENABLED_CHANGED:
-				synth->setNicePartialMixingEnabled(nicePartialMixingEnabled);
+				synth->setNicePartialMixingEnabled(command.intValues[0] != 0);
 				break;
 			case EMU_DAC_INPUT_MODE_CHANGED:
-				synth->setDACInputMode(emuDACInputMode);
+				synth->setDACInputMode(DACInputMode(command.intValues[0]));
 				break;
 			case MIDI_DELAY_MODE_CHANGED:
-				synth->setMIDIDelayMode(midiDelayMode);
+				synth->setMIDIDelayMode(MIDIDelayMode(command.intValues[0]));
 				break;
 			case MIDI_CHANNELS_ASSIGNMENT_RESET:
-				writeMIDIChannelsAssignmentResetSysex(synth, midiChannelsAssignmentChannel1Engaged);
+				writeMIDIChannelsAssignmentResetSysex(synth, command.intValues[0] != 0);
+				break;
+			case MIDI_QUEUE_FLUSH:
+				synth->flushMIDIQueue();
 				break;
 			case DISPLAY_RESET:
 				synth->setMainDisplayMode();
 				break;
 			case DISPLAY_COMPATIBILITY_MODE_CHANGED:
-				if (DisplayCompatibilityMode_DEFAULT == displayCompatibilityMode) {
+				if (DisplayCompatibilityMode_DEFAULT == command.intValues[0]) {
 					synth->setDisplayCompatibility(synth->isDefaultDisplayOldMT32Compatible());
 				} else {
-					synth->setDisplayCompatibility(DisplayCompatibilityMode_OLD_MT32 == displayCompatibilityMode);
+					synth->setDisplayCompatibility(DisplayCompatibilityMode_OLD_MT32 == command.intValues[0]);
 				}
 				break;
+			case PARTIAL_LIMIT_CHANGED:
+				synth->setPartialLimit(Bit32u(command.intValues[0]));
+				break;
+			case CPU_BUDGET_CHANGED:
+				synth->setCPUBudget(Bit32u(command.intValues[0]));
+				break;
+			case SYNTH_CONTROL_EVENT_COUNT:
+				break;
 			}
 		}
 	}
 
+	void playImmediateMIDIRealtime() {
+		Synth *synth = qsynth.synth;
+		while (immediateMidiBuffer.retrieveEvents()) {
+			do {
+				const uchar *sysexData;
+				quint32 eventData = immediateMidiBuffer.getEventData(sysexData);
+				if (sysexData == NULL) {
+					synth->playMsgNow(eventData);
+				} else {
+					synth->playSysexNow(sysexData, eventData);
+				}
+			} while (immediateMidiBuffer.nextEvent());
+		}
+	}
+
 	void saveStateRealtime() {
-		RealtimeLocker stateSnapshotLocker(stateSnapshotMutex);
-		if (!stateSnapshotLocker.isLocked()) return;
+		StateSnapshot &stateSnapshot = stateSnapshots[backStateSnapshotIx];
 
-		memcpy(stateSnapshot.lcdMessage, tempState.lcdMessage, LCD_MESSAGE_LENGTH - 1);
-		tempState.lcdMessage[0] = 0;
+		// Pending updates that the back snapshot may still contain are only overridden by newer ones.
+		if (tempState.lcdMessage[0]) {
+			memcpy(stateSnapshot.lcdMessage, tempState.lcdMessage, LCD_MESSAGE_LENGTH - 1);
+			tempState.lcdMessage[0] = 0;
+		}
 
-		stateSnapshot.masterVolumeUpdate = tempState.masterVolumeUpdate;
-		tempState.masterVolumeUpdate = NO_UPDATE_VALUE;
+		if (tempState.masterVolumeUpdate > NO_UPDATE_VALUE) {
+			stateSnapshot.masterVolumeUpdate = tempState.masterVolumeUpdate;
+			tempState.masterVolumeUpdate = NO_UPDATE_VALUE;
+		}
 
-		stateSnapshot.reverbMode = tempState.reverbMode;
-		tempState.reverbMode = NO_UPDATE_VALUE;
+		if (tempState.reverbMode > NO_UPDATE_VALUE) {
+			stateSnapshot.reverbMode = tempState.reverbMode;
+			tempState.reverbMode = NO_UPDATE_VALUE;
+		}
 
-		stateSnapshot.reverbTime = tempState.reverbTime;
-		tempState.reverbTime = NO_UPDATE_VALUE;
+		if (tempState.reverbTime > NO_UPDATE_VALUE) {
+			stateSnapshot.reverbTime = tempState.reverbTime;
+			tempState.reverbTime = NO_UPDATE_VALUE;
+		}
 
-		stateSnapshot.reverbLevel = tempState.reverbLevel;
-		tempState.reverbLevel = NO_UPDATE_VALUE;
+		if (tempState.reverbLevel > NO_UPDATE_VALUE) {
+			stateSnapshot.reverbLevel = tempState.reverbLevel;
+			tempState.reverbLevel = NO_UPDATE_VALUE;
+		}
 
-		stateSnapshot.midiMessageLEDStateUpdated = tempState.midiMessageLEDStateUpdated;
 		if (tempState.midiMessageLEDStateUpdated) {
 			tempState.midiMessageLEDStateUpdated = false;
+			stateSnapshot.midiMessageLEDStateUpdated = true;
 			stateSnapshot.midiMessageLEDState = tempState.midiMessageLEDState;
 		}
 
 		Synth *synth = qsynth.synth;
 
-		stateSnapshot.lcdStateUpdated = tempState.lcdStateUpdated;
 		if (tempState.lcdStateUpdated) {
 			tempState.lcdStateUpdated = false;
+			stateSnapshot.lcdStateUpdated = true;
 			synth->getDisplayState(stateSnapshot.lcdState);
 		}
 
 		for (int partIx = 0; partIx < PART_COUNT; partIx++) {
-			stateSnapshot.partStates[partIx].programChanged = tempState.partStates[partIx].programChanged;
 			if (tempState.partStates[partIx].programChanged) {
 				tempState.partStates[partIx].programChanged = false;
+				stateSnapshot.partStates[partIx].programChanged = true;
 				memcpy(stateSnapshot.partStates[partIx].soundGroupName, tempState.partStates[partIx].soundGroupName, SOUND_GROUP_NAME_LENGTH - 1);
 				memcpy(stateSnapshot.partStates[partIx].timbreName, tempState.partStates[partIx].timbreName, TIMBRE_NAME_LENGTH - 1);
 			}
 
-			stateSnapshot.partStates[partIx].polyStateChanged = tempState.partStates[partIx].polyStateChanged;
 			if (tempState.partStates[partIx].polyStateChanged) {
 				tempState.partStates[partIx].polyStateChanged = false;
+				stateSnapshot.partStates[partIx].polyStateChanged = true;
 				stateSnapshot.partStates[partIx].playingNotesCount = synth->getPlayingNotes(partIx, stateSnapshot.partStates[partIx].keysOfPlayingNotes, stateSnapshot.partStates[partIx].velocitiesOfPlayingNotes);
 			}
 		}
 
+		for (int partIx = 0; partIx < PART_COUNT; partIx++) {
+			const char *patchName = synth->getPatchName(partIx);
+			if (patchName != NULL) memcpy(stateSnapshot.partStates[partIx].patchName, patchName, PATCH_NAME_LENGTH - 1);
+		}
+
 		synth->getPartialStates(stateSnapshot.partialStates);
+
+		if (activityQueried.fetchAndStoreRelaxed(0) != 0) {
+			stateSnapshot.activityUpdated = true;
+			stateSnapshot.active = synth->isActive();
+		}
+
+		// Ordered exchange ensures that the snapshot is fully written prior to publishing it.
+		int previousMiddleIx = middleStateSnapshotIx.fetchAndStoreOrdered(backStateSnapshotIx | STATE_SNAPSHOT_FRESH_FLAG);
+		backStateSnapshotIx = previousMiddleIx & ~STATE_SNAPSHOT_FRESH_FLAG;
 	}
 
-	void enqueueSynthControlEvent(SynthControlEvent value) {
-		synthControlEvents.removeOne(value);
-		synthControlEvents.enqueue(value);
+	bool retrieveStateSnapshot() {
+		if ((QAtomicHelper::loadAcquire(middleStateSnapshotIx) & STATE_SNAPSHOT_FRESH_FLAG) == 0) return false;
+		int previousMiddleIx = middleStateSnapshotIx.fetchAndStoreOrdered(frontStateSnapshotIx);
+		frontStateSnapshotIx = previousMiddleIx & ~STATE_SNAPSHOT_FRESH_FLAG;
+		return true;
 	}
 
-	void run() {
+	void updateUIState(const StateSnapshot &stateSnapshot) {
 		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
+		if (stateSnapshot.lcdStateUpdated) {
+			memcpy(uiState.lcdState, stateSnapshot.lcdState, LCD_MESSAGE_LENGTH);
+		}
+		if (stateSnapshot.midiMessageLEDStateUpdated) {
+			uiState.midiMessageLEDState = stateSnapshot.midiMessageLEDState;
+		}
+		if (stateSnapshot.activityUpdated) {
+			uiState.active = stateSnapshot.active;
+		}
+		for (int partIx = 0; partIx < PART_COUNT; partIx++) {
+			memcpy(uiState.partStates[partIx].patchName, stateSnapshot.partStates[partIx].patchName, PATCH_NAME_LENGTH);
+			if (!stateSnapshot.partStates[partIx].polyStateChanged) continue;
+			Bit32u playingNotesCount = stateSnapshot.partStates[partIx].playingNotesCount;
+			uiState.partStates[partIx].playingNotesCount = playingNotesCount;
+			memcpy(uiState.partStates[partIx].keysOfPlayingNotes, stateSnapshot.partStates[partIx].keysOfPlayingNotes, playingNotesCount * sizeof(Bit8u));
+			memcpy(uiState.partStates[partIx].velocitiesOfPlayingNotes, stateSnapshot.partStates[partIx].velocitiesOfPlayingNotes, playingNotesCount * sizeof(Bit8u));
+		}
+		memcpy(uiState.partialStates, stateSnapshot.partialStates, sizeof(uiState.partialStates));
+	}
+
+	void reportDroppedEvents() {
+		int droppedImmediateMidiMessages = droppedImmediateMidiMessagesCount.fetchAndStoreRelaxed(0);
+		if (droppedImmediateMidiMessages > 0) {
+			qsynth.reportHandler.doShowWarning(QString("Immediate MIDI buffer overflow, %1 MIDI message(s) dropped.").arg(droppedImmediateMidiMessages));
+		}
+	}
+
+	void run() {
+		QMutexLocker renderCompleteLocker(&renderCompleteMutex);
 		QReportHandler &reportHandler = qsynth.reportHandler;
-		while (renderCompleteCondition.wait(&stateSnapshotMutex) && !stopProcessing) {
+		while (renderCompleteCondition.wait(&renderCompleteMutex) && !stopProcessing) {
+			reportDroppedEvents();
+			if (!retrieveStateSnapshot()) continue;
+			StateSnapshot &stateSnapshot = stateSnapshots[frontStateSnapshotIx];
+			updateUIState(stateSnapshot);
+			stateSnapshot.activityUpdated = false;
+
 			if (stateSnapshot.lcdMessage[0]) {
 				reportHandler.doShowLCDMessage(stateSnapshot.lcdMessage);
 				stateSnapshot.lcdMessage[0] = 0;
@@ -401,6 +761,10 @@ public:
 	RealtimeHelper(QSynth &useQSynth) :
 		qsynth(useQSynth),
 		stopProcessing(),
+		pendingSynthControlSlotCount(0),
+		synthControlCommandsPending(0),
+		droppedImmediateMidiMessagesCount(0),
+		activityQueried(0),
 		outputGain(qsynth.synth->getOutputGain()),
 		reverbOutputGain(qsynth.synth->getReverbOutputGain()),
 		reverbEnabled(!qsynth.synth->isReverbOverridden() || qsynth.synth->isReverbEnabled()),
@@ -411,20 +775,27 @@ public:
 		nicePartialMixingEnabled(qsynth.synth->isNicePartialMixingEnabled()),
 		emuDACInputMode(qsynth.synth->getDACInputMode()),
 		midiDelayMode(qsynth.synth->getMIDIDelayMode()),
+		renderingEnabled(qsynth.isOpen() && qsynth.sampleRateConverter != NULL),
+		renderingPassActive(0),
 		tempState(),
-		stateSnapshot()
+		stateSnapshots(),
+		backStateSnapshotIx(0),
+		frontStateSnapshotIx(1),
+		middleStateSnapshotIx(2),
+		uiState()
 	{
 		tempState.masterVolumeUpdate = NO_UPDATE_VALUE;
 		tempState.reverbMode = NO_UPDATE_VALUE;
 		tempState.reverbTime = NO_UPDATE_VALUE;
 		tempState.reverbLevel = NO_UPDATE_VALUE;
-		stateSnapshot.midiMessageLEDState = qsynth.synth->getDisplayState(stateSnapshot.lcdState);
-		for (int i = 0; i < PART_COUNT; i++) {
-			partVolumeOverride[i] = NO_UPDATE_VALUE;
-		}
-		for (int i = 0; i < VOICE_PART_COUNT; i++) {
-			partTimbres[i].changed = 0;
+		for (int i = 0; i < STATE_SNAPSHOT_COUNT; i++) {
+			stateSnapshots[i].masterVolumeUpdate = NO_UPDATE_VALUE;
+			stateSnapshots[i].reverbMode = NO_UPDATE_VALUE;
+			stateSnapshots[i].reverbTime = NO_UPDATE_VALUE;
+			stateSnapshots[i].reverbLevel = NO_UPDATE_VALUE;
 		}
+		uiState.midiMessageLEDState = qsynth.synth->getDisplayState(uiState.lcdState);
+		resetUIState();
 		{
 			makeSoundGroups(*qsynth.synth, soundGroupCache);
 			char memoryGroupName[SOUND_GROUP_NAME_LENGTH];
@@ -443,10 +814,10 @@ public:
 	}
 
 	~RealtimeHelper() {
-		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
+		QMutexLocker renderCompleteLocker(&renderCompleteMutex);
 		stopProcessing = true;
 		renderCompleteCondition.wakeOne();
-		stateSnapshotLocker.unlock();
+		renderCompleteLocker.unlock();
 		wait();
 	}
 
@@ -469,32 +840,31 @@ public:
 
 	void setMasterVolume(int useMasterVolume) {
 		QMutexLocker settingsLocker(&settingsMutex);
-		masterVolume = useMasterVolume;
-		enqueueSynthControlEvent(MASTER_VOLUME_CHANGED);
+		enqueueSynthControlEvent(MASTER_VOLUME_CHANGED, useMasterVolume);
 	}
 
 	void setOutputGain(float useOutputGain) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		outputGain = useOutputGain;
-		enqueueSynthControlEvent(OUTPUT_GAIN_CHANGED);
+		enqueueSynthControlEvent(OUTPUT_GAIN_CHANGED, useOutputGain);
 	}
 
 	void setReverbOutputGain(float useReverbOutputGain) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		reverbOutputGain = useReverbOutputGain;
-		enqueueSynthControlEvent(REVERB_OUTPUT_GAIN_CHANGED);
+		enqueueSynthControlEvent(REVERB_OUTPUT_GAIN_CHANGED, useReverbOutputGain);
 	}
 
 	void setReverbEnabled(bool useReverbEnabled) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		reverbEnabled = useReverbEnabled;
-		enqueueSynthControlEvent(REVERB_ENABLED_CHANGED);
+		enqueueSynthControlEvent(REVERB_ENABLED_CHANGED, useReverbEnabled);
 	}
 
 	void setReverbOverridden(bool useReverbOverridden) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		reverbOverridden = useReverbOverridden;
-		enqueueSynthControlEvent(REVERB_OVERRIDDEN_CHANGED);
+		enqueueSynthControlEvent(REVERB_OVERRIDDEN_CHANGED, useReverbOverridden);
 	}
 
 	void setReverbSettings(int useReverbMode, int useReverbTime, int useReverbLevel) {
@@ -502,63 +872,78 @@ public:
 		qsynth.reverbMode = useReverbMode;
 		qsynth.reverbTime = useReverbTime;
 		qsynth.reverbLevel = useReverbLevel;
-		enqueueSynthControlEvent(REVERB_SETTINGS_CHANGED);
+		enqueueSynthControlEvent(REVERB_SETTINGS_CHANGED, useReverbMode, useReverbTime, useReverbLevel);
+	}
+
+	void setReverbCompatibilityMode(bool mt32CompatibleReverb) {
+		QMutexLocker settingsLocker(&settingsMutex);
+		enqueueSynthControlEvent(REVERB_COMPATIBILITY_MODE_CHANGED, mt32CompatibleReverb);
 	}
 
 	void setPartVolumeOverride(uint partNumber, Bit8u volumeOverride) {
 		QMutexLocker settingsLocker(&settingsMutex);
-		partVolumeOverride[partNumber] = volumeOverride;
-		enqueueSynthControlEvent(PART_VOLUME_OVERRIDE_CHANGED);
+		enqueueSynthControlEvent(PART_VOLUME_OVERRIDE_CHANGED, partNumber, volumeOverride);
 	}
 
 	void setPartTimbre(uint partNumber, Bit8u timbreGroup, Bit8u timbreNumber) {
 		QMutexLocker settingsLocker(&settingsMutex);
-		partTimbres[partNumber].changed = 1;
-		partTimbres[partNumber].group = timbreGroup;
-		partTimbres[partNumber].number = timbreNumber;
-		enqueueSynthControlEvent(PART_TIMBRE_CHANGED);
+		enqueueSynthControlEvent(PART_TIMBRE_CHANGED, partNumber, timbreGroup, timbreNumber);
 	}
 
 	void setReversedStereoEnabled(bool useReversedStereoEnabled) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		reversedStereoEnabled = useReversedStereoEnabled;
-		enqueueSynthControlEvent(REVERSED_STEREO_ENABLED_CHANGED);
+		enqueueSynthControlEvent(REVERSED_STEREO_ENABLED_CHANGED, useReversedStereoEnabled);
 	}
 
 	void setNiceAmpRampEnabled(bool useNiceAmpRampEnabled) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		niceAmpRampEnabled = useNiceAmpRampEnabled;
-		enqueueSynthControlEvent(NICE_AMP_RAMP_ENABLED_CHANGED);
+		enqueueSynthControlEvent(NICE_AMP_RAMP_ENABLED_CHANGED, useNiceAmpRampEnabled);
 	}
 
 	void setNicePanningEnabled(bool useNicePanningEnabled) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		nicePanningEnabled = useNicePanningEnabled;
-		enqueueSynthControlEvent(NICE_PANNING_ENABLED_CHANGED);
+		enqueueSynthControlEvent(NICE_PANNING_ENABLED_CHANGED, useNicePanningEnabled);
 	}
 
 	void setNicePartialMixingEnabled(bool useNicePartialMixingEnabled) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		nicePartialMixingEnabled = useNicePartialMixingEnabled;
-		enqueueSynthControlEvent(NICE_PARTIAL_MIXING_ENABLED_CHANGED);
+		enqueueSynthControlEvent(NICE_PARTIAL_MIXING_ENABLED_CHANGED, useNicePartialMixingEnabled);
 	}
 
 	void setDACInputMode(DACInputMode useEmuDACInputMode) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		emuDACInputMode = useEmuDACInputMode;
-		enqueueSynthControlEvent(EMU_DAC_INPUT_MODE_CHANGED);
+		enqueueSynthControlEvent(EMU_DAC_INPUT_MODE_CHANGED, useEmuDACInputMode);
+	}
+
+	void setPartialLimit(int partialLimit) {
+		QMutexLocker settingsLocker(&settingsMutex);
+		enqueueSynthControlEvent(PARTIAL_LIMIT_CHANGED, partialLimit);
+	}
+
+	void setCPUBudget(int cpuBudget) {
+		QMutexLocker settingsLocker(&settingsMutex);
+		enqueueSynthControlEvent(CPU_BUDGET_CHANGED, cpuBudget);
 	}
 
 	void setMIDIDelayMode(MIDIDelayMode useMIDIDelayMode) {
 		QMutexLocker settingsLocker(&settingsMutex);
 		midiDelayMode = useMIDIDelayMode;
-		enqueueSynthControlEvent(MIDI_DELAY_MODE_CHANGED);
+		enqueueSynthControlEvent(MIDI_DELAY_MODE_CHANGED, useMIDIDelayMode);
 	}
 
 	void resetMidiChannelsAssignment(bool useMidiChannelsAssignmentChannel1Engaged) {
 		QMutexLocker settingsLocker(&settingsMutex);
-		midiChannelsAssignmentChannel1Engaged = useMidiChannelsAssignmentChannel1Engaged;
-		enqueueSynthControlEvent(MIDI_CHANNELS_ASSIGNMENT_RESET);
+		enqueueSynthControlEvent(MIDI_CHANNELS_ASSIGNMENT_RESET, useMidiChannelsAssignmentChannel1Engaged);
+	}
+
+	void flushMIDIQueue() {
+		QMutexLocker settingsLocker(&settingsMutex);
+		enqueueSynthControlEvent(MIDI_QUEUE_FLUSH);
 	}
 
 	void setMainDisplayMode() {
@@ -568,8 +953,8 @@ public:
 
 	void setDisplayCompatibilityMode(DisplayCompatibilityMode useDisplayCompatibilityMode) {
 		QMutexLocker settingsLocker(&settingsMutex);
-		displayCompatibilityMode = useDisplayCompatibilityMode;
-		enqueueSynthControlEvent(DISPLAY_COMPATIBILITY_MODE_CHANGED);
+		qsynth.displayCompatibilityMode = useDisplayCompatibilityMode;
+		enqueueSynthControlEvent(DISPLAY_COMPATIBILITY_MODE_CHANGED, useDisplayCompatibilityMode);
 	}
 
 	void resetSynth() {
@@ -577,47 +962,131 @@ public:
 		enqueueSynthControlEvent(SYNTH_RESET);
 	}
 
+	// The MIDI event queue of the synth requires no synchronisation with the rendering thread, so here we only serialise
+	// the producers. As the producer may be the rendering thread, it never waits for the synth to close. The lock is held
+	// by other producers for a single message only, while the message is dropped once the closing synth suspends rendering.
+	bool lockMIDIQueueRealtime() const {
+		while (!qsynth.midiMutex->tryLock()) {
+			if (!isRenderingEnabled()) return false;
+			yieldCurrentThread();
+		}
+		return true;
+	}
+
 	bool playMIDIShortMessageRealtime(Bit32u msg, quint64 timestamp) const {
-		RealtimeLocker midiLocker(*qsynth.midiMutex);
-		return midiLocker.isLocked() && qsynth.isOpen() && qsynth.synth->playMsg(msg, qsynth.convertOutputToSynthTimestamp(timestamp));
+		if (!isRenderingEnabled() || !lockMIDIQueueRealtime()) return false;
+		bool result = qsynth.isOpen() && qsynth.synth->playMsg(msg, qsynth.convertOutputToSynthTimestamp(timestamp));
+		qsynth.midiMutex->unlock();
+		return result;
 	}
 
 	bool playMIDISysexRealtime(const Bit8u *sysex, Bit32u sysexLen, quint64 timestamp) const {
-		RealtimeLocker midiLocker(*qsynth.midiMutex);
-		return midiLocker.isLocked() && qsynth.isOpen() && qsynth.synth->playSysex(sysex, sysexLen, qsynth.convertOutputToSynthTimestamp(timestamp));
+		if (!isRenderingEnabled() || !lockMIDIQueueRealtime()) return false;
+		bool result = qsynth.isOpen() && qsynth.synth->playSysex(sysex, sysexLen, qsynth.convertOutputToSynthTimestamp(timestamp));
+		qsynth.midiMutex->unlock();
+		return result;
+	}
+
+	void playMIDIShortMessageNowRealtime(Bit32u msg) {
+		QMutexLocker immediateMidiLocker(&immediateMidiMutex);
+		if (immediateMidiBuffer.pushShortMessage(0, msg)) {
+			immediateMidiBuffer.flush();
+		} else {
+			droppedImmediateMidiMessagesCount.fetchAndAddRelaxed(1);
+		}
+	}
+
+	void playMIDISysexNowRealtime(const Bit8u *sysex, Bit32u sysexLen) {
+		QMutexLocker immediateMidiLocker(&immediateMidiMutex);
+		if (immediateMidiBuffer.pushSysexMessage(0, sysexLen, sysex)) {
+			immediateMidiBuffer.flush();
+		} else {
+			droppedImmediateMidiMessagesCount.fetchAndAddRelaxed(1);
+		}
 	}
 
 	void renderRealtime(float *buffer, uint length) {
-		RealtimeLocker synthLocker(*qsynth.synthMutex);
-		if (synthLocker.isLocked() && qsynth.isOpen()) {
+		// Ordered operations ensure that either suspendRendering() observes this rendering pass, or we observe the suspension.
+		renderingPassActive.fetchAndStoreOrdered(1);
+		if (isRenderingEnabled()) {
+			// Notifications are collected directly from now on. Those deferred before switching to the realtime mode
+			// are delivered to us here, in the rendering thread.
+			if (qsynth.synth->isDeferredReportsEnabled()) qsynth.synth->setDeferredReportsEnabled(false);
 			applyChangesRealtime();
-			qsynth.sampleRateConverter->getOutputSamples(buffer, length);
+			playImmediateMIDIRealtime();
+			qsynth.renderLoadMeter->render(*qsynth.sampleRateConverter, qsynth.renderPipeline, *qsynth.synth, buffer, length);
 			saveStateRealtime();
+			renderingPassActive.fetchAndStoreOrdered(0);
 			renderCompleteCondition.wakeOne();
 		} else {
-			Synth::muteSampleBuffer(buffer, length);
+			renderingPassActive.fetchAndStoreOrdered(0);
+			Synth::muteSampleBuffer(buffer, 2 * length);
+		}
+	}
+
+	bool isRenderingEnabled() const {
+		return renderingEnabled.fetchAndAddOrdered(0) != 0;
+	}
+
+	// Invoked when the synth is about to close. Waits for the current rendering pass to complete, if any.
+	void suspendRendering() {
+		renderingEnabled.fetchAndStoreOrdered(0);
+		while (renderingPassActive.fetchAndAddOrdered(0) != 0) {
+			yieldCurrentThread();
+		}
+	}
+
+	// Invoked when the synth is opened, before rendering resumes.
+	void resumeRendering() {
+		resetUIState();
+		renderingEnabled.fetchAndStoreOrdered(1);
+	}
+
+	// Only invoked while rendering is impossible.
+	void resetUIState() {
+		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
+		uiState.active = qsynth.isOpen();
+		for (int partIx = 0; partIx < PART_COUNT; partIx++) {
+			const char *patchName = qsynth.isOpen() ? qsynth.synth->getPatchName(partIx) : NULL;
+			if (patchName == NULL) {
+				uiState.partStates[partIx].patchName[0] = 0;
+			} else {
+				memcpy(uiState.partStates[partIx].patchName, patchName, PATCH_NAME_LENGTH - 1);
+			}
 		}
 	}
 
 	void getPartialStates(PartialState *partialStates) {
 		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
 		if (!qsynth.isOpen()) return;
-		memcpy(partialStates, stateSnapshot.partialStates, qsynth.synth->getPartialCount() * sizeof(PartialState));
+		memcpy(partialStates, uiState.partialStates, qsynth.synth->getPartialCount() * sizeof(PartialState));
 	}
 
 	uint getPlayingNotes(uint partNumber, Bit8u *keys, Bit8u *velocities) {
 		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
 		if (!qsynth.isOpen()) return 0;
-		Bit32u playingNotesCount = stateSnapshot.partStates[partNumber].playingNotesCount;
-		memcpy(keys, stateSnapshot.partStates[partNumber].keysOfPlayingNotes, playingNotesCount * sizeof(Bit8u));
-		memcpy(velocities, stateSnapshot.partStates[partNumber].velocitiesOfPlayingNotes, playingNotesCount * sizeof(Bit8u));
+		Bit32u playingNotesCount = uiState.partStates[partNumber].playingNotesCount;
+		memcpy(keys, uiState.partStates[partNumber].keysOfPlayingNotes, playingNotesCount * sizeof(Bit8u));
+		memcpy(velocities, uiState.partStates[partNumber].velocitiesOfPlayingNotes, playingNotesCount * sizeof(Bit8u));
 		return playingNotesCount;
 	}
 
+	QString getPatchName(int partNum) {
+		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
+		return QString().fromLocal8Bit(uiState.partStates[partNum].patchName);
+	}
+
+	// Returns the activity state published most recently and requests the rendering thread to update it.
+	bool isActive() {
+		activityQueried.fetchAndStoreRelaxed(1);
+		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
+		return qsynth.isOpen() && uiState.active;
+	}
+
 	bool getDisplayState(char *targetBuffer) {
 		QMutexLocker stateSnapshotLocker(&stateSnapshotMutex);
-		memcpy(targetBuffer, stateSnapshot.lcdState, LCD_MESSAGE_LENGTH);
-		return stateSnapshot.midiMessageLEDState;
+		memcpy(targetBuffer, uiState.lcdState, LCD_MESSAGE_LENGTH);
+		return uiState.midiMessageLEDState;
 	}
 
 	const QVector<SoundGroup> &getSoundGroupCache() const {
@@ -664,8 +1133,18 @@ public:
 	}
 };
 
-QReportHandler::QReportHandler(QSynth *qsynth) : QObject(qsynth) {
+QReportHandler::QReportHandler(QSynth *qsynth) : QObject(qsynth), deferredReportsTimer(this) {
 	connect(this, SIGNAL(balloonMessageAppeared(const QString &, const QString &)), Master::getInstance(), SLOT(showBalloon(const QString &, const QString &)));
+	deferredReportsTimer.setInterval(DEFERRED_REPORTS_DISPATCH_PERIOD_MILLIS);
+	connect(&deferredReportsTimer, SIGNAL(timeout()), SLOT(dispatchDeferredReports()));
+	deferredReportsTimer.start();
+}
+
+// In the non-realtime mode, the synth records notifications while rendering, so that the audio thread
+// neither takes locks nor emits signals on our behalf. They are delivered here, in the GUI thread.
+// In the realtime mode, RealtimeHelper collects the notifications instead.
+void QReportHandler::dispatchDeferredReports() {
+	if (!qSynth()->isRealtime()) qSynth()->synth->dispatchDeferredReports();
 }
 
 void QReportHandler::printDebug(const char *fmt, va_list list) {
@@ -686,18 +1165,21 @@ void QReportHandler::showLCDMessage(const char *message) {
 }
 
 void QReportHandler::onErrorControlROM() {
-	QMessageBox::critical(NULL, "Cannot open Synth", "Control ROM file cannot be opened.");
+	Master::showCritical("Cannot open Synth", "Control ROM file cannot be opened.");
 }
 
 void QReportHandler::onErrorPCMROM() {
-	QMessageBox::critical(NULL, "Cannot open Synth", "PCM ROM file cannot be opened.");
+	Master::showCritical("Cannot open Synth", "PCM ROM file cannot be opened.");
 }
 
 void QReportHandler::onDeviceReconfig() {
-	int masterVolume = readMasterVolume(qSynth()->synth);
 	if (qSynth()->isRealtime()) {
-		qSynth()->realtimeHelper->onMasterVolumeChanged(masterVolume);
+		qSynth()->realtimeHelper->onMasterVolumeChanged(readMasterVolume(qSynth()->synth));
 	} else {
+		// Delivered in the GUI thread, concurrently with rendering.
+		QMutexLocker synthLocker(qSynth()->synthMutex);
+		int masterVolume = readMasterVolume(qSynth()->synth);
+		synthLocker.unlock();
 		emit masterVolumeChanged(masterVolume);
 	}
 }
@@ -769,6 +1251,11 @@ void QReportHandler::onMidiMessageLEDStateUpdated(bool ledState) {
 	}
 }
 
+void QReportHandler::doShowWarning(const QString &message) {
+	qWarning() << "QSynth:" << message;
+	emit balloonMessageAppeared("MT-32 Emulator warning:", message);
+}
+
 void QReportHandler::doShowLCDMessage(const char *message) {
 	qDebug() << "LCD-Message:" << message;
 	if (Master::getInstance()->getSettings()->value("Master/showLCDBalloons", true).toBool()) {
@@ -779,7 +1266,7 @@ void QReportHandler::doShowLCDMessage(const char *message) {
 QSynth::QSynth(QObject *parent) :
 	QObject(parent), state(SynthState_CLOSED), midiMutex(new QMutex), synthMutex(new QMutex),
 	controlROMImage(), pcmROMImage(), synth(), reportHandler(this), sampleRateConverter(),
-	audioRecorder(), realtimeHelper()
+	audioRecorder(), realtimeHelper(), renderLoadMeter(new RenderLoadMeter), renderPipeline()
 {
 	createSynth();
 }
@@ -787,8 +1274,10 @@ QSynth::QSynth(QObject *parent) :
 QSynth::~QSynth() {
 	freeROMImages();
 	delete realtimeHelper;
+	delete renderLoadMeter;
 	delete audioRecorder;
 	delete sampleRateConverter;
+	delete renderPipeline;
 	delete synth;
 	delete synthMutex;
 	delete midiMutex;
@@ -798,6 +1287,7 @@ void QSynth::createSynth() {
 	delete synth;
 	synth = new Synth;
 	synth->setReportHandler2(&reportHandler);
+	synth->setDeferredReportsEnabled(!isRealtime());
 }
 
 bool QSynth::isOpen() const {
@@ -805,17 +1295,29 @@ bool QSynth::isOpen() const {
 }
 
 void QSynth::flushMIDIQueue() const {
+	if (isRealtime()) {
+		realtimeHelper->flushMIDIQueue();
+		return;
+	}
 	QMutexLocker midiLocker(midiMutex);
 	QMutexLocker synthLocker(synthMutex);
 	synth->flushMIDIQueue();
 }
 
 void QSynth::playMIDIShortMessageNow(Bit32u msg) const {
+	if (isRealtime()) {
+		realtimeHelper->playMIDIShortMessageNowRealtime(msg);
+		return;
+	}
 	QMutexLocker synthLocker(synthMutex);
 	if (isOpen()) synth->playMsgNow(msg);
 }
 
 void QSynth::playMIDISysexNow(const Bit8u *sysex, Bit32u sysexLen) const {
+	if (isRealtime()) {
+		realtimeHelper->playMIDISysexNowRealtime(sysex, sysexLen);
+		return;
+	}
 	QMutexLocker synthLocker(synthMutex);
 	if (isOpen()) synth->playSysexNow(sysex, sysexLen);
 }
@@ -839,7 +1341,9 @@ bool QSynth::playMIDISysex(const Bit8u *sysex, Bit32u sysexLen, quint64 timestam
 }
 
 Bit32u QSynth::convertOutputToSynthTimestamp(quint64 timestamp) const {
-	return Bit32u(sampleRateConverter->convertOutputToSynthTimestamp(timestamp));
+	Bit32u synthTimestamp = Bit32u(sampleRateConverter->convertOutputToSynthTimestamp(timestamp));
+	if (renderPipeline != NULL) synthTimestamp += renderPipeline->getLatencyFrames();
+	return synthTimestamp;
 }
 
 void QSynth::render(Bit16s *buffer, uint length) {
@@ -852,7 +1356,7 @@ void QSynth::render(Bit16s *buffer, uint length) {
 		emit audioBlockRendered();
 		return;
 	}
-	sampleRateConverter->getOutputSamples(buffer, length);
+	renderLoadMeter->render(*sampleRateConverter, renderPipeline, *synth, buffer, length);
 	if (isRecordingAudio()) {
 		if (!audioRecorder->write(buffer, length)) stopRecordingAudio();
 	}
@@ -874,7 +1378,7 @@ void QSynth::render(float *buffer, uint length) {
 		emit audioBlockRendered();
 		return;
 	}
-	sampleRateConverter->getOutputSamples(buffer, length);
+	renderLoadMeter->render(*sampleRateConverter, renderPipeline, *synth, buffer, length);
 	synthLocker.unlock();
 	// TODO: Add support for recording to float WAVs
 	emit audioBlockRendered();
@@ -918,12 +1422,20 @@ bool QSynth::open(uint &targetSampleRate, SamplerateConversionQuality srcQuality
 	targetSampleRate = SampleRateConverter::getSupportedOutputSampleRate(targetSampleRate);
 
 	if (synth->open(*controlROMImage, *pcmROMImage, Bit32u(synthProfile.partialCount), actualAnalogOutputMode)) {
+		if (targetSampleRate == 0) targetSampleRate = getSynthSampleRate();
+		renderLoadMeter->reset(targetSampleRate);
 		setState(SynthState_OPEN);
 		reportHandler.onDeviceReconfig();
 		setSynthProfile(synthProfile, synthProfileName);
 		if (engageChannel1OnOpen) resetMIDIChannelsAssignment(true);
-		if (targetSampleRate == 0) targetSampleRate = getSynthSampleRate();
-		sampleRateConverter = new SampleRateConverter(*synth, targetSampleRate, srcQuality);
+		if (pipelinedRendering && targetSampleRate != getSynthSampleRate()) {
+			qDebug() << "QSynth: Using pipelined rendering";
+			renderPipeline = new RenderPipeline(*synth, targetSampleRate);
+			sampleRateConverter = new SampleRateConverter(*synth, targetSampleRate, srcQuality, *renderPipeline);
+		} else {
+			sampleRateConverter = new SampleRateConverter(*synth, targetSampleRate, srcQuality);
+		}
+		if (isRealtime()) realtimeHelper->resumeRendering();
 		return true;
 	}
 	createSynth();
@@ -1049,7 +1561,7 @@ void QSynth::setInitialMIDIChannelsAssignment(bool engageChannel1) {
 
 void QSynth::setReverbCompatibilityMode(ReverbCompatibilityMode useReverbCompatibilityMode) {
 	reverbCompatibilityMode = useReverbCompatibilityMode;
-	QMutexLocker synthLocker(synthMutex);
+	QMutexLocker synthLocker(isRealtime() ? NULL : synthMutex);
 	if (!isOpen()) return;
 	bool mt32CompatibleReverb;
 	if (useReverbCompatibilityMode == ReverbCompatibilityMode_DEFAULT) {
@@ -1057,7 +1569,12 @@ void QSynth::setReverbCompatibilityMode(ReverbCompatibilityMode useReverbCompati
 	} else {
 		mt32CompatibleReverb = useReverbCompatibilityMode == ReverbCompatibilityMode_MT32;
 	}
-	synth->setReverbCompatibilityMode(mt32CompatibleReverb);
+	if (isRealtime()) {
+		// Reverb models are recreated, which must not happen concurrently with rendering.
+		realtimeHelper->setReverbCompatibilityMode(mt32CompatibleReverb);
+	} else {
+		synth->setReverbCompatibilityMode(mt32CompatibleReverb);
+	}
 }
 
 void QSynth::setMIDIDelayMode(MIDIDelayMode midiDelayMode) {
@@ -1088,9 +1605,29 @@ void QSynth::setRendererType(RendererType useRendererType) {
 
 void QSynth::setPartialCount(int newPartialCount) {
 	partialCount = qBound(MIN_PARTIAL_COUNT, newPartialCount, MAX_PARTIAL_COUNT);
+	// Takes effect immediately within the number of partials the synth was opened with. Growing beyond requires re-open.
+	if (isRealtime()) {
+		realtimeHelper->setPartialLimit(partialCount);
+	} else {
+		QMutexLocker synthLocker(synthMutex);
+		if (isOpen()) synth->setPartialLimit(Bit32u(partialCount));
+	}
+}
+
+void QSynth::setCPUBudget(int newCPUBudget) {
+	cpuBudget = qBound(0, newCPUBudget, 100);
+	if (isRealtime()) {
+		realtimeHelper->setCPUBudget(cpuBudget);
+	} else {
+		QMutexLocker synthLocker(synthMutex);
+		if (isOpen()) synth->setCPUBudget(Bit32u(cpuBudget));
+	}
 }
 
 const QString QSynth::getPatchName(int partNum) const {
+	if (isRealtime() && isOpen()) {
+		return realtimeHelper->getPatchName(partNum);
+	}
 	QMutexLocker synthLocker(synthMutex);
 	QString name = isOpen() ? QString().fromLocal8Bit(synth->getPatchName(partNum)) : QString("Channel %1").arg(partNum + 1);
 	return name;
@@ -1142,6 +1679,9 @@ uint QSynth::getSynthSampleRate() const {
 }
 
 bool QSynth::isActive() const {
+	if (isRealtime()) {
+		return realtimeHelper->isActive();
+	}
 	QMutexLocker synthLocker(synthMutex);
 	return isOpen() && synth->isActive();
 }
@@ -1209,6 +1749,7 @@ void QSynth::setState(SynthState newState) {
 void QSynth::close() {
 	if (!isOpen()) return;
 	setState(SynthState_CLOSING);
+	if (isRealtime()) realtimeHelper->suspendRendering();
 	{
 		QMutexLocker midiLocker(midiMutex);
 		QMutexLocker synthLocker(synthMutex);
@@ -1217,6 +1758,8 @@ void QSynth::close() {
 		createSynth();
 		delete sampleRateConverter;
 		sampleRateConverter = NULL;
+		delete renderPipeline;
+		renderPipeline = NULL;
 	}
 	setState(SynthState_CLOSED);
 	freeROMImages();
@@ -1231,6 +1774,8 @@ void QSynth::getSynthProfile(SynthProfile &synthProfile) const {
 	synthProfile.analogOutputMode = analogOutputMode;
 	synthProfile.rendererType = synth->getSelectedRendererType();
 	synthProfile.partialCount = partialCount;
+	synthProfile.cpuBudget = cpuBudget;
+	synthProfile.pipelinedRendering = pipelinedRendering;
 	synthProfile.engageChannel1OnOpen = engageChannel1OnOpen;
 	synthProfile.reverbCompatibilityMode = reverbCompatibilityMode;
 	synthProfile.displayCompatibilityMode = displayCompatibilityMode;
@@ -1267,8 +1812,10 @@ void QSynth::setSynthProfile(const SynthProfile &synthProfile, QString useSynthP
 	setAnalogOutputMode(synthProfile.analogOutputMode);
 	setRendererType(synthProfile.rendererType);
 	setPartialCount(synthProfile.partialCount);
+	pipelinedRendering = synthProfile.pipelinedRendering;
 
 	// Settings below take effect immediately.
+	setCPUBudget(synthProfile.cpuBudget);
 	setReverbCompatibilityMode(synthProfile.reverbCompatibilityMode);
 	setMIDIDelayMode(synthProfile.midiDelayMode);
 	setDACInputMode(synthProfile.emuDACInputMode);
@@ -1306,7 +1853,9 @@ const QReportHandler *QSynth::getReportHandler() const {
 }
 
 void QSynth::startRecordingAudio(const QString &fileName) {
-	QMutexLocker synthLocker(synthMutex);
+	// In realtime mode, the rendering thread never accesses the audio recorder, and the sample rate conversion ratio
+	// is immutable while the synth is open, so there is nothing to synchronise with.
+	QMutexLocker synthLocker(isRealtime() ? NULL : synthMutex);
 	if (isRecordingAudio()) delete audioRecorder;
 	audioRecorder = new AudioFileWriter(sampleRateConverter->convertSynthToOutputTimestamp(SAMPLE_RATE), fileName);
 	audioRecorder->open();
@@ -10,6 +10,8 @@
 
 class AudioFileWriter;
 class RealtimeHelper;
+class RenderLoadMeter;
+class RenderPipeline;
 class QSynth;
 
 enum SynthState {
@@ -41,6 +43,8 @@ struct SynthProfile {
 	MT32Emu::AnalogOutputMode analogOutputMode;
 	MT32Emu::RendererType rendererType;
 	int partialCount;
+	int cpuBudget;
+	bool pipelinedRendering;
 	ReverbCompatibilityMode reverbCompatibilityMode;
 	float outputGain;
 	float reverbOutputGain;
@@ -92,10 +96,16 @@ public:
 	void onLCDStateUpdated();
 	void onMidiMessageLEDStateUpdated(bool ledState);
 	void doShowLCDMessage(const char *message);
+	void doShowWarning(const QString &message);
 
 private:
+	QTimer deferredReportsTimer;
+
 	QSynth *qSynth() { return (QSynth *)parent(); }
 
+private slots:
+	void dispatchDeferredReports();
+
 signals:
 	void balloonMessageAppeared(const QString &title, const QString &text);
 	void masterVolumeChanged(int);
@@ -137,6 +147,8 @@ private:
 	int reverbTime;
 	int reverbLevel;
 	int partialCount;
+	int cpuBudget;
+	bool pipelinedRendering;
 	MT32Emu::AnalogOutputMode analogOutputMode;
 	ReverbCompatibilityMode reverbCompatibilityMode;
 	bool engageChannel1OnOpen;
@@ -150,6 +162,8 @@ private:
 	AudioFileWriter *audioRecorder;
 
 	RealtimeHelper *realtimeHelper;
+	RenderLoadMeter *renderLoadMeter;
+	RenderPipeline *renderPipeline;
 
 	void setState(SynthState newState);
 	void freeROMImages();
@@ -200,6 +214,7 @@ public:
 	void setAnalogOutputMode(MT32Emu::AnalogOutputMode analogOutputMode);
 	void setRendererType(MT32Emu::RendererType useRendererType);
 	void setPartialCount(int partialCount);
+	void setCPUBudget(int cpuBudget);
 	const QString getPatchName(int partNum) const;
 	void setTimbreOnPart(uint partNumber, uint timbreGroup, uint timbreNumber);
 	void getSoundGroups(QVector<SoundGroup> &) const;
@@ -530,19 +530,19 @@ bool SynthRoute::isRecordingAudio() const {
 	return qSynth.isRecordingAudio();
 }
 
-void SynthRoute::startRecordingMidi() {
+void SynthRoute::startRecordingMidi(MasterClockNanos midiTick) {
 	for (int i = 0; i < midiSessions.size(); i++) {
 		midiSessions.at(i)->setMidiTrackRecorder(midiRecorder.addTrack());
 	}
-	midiRecorder.startRecording();
+	midiRecorder.startRecording(midiTick);
 }
 
 bool SynthRoute::stopRecordingMidi() {
 	return midiRecorder.stopRecording();
 }
 
-void SynthRoute::saveRecordedMidi(const QString &fileName, MasterClockNanos midiTick) {
-	if (!midiRecorder.saveSMF(fileName, midiTick)) {
+void SynthRoute::saveRecordedMidi(const QString &fileName) {
+	if (!midiRecorder.saveSMF(fileName)) {
 		qWarning() << "SynthRoute: Failed to write recorded MIDI data to file" << fileName;
 	}
 	for (int i = 0; i < midiSessions.size(); i++) {
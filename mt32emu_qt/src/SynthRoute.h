@@ -7,10 +7,9 @@
 #include "QSynth.h"
 #include "MasterClock.h"
 #include "MidiRecorder.h"
+#include "audiodrv/AudioDriver.h"
 
 class MidiSession;
-class AudioStream;
-class AudioDevice;
 
 enum SynthRouteState {
 	SynthRouteState_CLOSED,
@@ -19,7 +18,7 @@ enum SynthRouteState {
 	SynthRouteState_CLOSING
 };
 
-class SynthRoute : public QObject {
+class SynthRoute : public QObject, public AudioSource {
 	Q_OBJECT
 private:
 	typedef AudioStream *(*AudioStreamFactory)(const AudioDevice *, SynthRoute &, const uint, MidiSession *midiSession);
@@ -103,10 +102,10 @@ public:
 	void stopRecordingAudio();
 	bool isRecordingAudio() const;
 
-	void startRecordingMidi();
+	void startRecordingMidi(MasterClockNanos midiTick);
 	bool stopRecordingMidi();
 	bool isRecordingMidi() const;
-	void saveRecordedMidi(const QString &fileName, MasterClockNanos midiTick);
+	void saveRecordedMidi(const QString &fileName);
 
 	void addMidiSession(MidiSession *midiSession);
 	void removeMidiSession(MidiSession *midiSession);
@@ -255,11 +255,11 @@ void SynthWidget::on_midiRecord_clicked() {
 			QString fileName = QFileDialog::getSaveFileName(this, NULL, currentDir, "Standard MIDI files (*.mid)",
 				NULL, qFileDialogOptions);
 			if (!fileName.isEmpty()) currentDir = QDir(fileName).absolutePath();
-			synthRoute->saveRecordedMidi(fileName, MasterClock::NANOS_PER_MILLISECOND);
+			synthRoute->saveRecordedMidi(fileName);
 		}
 	} else {
 		ui->midiRecord->setText("Stop");
-		synthRoute->startRecordingMidi();
+		synthRoute->startRecordingMidi(MasterClock::NANOS_PER_MILLISECOND);
 	}
 }
 
@@ -28,8 +28,8 @@ static const unsigned int DEFAULT_CHUNK_MS = 16;
 static const unsigned int DEFAULT_AUDIO_LATENCY = 64;
 static const unsigned int DEFAULT_MIDI_LATENCY = 32;
 
-AlsaAudioStream::AlsaAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate) :
-  AudioStream(useSettings, useSynthRoute, useSampleRate), stream(NULL), processingThreadID(0), stopProcessing(false)
+AlsaAudioStream::AlsaAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate) :
+  AudioStream(useSettings, useAudioSource, useSampleRate), stream(NULL), processingThreadID(0), stopProcessing(false)
 {
 	bufferSize = settings.chunkLen * sampleRate / MasterClock::MILLIS_PER_SECOND;
 	buffer = new Bit16s[/* channels */ 2 * bufferSize];
@@ -78,7 +78,7 @@ void *AlsaAudioStream::processingThread(void *userData) {
 	if (isErrorOccurred) {
 		snd_pcm_close(audioStream.stream);
 		audioStream.stream = NULL;
-		audioStream.synthRoute.audioStreamFailed();
+		audioStream.audioSource.audioStreamFailed();
 	} else {
 		audioStream.stopProcessing = false;
 	}
@@ -174,8 +174,8 @@ void AlsaAudioStream::close() {
 
 AlsaAudioDevice::AlsaAudioDevice(AlsaAudioDriver &driver, const char *useDeviceID, const QString name) : AudioDevice(driver, name), deviceID(useDeviceID) {}
 
-AudioStream *AlsaAudioDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	AlsaAudioStream *stream = new AlsaAudioStream(driver.getAudioSettings(), synthRoute, sampleRate);
+AudioStream *AlsaAudioDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	AlsaAudioStream *stream = new AlsaAudioStream(driver.getAudioSettings(), audioSource, sampleRate);
 	if (stream->start(deviceID)) return stream;
 	delete stream;
 	return NULL;
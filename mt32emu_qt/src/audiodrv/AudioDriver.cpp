@@ -43,8 +43,8 @@ static inline void publishSnapshot(QAtomicInt &changeCount) {
 	QAtomicHelper::storeRelease(changeCount, (myChangeCount + 1U) & 0x7fffffffU);
 }
 
-AudioStream::AudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate) :
-	synthRoute(useSynthRoute), sampleRate(useSampleRate), settings(useSettings), lastEstimatedPlayedFramesCount(0),
+AudioStream::AudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate) :
+	audioSource(useAudioSource), sampleRate(useSampleRate), settings(useSettings), lastEstimatedPlayedFramesCount(0),
 	resetScheduled(true)
 {
 	audioLatencyFrames = settings.audioLatency * sampleRate / MasterClock::MILLIS_PER_SECOND;
@@ -85,7 +85,7 @@ quint64 AudioStream::computeMIDITimestamp(uint relativeFrameTime) const {
 // Only called from the rendering thread.
 void AudioStream::renderAndUpdateState(MT32Emu::Bit16s *buffer, const quint32 frameCount, const MasterClockNanos measuredNanos, const quint32 framesInAudioBuffer) {
 	updateTimeInfo(measuredNanos, framesInAudioBuffer);
-	synthRoute.render(buffer, frameCount);
+	audioSource.render(buffer, frameCount);
 	framesRendered(frameCount);
 }
 
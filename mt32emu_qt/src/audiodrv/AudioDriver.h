@@ -11,12 +11,22 @@
 #include "../MasterClock.h"
 
 class AudioDriver;
-class SynthRoute;
 struct AudioDriverSettings;
 
+// Produces audio data for an AudioStream. Normally, this is a SynthRoute,
+// yet an AudioMixer may feed a single AudioStream with output of several synth routes.
+class AudioSource {
+public:
+	virtual ~AudioSource() {}
+	virtual void render(MT32Emu::Bit16s *buffer, uint length) = 0;
+	virtual void render(float *buffer, uint length) = 0;
+	virtual void audioStreamFailed() = 0;
+	virtual void enableRealtimeMode() = 0;
+};
+
 class AudioStream {
 protected:
-	SynthRoute &synthRoute;
+	AudioSource &audioSource;
 	const quint32 sampleRate;
 	const AudioDriverSettings &settings;
 	quint32 audioLatencyFrames;
@@ -47,7 +57,7 @@ protected:
 	quint64 getRenderedFramesCount() const;
 
 public:
-	AudioStream(const AudioDriverSettings &settings, SynthRoute &synthRoute, const quint32 sampleRate);
+	AudioStream(const AudioDriverSettings &settings, AudioSource &audioSource, const quint32 sampleRate);
 	virtual ~AudioStream() {}
 	virtual quint64 estimateMIDITimestamp(const MasterClockNanos refNanos);
 	quint64 computeMIDITimestamp(uint relativeFrameTime) const;
@@ -60,7 +70,7 @@ public:
 
 	AudioDevice(AudioDriver &driver, const QString name);
 	virtual ~AudioDevice() {}
-	virtual AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const = 0;
+	virtual AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const = 0;
 };
 
 Q_DECLARE_METATYPE(const AudioDevice *)
@@ -25,8 +25,8 @@
 static const unsigned int DEFAULT_AUDIO_LATENCY = 150;
 static const unsigned int DEFAULT_MIDI_LATENCY = 200;
 
-AudioFileWriterStream::AudioFileWriterStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate) :
-	AudioStream(useSettings, useSynthRoute, useSampleRate) {}
+AudioFileWriterStream::AudioFileWriterStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate) :
+	AudioStream(useSettings, useAudioSource, useSampleRate) {}
 
 bool AudioFileWriterStream::start() {
 	static QString currentDir = NULL;
@@ -41,25 +41,30 @@ bool AudioFileWriterStream::start() {
 }
 
 void AudioFileWriterStream::audioStreamFailed() {
-	synthRoute.audioStreamFailed();
+	audioSource.audioStreamFailed();
 }
 
 void AudioFileWriterStream::render(qint16 *buffer, uint frameCount) {
 	// No need to update time info, we assume perfect timing.
-	synthRoute.render(buffer, frameCount);
+	audioSource.render(buffer, frameCount);
 	framesRendered(frameCount);
 }
 
 quint64 AudioFileWriterStream::estimateMIDITimestamp(const MasterClockNanos midiNanos) {
-	// We assume perfect timing with constant sample rate.
-	return quint64(((midiNanos - timeInfos[0].lastPlayedNanos) * sampleRate) / MasterClock::NANOS_PER_SECOND) + midiLatencyFrames;
+	// We assume perfect timing with constant sample rate, as the renderer follows the same clock reference.
+	MasterClockNanos nanosSinceStart = qMax(MasterClockNanos(0), midiNanos - getStartNanos());
+	return MasterClock::nanosToFrames(nanosSinceStart, sampleRate) + midiLatencyFrames;
+}
+
+MasterClockNanos AudioFileWriterStream::getStartNanos() const {
+	return timeInfos[0].lastPlayedNanos;
 }
 
 AudioFileWriterDevice::AudioFileWriterDevice(AudioFileWriterDriver &driver, QString useDeviceName) :
 	AudioDevice(driver, useDeviceName) {}
 
-AudioStream *AudioFileWriterDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	AudioFileWriterStream *stream = new AudioFileWriterStream(driver.getAudioSettings(), synthRoute, sampleRate);
+AudioStream *AudioFileWriterDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	AudioFileWriterStream *stream = new AudioFileWriterStream(driver.getAudioSettings(), audioSource, sampleRate);
 	if (stream->start()) {
 		return stream;
 	}
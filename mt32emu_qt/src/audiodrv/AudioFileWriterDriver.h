@@ -7,7 +7,6 @@
 #include "../AudioFileWriter.h"
 
 class Master;
-class SynthRoute;
 class AudioFileWriterDriver;
 class AudioFileWriterDevice;
 
@@ -16,8 +15,9 @@ private:
 	AudioFileRenderer writer;
 
 public:
-	AudioFileWriterStream(const AudioDriverSettings &settings, SynthRoute &useSynthRoute, const quint32 useSampleRate);
+	AudioFileWriterStream(const AudioDriverSettings &settings, AudioSource &useAudioSource, const quint32 useSampleRate);
 	quint64 estimateMIDITimestamp(const MasterClockNanos refNanos);
+	MasterClockNanos getStartNanos() const;
 	bool start();
 	void audioStreamFailed();
 	void render(qint16 *buffer, uint frameCount);
@@ -28,7 +28,7 @@ friend class AudioFileWriterDriver;
 private:
 	AudioFileWriterDevice(AudioFileWriterDriver &driver, QString useDeviceName);
 public:
-	AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const;
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
 };
 
 class AudioFileWriterDriver : public AudioDriver {
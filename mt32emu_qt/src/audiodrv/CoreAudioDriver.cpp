@@ -53,8 +53,8 @@ static QString cfStringToQString(CFStringRef string) {
 #endif
 }
 
-CoreAudioStream::CoreAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, quint32 useSampleRate) :
-	AudioStream(useSettings, useSynthRoute, useSampleRate), audioQueue(NULL)
+CoreAudioStream::CoreAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, quint32 useSampleRate) :
+	AudioStream(useSettings, useAudioSource, useSampleRate), audioQueue(NULL)
 {
 	const uint bufferSize = (settings.chunkLen * sampleRate) / MasterClock::MILLIS_PER_SECOND;
 	bufferByteSize = bufferSize << 2;
@@ -166,8 +166,8 @@ void CoreAudioStream::close() {
 CoreAudioDevice::CoreAudioDevice(CoreAudioDriver &driver, const QString uid, const QString name) :
 	AudioDevice(driver, name), uid(uid) {}
 
-AudioStream *CoreAudioDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	CoreAudioStream *stream = new CoreAudioStream(driver.getAudioSettings(), synthRoute, sampleRate);
+AudioStream *CoreAudioDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	CoreAudioStream *stream = new CoreAudioStream(driver.getAudioSettings(), audioSource, sampleRate);
 	if (stream->start(uid)) {
 		return (AudioStream *)stream;
 	}
@@ -6,7 +6,6 @@
 
 #include "AudioDriver.h"
 
-class SynthRoute;
 class Master;
 class CoreAudioDriver;
 
@@ -20,7 +19,7 @@ private:
 	static void renderOutputBuffer(void *userData, AudioQueueRef queue, AudioQueueBufferRef buffer);
 
 public:
-	CoreAudioStream(const AudioDriverSettings &settings, SynthRoute &synthRoute, const quint32 sampleRate);
+	CoreAudioStream(const AudioDriverSettings &settings, AudioSource &audioSource, const quint32 sampleRate);
 	~CoreAudioStream();
 	bool start(const QString deviceUid);
 	void close();
@@ -34,7 +33,7 @@ private:
 	CoreAudioDevice(CoreAudioDriver &driver, const QString uid = NULL, const QString name = "Default output device");
 
 public:
-	AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const;
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
 };
 
 class CoreAudioDriver : public AudioDriver {
@@ -14,8 +14,6 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <QMessageBox>
-
 #include "JACKAudioDriver.h"
 
 #include "../Master.h"
@@ -28,7 +26,7 @@ static const uint MINIMUM_JACK_BUFFER_COUNT = 2;
 static const uint FRAME_BYTE_SIZE = sizeof(float[CHANNEL_COUNT]);
 
 class JACKAudioProcessor : QThread {
-	SynthRoute &synthRoute;
+	AudioSource &audioSource;
 	Utility::QRingBuffer *buffer;
 	volatile bool stopProcessing;
 
@@ -63,15 +61,15 @@ class JACKAudioProcessor : QThread {
 			if (framesToRender == 0) {
 				bufferDataRetrievals.acquire(currentRetrievals + 1);
 			} else {
-				synthRoute.render(writePointer, framesToRender);
+				audioSource.render(writePointer, framesToRender);
 				buffer->advanceWritePointer(framesToRender * FRAME_BYTE_SIZE);
 			}
 		}
 	}
 
 public:
-	JACKAudioProcessor(SynthRoute &useSynthRoute) :
-		synthRoute(useSynthRoute),
+	JACKAudioProcessor(AudioSource &useAudioSource) :
+		audioSource(useAudioSource),
 		buffer(),
 		stopProcessing(),
 		pendingUpdateBufferSize()
@@ -124,8 +122,8 @@ public:
 	}
 };
 
-JACKAudioStream::JACKAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate) :
-	AudioStream(useSettings, useSynthRoute, useSampleRate),
+JACKAudioStream::JACKAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate) :
+	AudioStream(useSettings, useAudioSource, useSampleRate),
 	jackClient(new JACKClient),
 	buffer(),
 	processor(),
@@ -154,7 +152,7 @@ bool JACKAudioStream::start(MidiSession *midiSession) {
 		// Use prerendering to prevent the realtime thread from locking, yet to retain complete functionality.
 		// Additional latency of at least the JACK buffer length is introduced.
 		if (audioLatencyFrames < jackBufferSizeFrames) audioLatencyFrames = jackBufferSizeFrames;
-		processor = new JACKAudioProcessor(synthRoute);
+		processor = new JACKAudioProcessor(audioSource);
 		processor->reallocateBuffer(audioLatencyFrames);
 		processor->start();
 		qDebug() << "JACKAudioDriver: Configured prerendering audio buffer size (frames / s):"
@@ -174,7 +172,7 @@ bool JACKAudioStream::start(MidiSession *midiSession) {
 		// MIDI processing is synchronous, zero latency introduced
 		midiLatencyFrames = 0;
 		qDebug() << "JACKAudioDriver: Configured synchronous MIDI processing";
-		if (jackClient->isRealtimeProcessing()) synthRoute.enableRealtimeMode();
+		if (jackClient->isRealtimeProcessing()) audioSource.enableRealtimeMode();
 	}
 
 	return true;
@@ -193,7 +191,7 @@ bool JACKAudioStream::checkSampleRate(quint32 jackSampleRate) const {
 	if (jackSampleRate == sampleRate) return true;
 	qDebug() << "JACKAudioDriver: Sample rate mismatch: configured rate / JACK system rate:" << sampleRate
 		<< "/" << jackSampleRate;
-	QMessageBox::warning(NULL, "Error", "Sample rate configured for the synth doesn't match the JACK system sample rate");
+	Master::showWarning("Error", "Sample rate configured for the synth doesn't match the JACK system sample rate");
 	return false;
 }
 
@@ -210,7 +208,7 @@ void JACKAudioStream::onJACKBufferSizeChange(const quint32 newBufferSize) {
 
 void JACKAudioStream::onJACKShutdown() {
 	qDebug() << "JACKAudioDriver: JACK server is shutting down, closing synth";
-	synthRoute.audioStreamFailed();
+	audioSource.audioStreamFailed();
 }
 
 void JACKAudioStream::renderStreams(const quint32 totalFrameCount, JACKAudioSample *leftOutBuffer, JACKAudioSample *rightOutBuffer) {
@@ -240,7 +238,7 @@ void JACKAudioStream::renderStreams(const quint32 totalFrameCount, JACKAudioSamp
 		} else {
 			bufferPtr = buffer;
 			framesToRender = qMin(framesLeft, MT32Emu::MAX_SAMPLES_PER_RUN);
-			synthRoute.render(buffer, framesToRender);
+			audioSource.render(buffer, framesToRender);
 		}
 		for (JACKAudioSample *leftOutBufferEnd = leftOutBuffer + framesToRender; leftOutBuffer < leftOutBufferEnd;) {
 			*(leftOutBuffer++) = JACKAudioSample(*(bufferPtr++));
@@ -256,8 +254,8 @@ JACKAudioDefaultDevice::JACKAudioDefaultDevice(JACKAudioDriver &useDriver) :
 	AudioDevice(useDriver, "Default")
 {}
 
-AudioStream *JACKAudioDefaultDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	return startAudioStream(this, synthRoute, sampleRate, NULL);
+AudioStream *JACKAudioDefaultDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	return startAudioStream(this, audioSource, sampleRate, NULL);
 }
 
 AudioStream *JACKAudioDefaultDevice::startAudioStream(const AudioDevice *audioDevice, SynthRoute &synthRoute, const uint sampleRate, MidiSession *midiSession) {
@@ -16,7 +16,7 @@ class MidiSession;
 
 class JACKAudioStream : public AudioStream {
 public:
-	JACKAudioStream(const AudioDriverSettings &useSettings, SynthRoute &synthRoute, const quint32 useSampleRate);
+	JACKAudioStream(const AudioDriverSettings &useSettings, AudioSource &audioSource, const quint32 useSampleRate);
 	~JACKAudioStream();
 	bool start(MidiSession *midiSession);
 	void stop();
@@ -37,7 +37,7 @@ class JACKAudioDefaultDevice : public AudioDevice {
 public:
 	static AudioStream *startAudioStream(const AudioDevice *audioDevice, SynthRoute &synthRoute, const uint sampleRate, MidiSession *midiSession);
 
-	AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const;
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
 
 private:
 	JACKAudioDefaultDevice(JACKAudioDriver &driver);
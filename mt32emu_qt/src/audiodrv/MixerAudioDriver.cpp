@@ -0,0 +1,214 @@
+/* Copyright (C) 2011-2022 Jerome Fisher, Sergey V. Mikayev
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include "MixerAudioDriver.h"
+
+using namespace MT32Emu;
+
+AudioMixer::AudioMixer(const AudioDevice &targetDevice, const uint useSampleRate) :
+	targetDriverId(targetDevice.driver.id), targetDeviceName(targetDevice.name), sampleRate(useSampleRate),
+	targetStream(NULL), mixedFramesCount(0), failed(false)
+{}
+
+AudioMixer::~AudioMixer() {
+	delete targetStream;
+}
+
+bool AudioMixer::start(const AudioDevice &targetDevice) {
+	qDebug() << "AudioMixer: Opening shared stream on" << targetDevice.driver.name << targetDevice.name;
+	targetStream = targetDevice.startAudioStream(*this, sampleRate);
+	return targetStream != NULL;
+}
+
+bool AudioMixer::isTargetDevice(const AudioDevice &targetDevice, const uint useSampleRate) const {
+	// Device objects are recreated each time the devices are scanned, so compare the identity instead.
+	return targetDriverId == targetDevice.driver.id && targetDeviceName == targetDevice.name && sampleRate == useSampleRate;
+}
+
+// Only called from the application thread.
+bool AudioMixer::addInput(MixerAudioStream *input, quint64 &framesOffset) {
+	QMutexLocker inputsLocker(&inputsMutex);
+	if (failed) return false;
+	framesOffset = mixedFramesCount;
+	inputs.append(input);
+	qDebug() << "AudioMixer: Added input, total inputs:" << inputs.size();
+	return true;
+}
+
+// Only called from the application thread.
+void AudioMixer::removeInput(MixerAudioStream *input) {
+	QMutexLocker inputsLocker(&inputsMutex);
+	if (inputs.removeOne(input)) qDebug() << "AudioMixer: Removed input, total inputs:" << inputs.size();
+}
+
+// Only called from the application thread, the only one that modifies the list of inputs.
+bool AudioMixer::hasInputs() const {
+	return !inputs.isEmpty();
+}
+
+// Intended to be called from MIDI receiving threads. The target stream outlives any input, hence no locking.
+quint64 AudioMixer::estimateMIDITimestamp(const MasterClockNanos midiNanos) {
+	return targetStream->estimateMIDITimestamp(midiNanos);
+}
+
+// Only called from the rendering thread.
+void AudioMixer::mix(float *buffer, uint length) {
+	const uint sampleCount = length << 1;
+	memset(buffer, 0, sampleCount * sizeof(float));
+	if (inputBuffer.size() < int(sampleCount)) inputBuffer.resize(sampleCount);
+	QMutexLocker inputsLocker(&inputsMutex);
+	for (int i = 0; i < inputs.size(); i++) {
+		inputs.at(i)->mix(buffer, inputBuffer.data(), length);
+	}
+	mixedFramesCount += length;
+}
+
+void AudioMixer::render(Bit16s *buffer, uint length) {
+	const uint sampleCount = length << 1;
+	if (mixBuffer.size() < int(sampleCount)) mixBuffer.resize(sampleCount);
+	float *mixedSamples = mixBuffer.data();
+	mix(mixedSamples, length);
+	// The inputs are summed in float, so that the sample values are only clipped once here.
+	for (const float *mixedSamplesEnd = mixedSamples + sampleCount; mixedSamples < mixedSamplesEnd;) {
+		*(buffer++) = Synth::convertSample(*(mixedSamples++));
+	}
+}
+
+void AudioMixer::render(float *buffer, uint length) {
+	mix(buffer, length);
+}
+
+// Called from the rendering thread when the target stream stops unexpectedly.
+void AudioMixer::audioStreamFailed() {
+	QMutexLocker inputsLocker(&inputsMutex);
+	failed = true;
+	for (int i = 0; i < inputs.size(); i++) {
+		inputs.at(i)->audioStreamFailed();
+	}
+}
+
+void AudioMixer::enableRealtimeMode() {
+	QMutexLocker inputsLocker(&inputsMutex);
+	for (int i = 0; i < inputs.size(); i++) {
+		inputs.at(i)->enableRealtimeMode();
+	}
+}
+
+MixerAudioStream::MixerAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate, MixerAudioDriver &useMixerDriver, AudioMixer &useMixer) :
+	AudioStream(useSettings, useAudioSource, useSampleRate), mixerDriver(useMixerDriver), mixer(useMixer), framesOffset(0)
+{}
+
+MixerAudioStream::~MixerAudioStream() {
+	mixerDriver.releaseMixer(&mixer, this);
+}
+
+bool MixerAudioStream::start() {
+	return mixer.addInput(this, framesOffset);
+}
+
+// Only called from the rendering thread of the mixer.
+void MixerAudioStream::mix(float *mixBuffer, float *inputBuffer, uint length) {
+	audioSource.render(inputBuffer, length);
+	for (float *mixBufferEnd = mixBuffer + (length << 1); mixBuffer < mixBufferEnd;) {
+		*(mixBuffer++) += *(inputBuffer++);
+	}
+	framesRendered(length);
+}
+
+void MixerAudioStream::audioStreamFailed() {
+	audioSource.audioStreamFailed();
+}
+
+void MixerAudioStream::enableRealtimeMode() {
+	audioSource.enableRealtimeMode();
+}
+
+quint64 MixerAudioStream::estimateMIDITimestamp(const MasterClockNanos midiNanos) {
+	quint64 timestamp = mixer.estimateMIDITimestamp(midiNanos);
+	return timestamp < framesOffset ? 0 : timestamp - framesOffset;
+}
+
+MixerAudioDevice::MixerAudioDevice(MixerAudioDriver &useDriver, const AudioDevice *useTargetDevice) :
+	AudioDevice(useDriver, useTargetDevice->driver.name + ": " + useTargetDevice->name), targetDevice(useTargetDevice)
+{}
+
+MixerAudioDevice::~MixerAudioDevice() {
+	delete targetDevice;
+}
+
+AudioStream *MixerAudioDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	MixerAudioDriver &mixerDriver = static_cast<MixerAudioDriver &>(driver);
+	AudioMixer *mixer = mixerDriver.openMixer(*targetDevice, sampleRate);
+	if (mixer == NULL) return NULL;
+	MixerAudioStream *stream = new MixerAudioStream(driver.getAudioSettings(), audioSource, sampleRate, mixerDriver, *mixer);
+	if (stream->start()) return stream;
+	delete stream;
+	return NULL;
+}
+
+MixerAudioDriver::MixerAudioDriver(Master *master, const QList<AudioDriver *> &useTargetDrivers) :
+	AudioDriver("mixer", "Shared Mixer"), targetDrivers(useTargetDrivers)
+{
+	Q_UNUSED(master);
+
+	loadAudioSettings();
+}
+
+MixerAudioDriver::~MixerAudioDriver() {
+	// Normally, all the mixers are released along with the synth routes by now.
+	qDeleteAll(mixers);
+}
+
+const QList<const AudioDevice *> MixerAudioDriver::createDeviceList() {
+	QList<const AudioDevice *> deviceList;
+	foreach (AudioDriver *targetDriver, targetDrivers) {
+		foreach (const AudioDevice *targetDevice, targetDriver->createDeviceList()) {
+			deviceList.append(new MixerAudioDevice(*this, targetDevice));
+		}
+	}
+	return deviceList;
+}
+
+AudioMixer *MixerAudioDriver::openMixer(const AudioDevice &targetDevice, const uint sampleRate) {
+	foreach (AudioMixer *mixer, mixers) {
+		if (mixer->isTargetDevice(targetDevice, sampleRate)) return mixer;
+	}
+	AudioMixer *mixer = new AudioMixer(targetDevice, sampleRate);
+	if (!mixer->start(targetDevice)) {
+		qDebug() << "MixerAudioDriver: Failed to open shared stream";
+		delete mixer;
+		return NULL;
+	}
+	mixers.append(mixer);
+	return mixer;
+}
+
+void MixerAudioDriver::releaseMixer(AudioMixer *mixer, MixerAudioStream *input) {
+	mixer->removeInput(input);
+	if (mixer->hasInputs()) return;
+	qDebug() << "MixerAudioDriver: Closing shared stream";
+	mixers.removeOne(mixer);
+	delete mixer;
+}
+
+void MixerAudioDriver::validateAudioSettings(AudioDriverSettings &newSettings) const {
+	// Buffering and timing are defined by the settings of the target audio driver.
+	newSettings.chunkLen = 0;
+	newSettings.audioLatency = 0;
+	newSettings.midiLatency = 0;
+}
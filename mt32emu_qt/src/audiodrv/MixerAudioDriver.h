@@ -0,0 +1,88 @@
+#ifndef MIXER_AUDIO_DRIVER_H
+#define MIXER_AUDIO_DRIVER_H
+
+#include <QtCore>
+
+#include "AudioDriver.h"
+
+class Master;
+class MixerAudioDriver;
+class MixerAudioStream;
+
+// Sums output of several synth routes and feeds the result to a single stream opened on the target audio device.
+// The inputs are rendered in turn in the rendering thread of that stream and share its MIDI timing estimation.
+class AudioMixer : public AudioSource {
+public:
+	AudioMixer(const AudioDevice &targetDevice, const uint sampleRate);
+	~AudioMixer();
+	bool start(const AudioDevice &targetDevice);
+	bool isTargetDevice(const AudioDevice &targetDevice, const uint sampleRate) const;
+	bool addInput(MixerAudioStream *input, quint64 &framesOffset);
+	void removeInput(MixerAudioStream *input);
+	bool hasInputs() const;
+	quint64 estimateMIDITimestamp(const MasterClockNanos midiNanos);
+
+	void render(MT32Emu::Bit16s *buffer, uint length);
+	void render(float *buffer, uint length);
+	void audioStreamFailed();
+	void enableRealtimeMode();
+
+private:
+	const QString targetDriverId;
+	const QString targetDeviceName;
+	const uint sampleRate;
+	AudioStream *targetStream;
+	// Protects the list of inputs and the rendering state against concurrent access from the application thread.
+	QMutex inputsMutex;
+	QList<MixerAudioStream *> inputs;
+	quint64 mixedFramesCount;
+	bool failed;
+	QVector<float> mixBuffer;
+	QVector<float> inputBuffer;
+
+	void mix(float *buffer, uint length);
+};
+
+class MixerAudioStream : public AudioStream {
+private:
+	MixerAudioDriver &mixerDriver;
+	AudioMixer &mixer;
+	// Position of the mixer output when this input was added, the MIDI timestamps of the synth count from there.
+	quint64 framesOffset;
+
+public:
+	MixerAudioStream(const AudioDriverSettings &settings, AudioSource &audioSource, const quint32 sampleRate, MixerAudioDriver &mixerDriver, AudioMixer &mixer);
+	~MixerAudioStream();
+	bool start();
+	void mix(float *mixBuffer, float *inputBuffer, uint length);
+	void audioStreamFailed();
+	void enableRealtimeMode();
+	quint64 estimateMIDITimestamp(const MasterClockNanos midiNanos);
+};
+
+class MixerAudioDevice : public AudioDevice {
+friend class MixerAudioDriver;
+	const AudioDevice * const targetDevice;
+
+	MixerAudioDevice(MixerAudioDriver &driver, const AudioDevice *targetDevice);
+public:
+	~MixerAudioDevice();
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
+};
+
+class MixerAudioDriver : public AudioDriver {
+private:
+	const QList<AudioDriver *> targetDrivers;
+	QList<AudioMixer *> mixers;
+
+	void validateAudioSettings(AudioDriverSettings &settings) const;
+
+public:
+	MixerAudioDriver(Master *useMaster, const QList<AudioDriver *> &useTargetDrivers);
+	~MixerAudioDriver();
+	const QList<const AudioDevice *> createDeviceList();
+	AudioMixer *openMixer(const AudioDevice &targetDevice, const uint sampleRate);
+	void releaseMixer(AudioMixer *mixer, MixerAudioStream *input);
+};
+
+#endif
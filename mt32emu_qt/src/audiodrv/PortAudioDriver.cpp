@@ -66,8 +66,8 @@ static void dumpPortAudioDevices() {
 	}
 }
 
-PortAudioStream::PortAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, quint32 useSampleRate) :
-  AudioStream(useSettings, useSynthRoute, useSampleRate), stream(NULL) {}
+PortAudioStream::PortAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, quint32 useSampleRate) :
+  AudioStream(useSettings, useAudioSource, useSampleRate), stream(NULL) {}
 
 PortAudioStream::~PortAudioStream() {
 	close();
@@ -160,8 +160,8 @@ void PortAudioStream::close() {
 PortAudioDevice::PortAudioDevice(PortAudioDriver &driver, int useDeviceIndex, QString useDeviceName) :
   AudioDevice(driver, useDeviceName), deviceIndex(useDeviceIndex) {}
 
-AudioStream *PortAudioDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	PortAudioStream *stream = new PortAudioStream(driver.getAudioSettings(), synthRoute, sampleRate);
+AudioStream *PortAudioDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	PortAudioStream *stream = new PortAudioStream(driver.getAudioSettings(), audioSource, sampleRate);
 	if (stream->start(deviceIndex)) {
 		return stream;
 	}
@@ -127,8 +127,8 @@ static bool loadLibrary(bool loadNeeded) {
 	return true;
 }
 
-PulseAudioStream::PulseAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate) :
-	AudioStream(useSettings, useSynthRoute, useSampleRate), stream(NULL), processingThreadID(0), stopProcessing(false)
+PulseAudioStream::PulseAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate) :
+	AudioStream(useSettings, useAudioSource, useSampleRate), stream(NULL), processingThreadID(0), stopProcessing(false)
 {
 	bufferSize = settings.chunkLen * sampleRate / MasterClock::MILLIS_PER_SECOND;
 	buffer = new Bit16s[/* channels */ 2 * bufferSize];
@@ -157,7 +157,7 @@ void *PulseAudioStream::processingThread(void *userData) {
 			_pa_simple_free(audioStream.stream);
 			audioStream.stream = NULL;
 			qDebug() << "PulseAudio: Processing thread stopped";
-			audioStream.synthRoute.audioStreamFailed();
+			audioStream.audioSource.audioStreamFailed();
 			audioStream.processingThreadID = 0;
 			return NULL;
 		}
@@ -246,8 +246,8 @@ void PulseAudioStream::close() {
 
 PulseAudioDefaultDevice::PulseAudioDefaultDevice(PulseAudioDriver &driver) : AudioDevice(driver, "Default") {}
 
-AudioStream *PulseAudioDefaultDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	PulseAudioStream *stream = new PulseAudioStream(driver.getAudioSettings(), synthRoute, sampleRate);
+AudioStream *PulseAudioDefaultDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	PulseAudioStream *stream = new PulseAudioStream(driver.getAudioSettings(), audioSource, sampleRate);
 	if (stream->start()) return stream;
 	delete stream;
 	return NULL;
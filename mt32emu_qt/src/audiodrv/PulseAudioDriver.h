@@ -10,7 +10,6 @@
 #include "AudioDriver.h"
 
 class Master;
-class SynthRoute;
 class PulseAudioDriver;
 
 class PulseAudioStream : public AudioStream {
@@ -24,7 +23,7 @@ private:
 	static void *processingThread(void *);
 
 public:
-	PulseAudioStream(const AudioDriverSettings &settings, SynthRoute &synthRoute, const quint32 sampleRate);
+	PulseAudioStream(const AudioDriverSettings &settings, AudioSource &audioSource, const quint32 sampleRate);
 	~PulseAudioStream();
 	bool start();
 	void close();
@@ -34,7 +33,7 @@ class PulseAudioDefaultDevice : public AudioDevice {
 friend class PulseAudioDriver;
 	PulseAudioDefaultDevice(PulseAudioDriver &driver);
 public:
-	AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const;
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
 };
 
 class PulseAudioDriver : public AudioDriver {
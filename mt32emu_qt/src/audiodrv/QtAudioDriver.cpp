@@ -79,8 +79,8 @@ public:
 	}
 };
 
-QtAudioStream::QtAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate) :
-	AudioStream(useSettings, useSynthRoute, useSampleRate)
+QtAudioStream::QtAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate) :
+	AudioStream(useSettings, useAudioSource, useSampleRate)
 {
 	// Creating QAudioOutput in a thread leads to smooth rendering
 	// Rendering will be performed in the main thread otherwise
@@ -137,8 +137,8 @@ void QtAudioStream::close() {
 
 QtAudioDefaultDevice::QtAudioDefaultDevice(QtAudioDriver &driver) : AudioDevice(driver, "Default") {}
 
-AudioStream *QtAudioDefaultDevice::startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const {
-	return new QtAudioStream(driver.getAudioSettings(), synthRoute, sampleRate);
+AudioStream *QtAudioDefaultDevice::startAudioStream(AudioSource &audioSource, const uint sampleRate) const {
+	return new QtAudioStream(driver.getAudioSettings(), audioSource, sampleRate);
 }
 
 QtAudioDriver::QtAudioDriver(Master *useMaster) : AudioDriver("qtaudio", "QtAudio") {
@@ -9,7 +9,6 @@
 
 class Master;
 class WaveGenerator;
-class SynthRoute;
 class QAudioOutput;
 class QAudioSink;
 class QtAudioDriver;
@@ -26,7 +25,7 @@ private:
 	WaveGenerator *waveGenerator;
 
 public:
-	QtAudioStream(const AudioDriverSettings &useSettings, SynthRoute &useSynthRoute, const quint32 useSampleRate);
+	QtAudioStream(const AudioDriverSettings &useSettings, AudioSource &useAudioSource, const quint32 useSampleRate);
 	~QtAudioStream();
 	void start();
 	void close();
@@ -37,7 +36,7 @@ class QtAudioDefaultDevice : public AudioDevice {
 private:
 	QtAudioDefaultDevice(QtAudioDriver &driver);
 public:
-	AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const;
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
 };
 
 class QtAudioDriver : public AudioDriver {
@@ -13,7 +13,6 @@
 #endif
 
 class Master;
-class SynthRoute;
 class WinMMAudioDriver;
 class WinMMAudioDevice;
 class WinMMAudioStream;
@@ -48,7 +47,7 @@ private:
 	DWORD getCurrentPlayPosition();
 
 public:
-	WinMMAudioStream(const AudioDriverSettings &useSettings, bool ringBufferMode, SynthRoute &synthRoute, uint useSampleRate);
+	WinMMAudioStream(const AudioDriverSettings &useSettings, bool ringBufferMode, AudioSource &audioSource, uint useSampleRate);
 	~WinMMAudioStream();
 	bool start(int deviceIndex);
 	void close();
@@ -60,7 +59,7 @@ private:
 	UINT deviceIndex;
 	WinMMAudioDevice(WinMMAudioDriver &driver, int useDeviceIndex, QString useDeviceName);
 public:
-	AudioStream *startAudioStream(SynthRoute &synthRoute, const uint sampleRate) const;
+	AudioStream *startAudioStream(AudioSource &audioSource, const uint sampleRate) const;
 };
 
 class WinMMAudioDriver : public AudioDriver {
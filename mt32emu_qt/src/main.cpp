@@ -17,10 +17,65 @@
 #include <clocale>
 #include <QApplication>
 
+#ifndef _WIN32
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <QSocketNotifier>
+#endif
+
 #include "MainWindow.h"
 #include "Master.h"
 
+#ifndef _WIN32
+
+static int quitSignalPipe[2];
+
+static void handleQuitSignal(int) {
+	// Only async-signal-safe functions may be used here, so the main thread is merely woken up to quit the application.
+	char signalled = 1;
+	ssize_t written = write(quitSignalPipe[1], &signalled, 1);
+	(void)written;
+}
+
+// Makes SIGINT and SIGTERM quit the event loop gracefully, so that the running synths are closed properly on exit.
+static void installQuitSignalHandlers(QCoreApplication &app) {
+	if (pipe(quitSignalPipe) != 0) return;
+	QSocketNotifier *quitSignalNotifier = new QSocketNotifier(quitSignalPipe[0], QSocketNotifier::Read, &app);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QObject::connect(quitSignalNotifier, SIGNAL(activated(int)), &app, SLOT(quit()));
+#else
+	QObject::connect(quitSignalNotifier, SIGNAL(activated(QSocketDescriptor, QSocketNotifier::Type)), &app, SLOT(quit()));
+#endif
+	struct sigaction action;
+	memset(&action, 0, sizeof action);
+	action.sa_handler = handleQuitSignal;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+}
+
+#endif // #ifndef _WIN32
+
 int main(int argv, char **args) {
+	if (Master::isHeadlessModeRequested(argv, args)) {
+		QCoreApplication app(argv, args);
+		app.setApplicationName("Munt mt32emu-qt");
+#ifndef _WIN32
+		installQuitSignalHandlers(app);
+#endif
+		setlocale(LC_ALL, "");
+		Master master(true);
+		QObject::connect(&master, SIGNAL(maxSessionsFinished()), &app, SLOT(quit()), Qt::QueuedConnection);
+		if (argv < 2 || master.processCommandLine(app.arguments())) {
+			master.startPinnedSynthRoute();
+			master.startMidiProcessing();
+			master.startStatusReporting();
+			app.exec();
+		}
+		return 0;
+	}
 #if (QT_VERSION_CHECK(5, 6, 0) <= QT_VERSION && QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
 	QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 #endif
@@ -67,6 +67,7 @@ void ALSAMidiDriver::processSeqEvents() {
 		if ((revents & POLLIN) == 0) {
 			continue;
 		}
+		syncQueueClock();
 		snd_seq_event_t *seq_event = NULL;
 		do {
 			int status = snd_seq_event_input(snd_seq, &seq_event);
@@ -134,8 +135,29 @@ MidiSession *ALSAMidiDriver::findMidiSessionForClient(unsigned int clientAddr) {
 	return midiSessions.at(i);
 }
 
+void ALSAMidiDriver::syncQueueClock() {
+	if (seqQueue < 0) return;
+	snd_seq_queue_status_t *queueStatus;
+	snd_seq_queue_status_alloca(&queueStatus);
+	MasterClockNanos nanosBefore = MasterClock::getClockNanos();
+	if (snd_seq_get_queue_status(snd_seq, seqQueue, queueStatus) < 0) return;
+	MasterClockNanos nanosAfter = MasterClock::getClockNanos();
+	const snd_seq_real_time_t *queueTime = snd_seq_queue_status_get_real_time(queueStatus);
+	MasterClockNanos queueNanos = queueTime->tv_sec * MasterClock::NANOS_PER_SECOND + queueTime->tv_nsec;
+	queueClockSync.update(queueNanos, nanosBefore, nanosAfter);
+}
+
+MasterClockNanos ALSAMidiDriver::getEventTimestamp(const snd_seq_event_t *seq_event) {
+	MasterClockNanos nanosNow = MasterClock::getClockNanos();
+	// Events are stamped by the sequencer when delivered to our port, so that the timing doesn't depend on when this thread wakes up.
+	if (seqQueue < 0 || seq_event->queue != seqQueue || !snd_seq_ev_is_real(seq_event)) return nanosNow;
+	MasterClockNanos eventNanos = seq_event->time.time.tv_sec * MasterClock::NANOS_PER_SECOND + seq_event->time.time.tv_nsec;
+	return queueClockSync.toClockNanos(eventNanos, nanosNow);
+}
+
 bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *midiSession) {
 	SynthRoute *synthRoute = midiSession->getSynthRoute();
+	MasterClockNanos eventTimestamp = getEventTimestamp(seq_event);
 	MT32Emu::Bit32u msg = 0;
 	switch(seq_event->type) {
 	case SND_SEQ_EVENT_NOTEON:
@@ -143,7 +165,7 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		msg |= seq_event->data.note.channel;
 		msg |= seq_event->data.note.note << 8;
 		msg |= seq_event->data.note.velocity << 16;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_NOTEOFF:
@@ -151,7 +173,7 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		msg |= seq_event->data.note.channel;
 		msg |= seq_event->data.note.note << 8;
 		msg |= seq_event->data.note.velocity << 16;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_CONTROLLER:
@@ -159,7 +181,7 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		msg |= seq_event->data.control.channel;
 		msg |= seq_event->data.control.param << 8;
 		msg |= seq_event->data.control.value << 16;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_CONTROL14:
@@ -170,7 +192,7 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		msg |= seq_event->data.control.channel;
 		msg |= seq_event->data.control.param << 8;
 		msg |= (seq_event->data.control.value >> 7) << 16;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_NONREGPARAM:
@@ -182,23 +204,23 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		if (seq_event->data.control.param != 0) break;
 		msg = 0x64B0;
 		msg |= seq_event->data.control.channel;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 
 		msg &= 0xFF;
 		msg |= 0x6500;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 
 		msg &= 0xFF;
 		msg |= 0x0600;
 		msg |= ((seq_event->data.control.value >> 7) & 0x7F) << 16;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_PGMCHANGE:
 		msg = 0xC0;
 		msg |= seq_event->data.control.channel;
 		msg |= seq_event->data.control.value << 8;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_PITCHBEND:
@@ -208,7 +230,7 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		bend = seq_event->data.control.value + 8192;
 		msg |= (bend & 0x7F) << 8;
 		msg |= ((bend >> 7) & 0x7F) << 16;
-		synthRoute->pushMIDIShortMessage(*midiSession, msg, MasterClock::getClockNanos());
+		synthRoute->pushMIDIShortMessage(*midiSession, msg, eventTimestamp);
 		break;
 
 	case SND_SEQ_EVENT_SYSEX: {
@@ -222,13 +244,13 @@ bool ALSAMidiDriver::processSeqEvent(snd_seq_event_t *seq_event, MidiSession *mi
 		bool hasSysexStart = sysexData[0] == MIDI_CMD_COMMON_SYSEX;
 		bool hasSysexEnd = sysexData[sysexLength - 1] == MIDI_CMD_COMMON_SYSEX_END;
 		if (hasSysexStart && hasSysexEnd) {
-			synthRoute->pushMIDISysex(*midiSession, sysexData, sysexLength, MasterClock::getClockNanos());
+			synthRoute->pushMIDISysex(*midiSession, sysexData, sysexLength, eventTimestamp);
 			break;
 		}
 		// OK, accumulate SysEx data received so far and commit when ready.
 		sysexBuffer.append(sysexData, sysexLength);
 		if (hasSysexEnd) {
-			synthRoute->pushMIDISysex(*midiSession, sysexBuffer.constData(), sysexBuffer.size(), MasterClock::getClockNanos());
+			synthRoute->pushMIDISysex(*midiSession, sysexBuffer.constData(), sysexBuffer.size(), eventTimestamp);
 			sysexBuffer.clear();
 		}
 		break;
@@ -276,26 +298,48 @@ int ALSAMidiDriver::alsa_setup_midi() {
 	}
 
 	snd_seq_set_client_name(snd_seq, "Munt MT-32");
-	seqPort = snd_seq_create_simple_port(
-		snd_seq,
-		"Standard",
+
+	// A running queue is only needed to make the sequencer stamp the incoming events with its real time.
+	queueClockSync.reset();
+	seqQueue = snd_seq_alloc_named_queue(snd_seq, "Munt MT-32 timestamping");
+	if (seqQueue < 0) {
+		qDebug() << "ALSAMidiDriver: Error allocating sequencer queue, incoming events won't be timestamped";
+	}
+
+	snd_seq_port_info_t *portInfo;
+	snd_seq_port_info_alloca(&portInfo);
+	snd_seq_port_info_set_name(portInfo, "Standard");
+	snd_seq_port_info_set_capability(portInfo,
 		SND_SEQ_PORT_CAP_SUBS_WRITE |
-		SND_SEQ_PORT_CAP_WRITE,
+		SND_SEQ_PORT_CAP_WRITE
+	);
+	snd_seq_port_info_set_type(portInfo,
 		SND_SEQ_PORT_TYPE_MIDI_GENERIC |
 		SND_SEQ_PORT_TYPE_MIDI_MT32 |
 		SND_SEQ_PORT_TYPE_SYNTHESIZER
 	);
-	if (seqPort < 0) {
+	if (seqQueue >= 0) {
+		snd_seq_port_info_set_timestamping(portInfo, 1);
+		snd_seq_port_info_set_timestamp_real(portInfo, 1);
+		snd_seq_port_info_set_timestamp_queue(portInfo, seqQueue);
+	}
+	if (snd_seq_create_port(snd_seq, portInfo) < 0) {
 		qDebug() << "ALSAMidiDriver: Error creating sequencer port";
 		return -1;
 	}
+	seqPort = snd_seq_port_info_get_port(portInfo);
+
+	if (seqQueue >= 0) {
+		snd_seq_start_queue(snd_seq, seqQueue, NULL);
+		snd_seq_drain_output(snd_seq);
+	}
 	QString midiPortStr = QString().setNum(snd_seq_client_id(snd_seq)) + ":0";
 	qDebug() << "MT-32 emulator ALSA address is:" << midiPortStr;
 	emit mainWindowTitleContributionUpdated("ALSA MIDI Port " + midiPortStr);
 	return seqPort;
 }
 
-ALSAMidiDriver::ALSAMidiDriver(Master *useMaster) : MidiDriver(useMaster), processingThreadID(0), rawMidiPortDriver(useMaster) {}
+ALSAMidiDriver::ALSAMidiDriver(Master *useMaster) : MidiDriver(useMaster), seqQueue(-1), processingThreadID(0), rawMidiPortDriver(useMaster) {}
 
 ALSAMidiDriver::~ALSAMidiDriver() {
 	stop();
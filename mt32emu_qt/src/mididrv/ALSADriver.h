@@ -4,6 +4,7 @@
 #include <alsa/asoundlib.h>
 
 #include "OSSMidiPortDriver.h"
+#include "../MasterClock.h"
 
 class ALSAMidiDriver : public MidiDriver {
 	Q_OBJECT
@@ -23,6 +24,8 @@ public:
 
 private:
 	snd_seq_t *snd_seq;
+	int seqQueue;
+	MasterClockSync queueClockSync;
 	pthread_t processingThreadID;
 	volatile bool stopProcessing;
 	QList<unsigned int> clients;
@@ -32,6 +35,8 @@ private:
 	static void *processingThread(void *userData);
 	int alsa_setup_midi();
 	void processSeqEvents();
+	void syncQueueClock();
+	MasterClockNanos getEventTimestamp(const snd_seq_event_t *seq_event);
 	bool processSeqEvent(snd_seq_event_t *seq_event, MidiSession *midiSession);
 	unsigned int getSourceAddr(snd_seq_event_t *seq_event);
 	QString getClientName(unsigned int clientAddr);
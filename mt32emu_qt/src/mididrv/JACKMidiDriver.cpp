@@ -34,10 +34,6 @@ static inline quint32 midiBufferToShortMessage(size_t midiBufferSize, uchar *mid
 	}
 }
 
-MasterClockNanos JACKMidiDriver::jackFrameTimeToMasterClockNanos(MasterClockNanos refNanos, quint64 eventJackTime, quint64 refJackTime) {
-	return refNanos + (eventJackTime - refJackTime) * MasterClock::NANOS_PER_MICROSECOND;
-}
-
 bool JACKMidiDriver::pushMIDIMessage(MidiSession *midiSession, MasterClockNanos eventTimestamp, size_t midiBufferSize, uchar *midiBuffer) {
 	SynthRoute *synthRoute = midiSession->getSynthRoute();
 	if (*midiBuffer == 0xF0) {
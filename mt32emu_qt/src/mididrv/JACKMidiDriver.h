@@ -12,7 +12,6 @@ class JACKMidiDriver : public MidiDriver {
 	Q_OBJECT
 
 public:
-	static MasterClockNanos jackFrameTimeToMasterClockNanos(MasterClockNanos refNanos, quint64 eventJackTime, quint64 refJackTime);
 	static bool pushMIDIMessage(MidiSession *midiSession, MasterClockNanos eventTimestamp, size_t midiBufferSize, uchar *midiBuffer);
 	static bool playMIDIMessage(MidiSession *midiSession, quint64 eventTimestamp, size_t midiBufferSize, uchar *midiBuffer);
 
@@ -20,6 +20,11 @@
 #include <poll.h>
 #include <errno.h>
 
+#ifdef WITH_OSS_AUDIO_DRIVER
+#include <sys/ioctl.h>
+#include <sys/soundcard.h>
+#endif
+
 #include "OSSMidiPortDriver.h"
 #include "../MasterClock.h"
 
@@ -30,13 +35,48 @@ static const QStringList midiPortTemplates = QStringList() << defaultMidiPortNam
 
 static OSSMidiPortDriver *driver;
 
+// Returns the sequencer timer rate in ticks per second, or 0 if the sequencer timer is unavailable.
+static int getSequencerTimerRate(int fd) {
+#if defined SNDCTL_SEQ_CTRLRATE && defined SNDCTL_SEQ_GETTIME
+	int timerRate = 0;
+	if (ioctl(fd, SNDCTL_SEQ_CTRLRATE, &timerRate) == 0 && timerRate > 0) return timerRate;
+#else
+	Q_UNUSED(fd);
+#endif
+	return 0;
+}
+
+static MasterClockNanos sequencerTicksToNanos(qint64 ticks, int timerRate) {
+	return (ticks / timerRate) * MasterClock::NANOS_PER_SECOND + (ticks % timerRate) * MasterClock::NANOS_PER_SECOND / timerRate;
+}
+
+// Reads the current time of the sequencer timer and updates the clock sync. Returns the current time in ticks or -1 on error.
+static qint64 syncSequencerTimer(int fd, int timerRate, MasterClockSync &clockSync) {
+#if defined SNDCTL_SEQ_CTRLRATE && defined SNDCTL_SEQ_GETTIME
+	int ticksNow = 0;
+	MasterClockNanos nanosBefore = MasterClock::getClockNanos();
+	if (ioctl(fd, SNDCTL_SEQ_GETTIME, &ticksNow) != 0) return -1;
+	MasterClockNanos nanosAfter = MasterClock::getClockNanos();
+	clockSync.update(sequencerTicksToNanos(ticksNow, timerRate), nanosBefore, nanosAfter);
+	return ticksNow;
+#else
+	Q_UNUSED(fd);
+	Q_UNUSED(timerRate);
+	Q_UNUSED(clockSync);
+	return -1;
+#endif
+}
+
 void* OSSMidiPortDriver::processingThread(void *userData) {
 	static const int BUFFER_SIZE = 1024;
+	static const int SEQ_WAIT = 2;
 	static const int SEQ_MIDIPUTC = 5;
 	unsigned char buffer[4 * BUFFER_SIZE];
 	unsigned char messageBuffer[BUFFER_SIZE];
 	int fd = -1;
 	pollfd pfd;
+	int timerRate = 0;
+	MasterClockSync clockSync;
 
 	OSSMidiPortData *data = (OSSMidiPortData *)userData;
 	if (data->midiSession == NULL) data->midiSession = driver->createMidiSession(data->midiPortName);
@@ -50,6 +90,9 @@ void* OSSMidiPortDriver::processingThread(void *userData) {
 				qDebug() << "OSSMidiPortDriver: Can't open MIDI port provided:" << data->midiPortName << ", errno:" << errno;
 				break;
 			}
+			// In the sequencer mode, the incoming MIDI bytes are timestamped by the sequencer timer, which starts upon opening.
+			timerRate = data->sequencerMode ? getSequencerTimerRate(fd) : 0;
+			clockSync.reset();
 		}
 		pfd.fd = fd;
 		pfd.events = POLLIN;
@@ -73,26 +116,39 @@ void* OSSMidiPortDriver::processingThread(void *userData) {
 			fd = -1;
 			continue;
 		}
-		unsigned char *msg = buffer;
-		int messageLength = len;
-		if (data->sequencerMode) {
-			messageLength = 0;
-			unsigned char *buf = buffer;
-			msg = messageBuffer;
-			while (len >= 4) {
-				len -= 4;
-				if (*buf != SEQ_MIDIPUTC) {
-					buf += 4;
-					continue;
-				}
-				*(msg++) = *(++buf);
-				buf += 3;
-				messageLength++;
+		MasterClockNanos nanosNow = MasterClock::getClockNanos();
+		if (!data->sequencerMode) {
+			qMidiStreamParser.setTimestamp(nanosNow);
+			qMidiStreamParser.parseStream(buffer, len);
+			continue;
+		}
+		qint64 ticksNow = timerRate > 0 ? syncSequencerTimer(fd, timerRate, clockSync) : -1;
+		qMidiStreamParser.setTimestamp(nanosNow);
+		int messageLength = 0;
+		unsigned char *buf = buffer;
+		unsigned char *msg = messageBuffer;
+		while (len >= 4) {
+			len -= 4;
+			if (*buf == SEQ_WAIT && ticksNow >= 0) {
+				// The following bytes arrived at this time. Since it's only 24-bit, the full time is restored relative to the current one.
+				qint64 eventTicks = buf[1] | (buf[2] << 8) | (buf[3] << 16);
+				eventTicks = ticksNow - ((ticksNow - eventTicks) & 0xFFFFFF);
+				qMidiStreamParser.parseStream(messageBuffer, messageLength);
+				messageLength = 0;
+				msg = messageBuffer;
+				qMidiStreamParser.setTimestamp(clockSync.toClockNanos(sequencerTicksToNanos(eventTicks, timerRate), nanosNow));
+				buf += 4;
+				continue;
+			}
+			if (*buf != SEQ_MIDIPUTC) {
+				buf += 4;
+				continue;
 			}
-			msg = messageBuffer;
+			*(msg++) = *(++buf);
+			buf += 3;
+			messageLength++;
 		}
-		qMidiStreamParser.setTimestamp(MasterClock::getClockNanos());
-		qMidiStreamParser.parseStream(msg, messageLength);
+		qMidiStreamParser.parseStream(messageBuffer, messageLength);
 	}
 	qDebug() << "OSSMidiPortDriver: Processing thread stopped. Port: " << data->midiPortName;
 	if (!data->stopProcessing) driver->deleteMidiSession(data->midiSession);
@@ -23,6 +23,79 @@
 #include "../MidiSession.h"
 
 static const MasterClockNanos MAX_SLEEP_TIME = 200 * MasterClock::NANOS_PER_MILLISECOND;
+static const MasterClockNanos PLAYBACK_TIME_UPDATE_PERIOD = 100 * MasterClock::NANOS_PER_MILLISECOND;
+static const uint DEFAULT_LOOK_AHEAD_MILLIS = 50;
+
+// Collects the state of MIDI channels set by the events skipped while seeking, so that only the final values are sent to the synth.
+class ChannelStateAccumulator {
+public:
+	ChannelStateAccumulator() {
+		clear();
+	}
+
+	// Returns false if the effect of the message depends on the preceding messages,
+	// so that the accumulated state has to be flushed before the message is sent as is.
+	bool accumulate(quint32 msg) {
+		uint channel = msg & 0x0F;
+		uint data1 = (msg >> 8) & 0x7F;
+		switch (msg & 0xF0) {
+			case 0x80:
+			case 0x90:
+			case 0xA0:
+				// Ignore NoteOn, NoteOff & Polyphonic Key Pressure while seeking
+				return true;
+			case 0xB0:
+				// Data entry & (N)RPN selection are applied in sequence, so are the channel mode messages
+				if (data1 == 6 || data1 == 38 || (96 <= data1 && data1 <= 101) || 120 <= data1) return false;
+				controllers[channel][data1] = qint16((msg >> 16) & 0x7F);
+				break;
+			case 0xC0:
+				programs[channel] = qint16(data1);
+				// Program change releases the hold pedal
+				controllers[channel][64] = -1;
+				break;
+			case 0xD0:
+				channelPressures[channel] = qint16(data1);
+				break;
+			case 0xE0:
+				pitchBends[channel] = qint16((msg >> 8) & 0x7F7F);
+				break;
+			default:
+				return false;
+		}
+		empty = false;
+		return true;
+	}
+
+	void flush(SynthRoute *synthRoute) {
+		if (empty) return;
+		for (quint32 channel = 0; channel < 16; channel++) {
+			if (programs[channel] > -1) synthRoute->playMIDIShortMessageNow(0xC0 | channel | (programs[channel] << 8));
+			for (quint32 controller = 0; controller < 128; controller++) {
+				qint16 value = controllers[channel][controller];
+				if (value > -1) synthRoute->playMIDIShortMessageNow(0xB0 | channel | (controller << 8) | (value << 16));
+			}
+			if (channelPressures[channel] > -1) synthRoute->playMIDIShortMessageNow(0xD0 | channel | (channelPressures[channel] << 8));
+			if (pitchBends[channel] > -1) synthRoute->playMIDIShortMessageNow(0xE0 | channel | (pitchBends[channel] << 8));
+		}
+		clear();
+	}
+
+private:
+	bool empty;
+	qint16 programs[16];
+	qint16 controllers[16][128];
+	qint16 channelPressures[16];
+	qint16 pitchBends[16];
+
+	void clear() {
+		empty = true;
+		memset(programs, -1, sizeof programs);
+		memset(controllers, -1, sizeof controllers);
+		memset(channelPressures, -1, sizeof channelPressures);
+		memset(pitchBends, -1, sizeof pitchBends);
+	}
+};
 
 static void sendAllSoundOff(SynthRoute *synthRoute, bool resetAllControllers, bool discardMidiBuffers) {
 	if (synthRoute->getState() != SynthRouteState_OPEN) return;
@@ -43,11 +116,13 @@ static void sendAllSoundOff(SynthRoute *synthRoute, bool resetAllControllers, bo
 	}
 }
 
-SMFProcessor::SMFProcessor(SMFDriver *useSMFDriver) : driver(useSMFDriver), midiStreamSource()
+SMFProcessor::SMFProcessor(SMFDriver *useSMFDriver) : driver(useSMFDriver), midiStreamSource(), timeIndex(), lookAheadNanos()
 {}
 
 void SMFProcessor::start(const MidiStreamSource *useMidiStreamSource) {
 	midiStreamSource = useMidiStreamSource;
+	uint lookAheadMillis = Master::getInstance()->getSettings()->value("Master/smfLookAheadMillis", DEFAULT_LOOK_AHEAD_MILLIS).toUInt();
+	lookAheadNanos = qMin(lookAheadMillis * MasterClock::NANOS_PER_MILLISECOND, MAX_SLEEP_TIME);
 	driver->stopProcessing = false;
 	driver->pauseProcessing = false;
 	driver->bpmUpdate = 0;
@@ -60,23 +135,39 @@ void SMFProcessor::run() {
 	MidiSession *session = driver->createMidiSession(midiStreamSource->getStreamName());
 	SynthRoute *synthRoute = session->getSynthRoute();
 	bool paused = false;
+	// The tempo set by the user stays in effect till the next tempo change in the stream.
+	bool tempoOverridden = false;
 	const QMidiEventList &midiEvents = midiStreamSource->getMIDIEvents();
+	timeIndex = midiStreamSource->getTimeIndex();
+	if (timeIndex == NULL) {
+		localTimeIndex.build(*midiStreamSource);
+		timeIndex = &localTimeIndex;
+	}
 	midiTick = midiStreamSource->getMidiTick();
-	quint32 totalSeconds = estimateRemainingTime(midiEvents, 0);
+	pushedEvents.clear();
+	quint32 totalSeconds = estimateRemainingTime(0);
 	MasterClockNanos startNanos = MasterClock::getClockNanos();
 	MasterClockNanos currentNanos = startNanos;
+	MasterClockNanos lastPlaybackTimeUpdateNanos = 0;
+	// Each event is pushed ahead of its time at least by this margin, which also sets the minimum sleep time between batches.
+	const MasterClockNanos pushMarginNanos = qMax(lookAheadNanos / 2, MasterClockNanos(MasterClock::NANOS_PER_MILLISECOND));
+	const MasterClockNanos pushWindowNanos = qMax(lookAheadNanos, pushMarginNanos);
 	for (int currentEventIx = 0; currentEventIx < midiEvents.count(); currentEventIx++) {
 		currentNanos += midiEvents.at(currentEventIx).getTimestamp() * midiTick;
 		while (!driver->stopProcessing && synthRoute->getState() == SynthRouteState_OPEN) {
+			MasterClockNanos nanosNow = MasterClock::getClockNanos();
+			if (!pushedEvents.isEmpty() && pushedEvents.last().nanos <= nanosNow) pushedEvents.clear();
 			uint bpmUpdate = uint(driver->bpmUpdate.fetchAndStoreRelaxed(0));
 			if (bpmUpdate > 0) {
+				withdrawPendingEvents(synthRoute, midiEvents, nanosNow, currentEventIx, currentNanos, tempoOverridden);
+				tempoOverridden = true;
 				midiTick = midiStreamSource->getMidiTick(MidiParser::MICROSECONDS_PER_MINUTE / bpmUpdate);
-				totalSeconds = (currentNanos - startNanos) / MasterClock::NANOS_PER_SECOND + estimateRemainingTime(midiEvents, currentEventIx + 1);
+				totalSeconds = (currentNanos - startNanos) / MasterClock::NANOS_PER_SECOND + estimateRemainingTime(currentEventIx + 1);
 			}
-			MasterClockNanos nanosNow = MasterClock::getClockNanos();
 			if (driver->pauseProcessing) {
 				if (!paused) {
 					paused = true;
+					withdrawPendingEvents(synthRoute, midiEvents, nanosNow, currentEventIx, currentNanos, tempoOverridden);
 					sendAllSoundOff(synthRoute, false, false);
 				}
 				usleep(MAX_SLEEP_TIME / MasterClock::NANOS_PER_MICROSECOND);
@@ -88,26 +179,35 @@ void SMFProcessor::run() {
 			if (paused) paused = false;
 			int seekPosition = driver->seekPosition.fetchAndStoreRelaxed(-1);
 			if (seekPosition > -1) {
-				MasterClockNanos seekNanosSinceStart = totalSeconds * seekPosition * MasterClock::NANOS_PER_MILLISECOND;
-				MasterClockNanos currentNanosSinceStart = currentNanos - startNanos;
-				MasterClockNanos lastEventNanosSinceStart = currentNanosSinceStart - midiEvents.at(currentEventIx).getTimestamp() * midiTick;
-				bool rewind;
-				if (seekNanosSinceStart < lastEventNanosSinceStart || seekNanosSinceStart == 0) {
-					midiTick = midiStreamSource->getMidiTick();
-					emit driver->tempoUpdated(0);
-					currentEventIx = 0;
-					currentNanosSinceStart = midiEvents.at(currentEventIx).getTimestamp() * midiTick;
-					rewind = true;
+				withdrawPendingEvents(synthRoute, midiEvents, nanosNow, currentEventIx, currentNanos, tempoOverridden);
+				// Seeking follows the tempo set in the stream, so the position maps onto the time index directly
+				MasterClockNanos seekNanosSinceStart = timeIndex->getTotalNanos() / 1000 * seekPosition;
+				int seekEventIx = timeIndex->findEvent(seekNanosSinceStart);
+				bool rewind = seekEventIx < currentEventIx || seekNanosSinceStart == 0;
+				sendAllSoundOff(synthRoute, rewind, rewind);
+				seek(synthRoute, midiEvents, rewind ? 0 : currentEventIx, seekEventIx);
+				if (driver->stopProcessing || synthRoute->getState() != SynthRouteState_OPEN) break;
+				currentEventIx = seekEventIx;
+				uint tempo = timeIndex->getTempo(currentEventIx);
+				MasterClockNanos streamMidiTick = tempo == 0 ? midiStreamSource->getMidiTick() : midiStreamSource->getMidiTick(tempo);
+				// There is no tempo change in between, so the time till the next event only depends on the MIDI tick in effect
+				MasterClockNanos nanosTillEvent = timeIndex->getEventNanos(currentEventIx) - seekNanosSinceStart;
+				if (tempoOverridden) {
+					nanosTillEvent = nanosTillEvent * midiTick / streamMidiTick;
 				} else {
-					rewind = false;
+					midiTick = streamMidiTick;
+					emit driver->tempoUpdated(tempo == 0 ? 0 : MidiParser::MICROSECONDS_PER_MINUTE / tempo);
 				}
-				sendAllSoundOff(synthRoute, rewind, rewind);
-				seek(synthRoute, midiEvents, currentEventIx, currentNanosSinceStart, seekNanosSinceStart);
 				nanosNow = MasterClock::getClockNanos();
 				startNanos = nanosNow - seekNanosSinceStart;
-				currentNanos = currentNanosSinceStart + startNanos;
+				currentNanos = nanosNow + nanosTillEvent;
+				totalSeconds = (currentNanos - startNanos) / MasterClock::NANOS_PER_SECOND + estimateRemainingTime(currentEventIx + 1);
+				lastPlaybackTimeUpdateNanos = 0;
+			}
+			if (nanosNow - lastPlaybackTimeUpdateNanos >= PLAYBACK_TIME_UPDATE_PERIOD) {
+				lastPlaybackTimeUpdateNanos = nanosNow;
+				emit driver->playbackTimeChanged(nanosNow - startNanos, totalSeconds);
 			}
-			emit driver->playbackTimeChanged(nanosNow - startNanos, totalSeconds);
 			MasterClockNanos delay = currentNanos - nanosNow;
 			uint fastForwardingFactor = driver->fastForwardingFactor;
 			if (fastForwardingFactor > 1) {
@@ -116,10 +216,14 @@ void SMFProcessor::run() {
 				currentNanos -= timeShift;
 				startNanos -= timeShift;
 			}
-			if (delay < MasterClock::NANOS_PER_MILLISECOND) break;
-			usleep(((delay < MAX_SLEEP_TIME ? delay : MAX_SLEEP_TIME) - MasterClock::NANOS_PER_MILLISECOND) / MasterClock::NANOS_PER_MICROSECOND);
+			// The events that fall into the look-ahead window are pushed without sleeping in between.
+			// Upon tempo, pause and seek changes, those pushed but not yet due are withdrawn and pushed anew.
+			if (delay < pushWindowNanos) break;
+			usleep(((delay < MAX_SLEEP_TIME ? delay : MAX_SLEEP_TIME) - pushMarginNanos) / MasterClock::NANOS_PER_MICROSECOND);
 		}
 		if (driver->stopProcessing || synthRoute->getState() != SynthRouteState_OPEN) break;
+		PushedEvent pushedEvent = {currentEventIx, currentNanos, midiTick, tempoOverridden};
+		pushedEvents.append(pushedEvent);
 		const QMidiEvent &e = midiEvents.at(currentEventIx);
 		switch (e.getType()) {
 			case SHORT_MESSAGE:
@@ -130,6 +234,7 @@ void SMFProcessor::run() {
 				break;
 			case SET_TEMPO: {
 				uint tempo = e.getShortMessage();
+				tempoOverridden = false;
 				midiTick = midiStreamSource->getMidiTick(tempo);
 				emit driver->tempoUpdated(MidiParser::MICROSECONDS_PER_MINUTE / tempo);
 				break;
@@ -145,44 +250,60 @@ void SMFProcessor::run() {
 	if (!driver->stopProcessing) emit driver->playbackFinished(synthRoute->getState() == SynthRouteState_OPEN);
 }
 
-quint32 SMFProcessor::estimateRemainingTime(const QMidiEventList &midiEvents, int currentEventIx) {
-	MasterClockNanos tick = midiTick;
-	MasterClockNanos totalNanos = 0;
-	for (int i = currentEventIx; i < midiEvents.count(); i++) {
-		const QMidiEvent &e = midiEvents.at(i);
-		totalNanos += e.getTimestamp() * tick;
-		if (e.getType() == SET_TEMPO) tick = midiStreamSource->getMidiTick(e.getShortMessage());
+// Takes back the events pushed ahead of time that are not yet due, and rewinds the playback state to the earliest of them.
+// As the synth cannot drop the queued events, these are rather flushed, and the notes they might have started are released at once.
+void SMFProcessor::withdrawPendingEvents(SynthRoute *synthRoute, const QMidiEventList &midiEvents, MasterClockNanos nanosNow, int &currentEventIx, MasterClockNanos &currentNanos, bool &tempoOverridden) {
+	int pendingIx = 0;
+	while (pendingIx < pushedEvents.size() && pushedEvents.at(pendingIx).nanos <= nanosNow) pendingIx++;
+	if (pendingIx == pushedEvents.size()) {
+		pushedEvents.clear();
+		return;
+	}
+	synthRoute->discardMidiBuffers();
+	for (int i = pendingIx; i < pushedEvents.size(); i++) {
+		const QMidiEvent &e = midiEvents.at(pushedEvents.at(i).eventIx);
+		if (e.getType() != SHORT_MESSAGE) continue;
+		quint32 msg = e.getShortMessage();
+		if ((msg & 0xF0) == 0x90 && (msg & 0x7F0000) != 0) {
+			synthRoute->playMIDIShortMessageNow(0x400080 | (msg & 0x7F0F));
+		}
 	}
-	return quint32(totalNanos / MasterClock::NANOS_PER_SECOND);
+	const PushedEvent &pendingEvent = pushedEvents.at(pendingIx);
+	currentEventIx = pendingEvent.eventIx;
+	currentNanos = pendingEvent.nanos;
+	midiTick = pendingEvent.midiTick;
+	tempoOverridden = pendingEvent.tempoOverridden;
+	pushedEvents.clear();
 }
 
-void SMFProcessor::seek(SynthRoute *synthRoute, const QMidiEventList &midiEvents, int &currentEventIx, MasterClockNanos &currentEventNanos, const MasterClockNanos seekNanos) {
-	while (!driver->stopProcessing && synthRoute->getState() == SynthRouteState_OPEN && currentEventNanos < seekNanos) {
-		const QMidiEvent &e = midiEvents.at(currentEventIx);
+quint32 SMFProcessor::estimateRemainingTime(int currentEventIx) {
+	return quint32(timeIndex->getRemainingNanos(currentEventIx, midiTick) / MasterClock::NANOS_PER_SECOND);
+}
+
+// Brings the synth to the state it would reach by playing the events in the range, except for notes.
+// Channel messages are collapsed to the final values, which are only sent before events that depend on the order of messages and at the end.
+void SMFProcessor::seek(SynthRoute *synthRoute, const QMidiEventList &midiEvents, int fromEventIx, int toEventIx) {
+	ChannelStateAccumulator channelState;
+	for (int eventIx = fromEventIx; eventIx < toEventIx; eventIx++) {
+		const QMidiEvent &e = midiEvents.at(eventIx);
 		switch (e.getType()) {
 			case SHORT_MESSAGE: {
 				quint32 msg = e.getShortMessage();
-				// Ignore NoteOn & NoteOff while seeking
-				if ((msg & 0xE0) != 0x80) synthRoute->playMIDIShortMessageNow(msg);
+				if (channelState.accumulate(msg)) break;
+				channelState.flush(synthRoute);
+				synthRoute->playMIDIShortMessageNow(msg);
 				break;
 			}
 			case SYSEX:
+				if (driver->stopProcessing || synthRoute->getState() != SynthRouteState_OPEN) return;
+				channelState.flush(synthRoute);
 				synthRoute->playMIDISysexNow(e.getSysexData(), e.getSysexLen());
 				break;
-			case SET_TEMPO: {
-				uint tempo = e.getShortMessage();
-				midiTick = midiStreamSource->getMidiTick(tempo);
-				emit driver->tempoUpdated(MidiParser::MICROSECONDS_PER_MINUTE / tempo);
-				break;
-			}
 			default:
 				break;
 		}
-		int nextEventIx = currentEventIx + 1;
-		if (midiEvents.size() <= nextEventIx) break;
-		currentEventIx = nextEventIx;
-		currentEventNanos += midiEvents.at(currentEventIx).getTimestamp() * midiTick;
 	}
+	channelState.flush(synthRoute);
 }
 
 SMFDriver::SMFDriver(Master *useMaster) : MidiDriver(useMaster), processor(this), midiParser() {
@@ -2,6 +2,7 @@
 #define SMF_DRIVER_H
 
 #include <QThread>
+#include <QVector>
 
 #include "MidiDriver.h"
 #include "../Master.h"
@@ -18,13 +19,29 @@ public:
 	void start(const MidiStreamSource *midiStreamSource);
 
 private:
+	// Playback state as of an event pushed to the synth route ahead of time.
+	struct PushedEvent {
+		int eventIx;
+		MasterClockNanos nanos;
+		MasterClockNanos midiTick;
+		bool tempoOverridden;
+	};
+
 	SMFDriver *driver;
 	const MidiStreamSource *midiStreamSource;
+	const MidiEventTimeIndex *timeIndex;
+	// Used when the MIDI stream source doesn't maintain the time index itself.
+	MidiEventTimeIndex localTimeIndex;
 	MasterClockNanos midiTick;
+	// Events due within this period are pushed to the synth route in one go, so that the thread wakes up at most twice per period.
+	MasterClockNanos lookAheadNanos;
+	// Events pushed within the look-ahead window that may still be pending in the MIDI buffers, in order.
+	QVector<PushedEvent> pushedEvents;
 
 	void run();
-	quint32 estimateRemainingTime(const QMidiEventList &midiEvents, int currentEventIx);
-	void seek(SynthRoute *synthRoute, const QMidiEventList &midiEvents, int &currentEventIx, MasterClockNanos &currentEventNanos, const MasterClockNanos seekNanos);
+	void withdrawPendingEvents(SynthRoute *synthRoute, const QMidiEventList &midiEvents, MasterClockNanos nanosNow, int &currentEventIx, MasterClockNanos &currentNanos, bool &tempoOverridden);
+	quint32 estimateRemainingTime(int currentEventIx);
+	void seek(SynthRoute *synthRoute, const QMidiEventList &midiEvents, int fromEventIx, int toEventIx);
 };
 
 class SMFDriver : public MidiDriver {
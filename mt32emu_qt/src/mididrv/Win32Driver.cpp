@@ -14,8 +14,6 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <QMessageBox>
-
 #include <windows.h>
 #include <process.h>
 
@@ -384,7 +382,7 @@ void CALLBACK Win32MidiIn::midiInProc(HMIDIIN hMidiIn, UINT wMsg, DWORD_PTR dwIn
 
 		// Add SysEx Buffer for reuse
 		if (midiInAddBuffer(hMidiIn, pMIDIhdr, sizeof(MIDIHDR)) != MMSYSERR_NOERROR) {
-			QMessageBox::critical(NULL, "Win32MidiIn Error", "Failed to add SysEx Buffer for reuse");
+			Master::showCritical("Win32MidiIn Error", "Failed to add SysEx Buffer for reuse");
 			return;
 		}
 		return;
@@ -402,7 +400,7 @@ bool Win32MidiIn::open(MidiSession *midiSession, uint midiDevID) {
 	// Init midiIn port
 	wResult = midiInOpen(&hMidiIn, midiDevID, (DWORD_PTR)midiInProc, (DWORD_PTR)midiSession, CALLBACK_FUNCTION);
 	if (wResult != MMSYSERR_NOERROR) {
-		QMessageBox::critical(NULL, "Win32MidiIn Error", "Failed to open MIDI input port");
+		Master::showCritical("Win32MidiIn Error", "Failed to open MIDI input port");
 		return false;
 	}
 
@@ -412,14 +410,14 @@ bool Win32MidiIn::open(MidiSession *midiSession, uint midiDevID) {
 	MidiInHdr.dwFlags = 0L;
 	wResult = midiInPrepareHeader(hMidiIn, &MidiInHdr, sizeof(MIDIHDR));
 	if (wResult != MMSYSERR_NOERROR) {
-		QMessageBox::critical(NULL, "Win32MidiIn Error", "Failed to prepare MIDI buffer header");
+		Master::showCritical("Win32MidiIn Error", "Failed to prepare MIDI buffer header");
 		return false;
 	}
 
 	// Add SysEx Buffer
 	wResult = midiInAddBuffer(hMidiIn, &MidiInHdr, sizeof(MIDIHDR));
 	if (wResult != MMSYSERR_NOERROR) {
-		QMessageBox::critical(NULL, "Win32MidiIn Error", "Failed to add SysEx buffer");
+		Master::showCritical("Win32MidiIn Error", "Failed to add SysEx buffer");
 		return false;
 	}
 	return midiInStart(hMidiIn) == MMSYSERR_NOERROR;
@@ -50,6 +50,12 @@ static const int DEFAULT_BUFFER_SIZE = 128 * 1024;
 // Maximum number of frames to render in each pass while waiting for reverb to become inactive.
 static const unsigned int MAX_REVERB_END_FRAMES = 8192;
 
+// Default duration of the time window rendered before each parallel segment to let the synth state settle, in seconds.
+static const int DEFAULT_SEGMENT_WARM_UP_SECONDS = 10;
+
+// Sizes of blocks in frames rendered per call in the benchmark mode, typical for low-latency audio drivers.
+static const unsigned int BENCHMARK_BLOCK_SIZES[] = {16, 32, 64, 128};
+
 static const int HEADEROFFS_RIFFLEN = 4;
 static const int HEADEROFFS_FORMAT_TAG = 20;
 static const int HEADEROFFS_SAMPLERATE = 24;
@@ -120,6 +126,12 @@ struct Options {
 	gboolean niceAmpRamp;
 	gboolean nicePanning;
 	gboolean nicePartialMixing;
+
+	gint parallelSegments;
+	gint segmentWarmUpFrames;
+	gboolean verifySegments;
+
+	gboolean benchmark;
 };
 
 struct State {
@@ -182,6 +194,10 @@ static bool parseOptions(int argc, char *argv[], Options *options) {
 	options->niceAmpRamp = true;
 	options->nicePanning = false;
 	options->nicePartialMixing = false;
+	options->parallelSegments = 1;
+	options->segmentWarmUpFrames = -1;
+	options->verifySegments = false;
+	options->benchmark = false;
 	// FIXME: Perhaps there's a nicer way to represent long argument descriptions...
 	GOptionEntry entries[] = {
 		{"output", 'o', 0, G_OPTION_ARG_FILENAME, &options->outputFilename, "Output file (default: last source file name with \".wav\" appended)", "<filename>"},
@@ -269,6 +285,18 @@ static bool parseOptions(int argc, char *argv[], Options *options) {
 		 "                Timbres with closely sounding partials may sound quite differently, or even cancel out if mixed counter-phase.\n"
 		 "                Enabling this option makes the behaviour more predictable.", NULL},
 
+		{"parallel-segments", 'j', 0, G_OPTION_ARG_INT, &options->parallelSegments, "Split the MIDI file into this many time segments and render them concurrently (default: 1)\n"
+		 "                Each segment is rendered by a separate synth instance that replays the MIDI file from the start,\n"
+		 "                yet only renders audio from the warm-up window preceding the segment. Only applies when a single\n"
+		 "                MIDI file is converted to a WAVE file. No more segments than available processors are rendered at a time,\n"
+		 "                and the rendered audio of each segment is kept in memory until written out.", "<segment_count>"},
+		{"segment-warm-up", 0, 0, G_OPTION_ARG_INT, &options->segmentWarmUpFrames, "Render this many frames before each parallel segment and discard them (default: 10 seconds)", "<frame_count>"},
+		{"verify-segments", 0, 0, G_OPTION_ARG_NONE, &options->verifySegments, "Additionally render the MIDI file sequentially and compare with the stitched parallel segments,\n"
+		 "                reporting the maximum deviation in each segment.", NULL},
+
+		{"benchmark", 0, 0, G_OPTION_ARG_NONE, &options->benchmark, "Instead of writing an output file, render each MIDI file in blocks of 16, 32, 64 and 128 frames,\n"
+		 "                both with and without the low-latency rendering mode, and report the time spent per rendering call.", NULL},
+
 		{"s", 's', 0, G_OPTION_ARG_FILENAME, &deprecatedSysexFile, "[DEPRECATED] Play this SMF or sysex file before any other. DEPRECATED: Instead just specify the file first in the file list.", "<midi_file>"},
 		{G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &options->inputFilenames, NULL, "<midi_file> [midi_file...]"},
 		{NULL, 0, 0, G_OPTION_ARG_NONE, NULL, NULL, NULL}
@@ -354,6 +382,18 @@ static bool parseOptions(int argc, char *argv[], Options *options) {
 		fprintf(stderr, "No input files specified\n");
 		parseSuccess = false;
 	}
+	if (options->parallelSegments < 1) {
+		fprintf(stderr, "parallel-segments must be greater than 0\n");
+		parseSuccess = false;
+	} else if (options->parallelSegments > 1 && parseSuccess) {
+		if (rawStreams != NULL && g_strv_length(rawStreams) > 0) {
+			fprintf(stderr, "parallel-segments is ignored when writing raw streams\n");
+			options->parallelSegments = 1;
+		} else if (g_strv_length(options->inputFilenames) > 1) {
+			fprintf(stderr, "parallel-segments is ignored when converting multiple input files\n");
+			options->parallelSegments = 1;
+		}
+	}
 	options->analogOutputMode = ANALOG_OUTPUT_MODES[analogOutputModeIx];
 	options->rendererType = RENDERER_TYPES[rendererTypeIx];
 	options->outputSampleFormat = static_cast<OUTPUT_SAMPLE_FORMAT>(outputSampleFormat);
@@ -546,7 +586,7 @@ static inline void renderRaw(MT32Emu::Service &service, void *rawSampleBuffer[],
 	}
 }
 
-static inline bool isSilence(void * const sampleBuffer, const int sampleIx, const OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
+static inline bool isSilence(void * const sampleBuffer, const unsigned long sampleIx, const OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
 	if (outputSampleFormat == OUTPUT_SAMPLE_FORMAT_IEEE_FLOAT32) {
 		return static_cast<float *>(sampleBuffer)[sampleIx] == 0;
 	} else {
@@ -572,7 +612,7 @@ static inline MT32Emu::Bit32u makeIeeeFloat(float sample) {
 	return floatBits;
 }
 
-static inline void putSampleLE(void * const sampleBuffer, const int sampleIx, FILE *outputFile, const OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
+static inline void putSampleLE(void * const sampleBuffer, const unsigned long sampleIx, FILE *outputFile, const OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
 	if (outputSampleFormat == OUTPUT_SAMPLE_FORMAT_IEEE_FLOAT32) {
 		MT32Emu::Bit32u sample = makeIeeeFloat(static_cast<float *>(sampleBuffer)[sampleIx]);
 		fputc(sample & 0xFF, outputFile);
@@ -600,25 +640,29 @@ static inline void putSampleBE(void * const sampleBuffer, const int sampleIx, FI
 	}
 }
 
+static void writeStereo(void *stereoSampleBuffer, unsigned long frameCount, const Options &options, State &state) {
+	for (unsigned long i = 0; i < frameCount; i++) {
+		unsigned long leftIx = i * 2;
+		unsigned long rightIx = leftIx + 1;
+		bool silent = isSilence(stereoSampleBuffer, leftIx, options.outputSampleFormat)
+			&& isSilence(stereoSampleBuffer, rightIx, options.outputSampleFormat);
+		if (silent) {
+			state.unwrittenSilentFrames++;
+			continue;
+		}
+		flushSilence(NOISE_DETECTED, options, state);
+		putSampleLE(stereoSampleBuffer, leftIx, state.outputFile, options.outputSampleFormat);
+		putSampleLE(stereoSampleBuffer, rightIx, state.outputFile, options.outputSampleFormat);
+		state.writtenFrames++;
+	}
+}
+
 static void renderStereo(unsigned int frameCount, const Options &options, State &state) {
 	state.renderedFrames += frameCount;
 	while (frameCount > 0) {
 		unsigned int renderedFramesThisPass = MIN(frameCount, options.bufferFrameCount);
 		renderStereo(state.service, state.stereoSampleBuffer, renderedFramesThisPass, options.outputSampleFormat);
-		for (unsigned int i = 0; i < renderedFramesThisPass; i++) {
-			unsigned int leftIx = i * 2;
-			unsigned int rightIx = leftIx + 1;
-			bool silent = isSilence(state.stereoSampleBuffer, leftIx, options.outputSampleFormat)
-				&& isSilence(state.stereoSampleBuffer, rightIx, options.outputSampleFormat);
-			if (silent) {
-				state.unwrittenSilentFrames++;
-				continue;
-			}
-			flushSilence(NOISE_DETECTED, options, state);
-			putSampleLE(state.stereoSampleBuffer, leftIx, state.outputFile, options.outputSampleFormat);
-			putSampleLE(state.stereoSampleBuffer, rightIx, state.outputFile, options.outputSampleFormat);
-			state.writtenFrames++;
-		}
+		writeStereo(state.stereoSampleBuffer, renderedFramesThisPass, options, state);
 		frameCount -= renderedFramesThisPass;
 	}
 }
@@ -665,97 +709,86 @@ static void render(unsigned int frameCount, const Options &options, State &state
 	}
 }
 
-static void playSMF(smf_t *smf, const Options &options, State &state) {
-	int unterminatedSysexLen = 0;
-	unsigned char *unterminatedSysex = NULL;
-	unsigned long renderedFrames = 0;
-	smf_rewind(smf);
-	for (;;) {
-		smf_event_t *event = smf_get_next_event(smf);
-		unsigned long eventFrameIx;
+struct SysexAssembly {
+	// The buffer used to assemble fragmented SysEx messages is retained, it is only reallocated when a longer message occurs.
+	int unterminatedSysexLen;
+	int unterminatedSysexCapacity;
+	unsigned char *unterminatedSysex;
+};
 
-		if (event == NULL) {
-			break;
+// Returns true when the event completes a SysEx message, which is then pointed to by buf.
+static bool assembleSysex(SysexAssembly &assembly, smf_event_t *event, unsigned char *&buf, int &len, bool logErrors) {
+	bool unterminated = smf_event_is_unterminated_sysex(event) != 0;
+	bool addUnterminated = unterminated;
+	bool continuation = smf_event_is_sysex_continuation(event) != 0;
+	if (continuation) {
+		if (assembly.unterminatedSysexLen > 0) {
+			addUnterminated = true;
+		} else if (logErrors) {
+			fprintf(stderr, "Sysex continuation received without preceding unterminated sysex - hoping for the best\n");
 		}
-
-		assert(event->track->track_number >= 0);
-
-		eventFrameIx = secondsToSamples(event->time_seconds, options.sampleRate);
-		unsigned int renderLength = (eventFrameIx > renderedFrames) ? eventFrameIx - renderedFrames : 1;
-		if (state.renderedFrames + renderLength > options.renderMaxFrames) {
-			renderLength = options.renderMaxFrames - state.renderedFrames;
+		buf = event->midi_buffer + 1;
+		len = event->midi_buffer_length - 1;
+	} else {
+		if (assembly.unterminatedSysexLen > 0) {
+			if (logErrors) fprintf(stderr, "New sysex received with an unterminated sysex pending - ignoring unterminated\n");
+			assembly.unterminatedSysexLen = 0;
 		}
-		render(renderLength, options, state);
-		renderedFrames += renderLength;
-		if (state.renderedFrames == options.renderMaxFrames) {
-			break;
+		buf = event->midi_buffer;
+		len = event->midi_buffer_length;
+	}
+	if (addUnterminated) {
+		if (assembly.unterminatedSysexCapacity < assembly.unterminatedSysexLen + len) {
+			assembly.unterminatedSysexCapacity = 2 * (assembly.unterminatedSysexLen + len);
+			unsigned char *newUnterminatedSysex = new unsigned char[assembly.unterminatedSysexCapacity];
+			if (assembly.unterminatedSysexLen > 0) {
+				memcpy(newUnterminatedSysex, assembly.unterminatedSysex, assembly.unterminatedSysexLen);
+			}
+			delete[] assembly.unterminatedSysex;
+			assembly.unterminatedSysex = newUnterminatedSysex;
 		}
+		memcpy(assembly.unterminatedSysex + assembly.unterminatedSysexLen, buf, len);
+		assembly.unterminatedSysexLen += len;
+		buf = assembly.unterminatedSysex;
+		len = assembly.unterminatedSysexLen;
+	}
+	if (unterminated) return false;
+	if (addUnterminated) {
+		// The data remains intact until the next SysEx event is assembled.
+		assembly.unterminatedSysexLen = 0;
+	}
+	return true;
+}
 
-		if (smf_event_is_metadata(event)) {
-			char *decoded = smf_event_decode(event);
-			if (decoded && !options.quiet) {
-				fprintf(stdout, "Metadata: %s\n", decoded);
-			}
-		} else if (smf_event_is_sysex(event) || smf_event_is_sysex_continuation(event))  {
-			bool unterminated = smf_event_is_unterminated_sysex(event) != 0;
-			bool addUnterminated = unterminated;
-			bool continuation = smf_event_is_sysex_continuation(event) != 0;
-			unsigned char *buf;
-			int len;
-			if (continuation) {
-				if (unterminatedSysex != NULL) {
-					addUnterminated = true;
-				} else {
-					fprintf(stderr, "Sysex continuation received without preceding unterminated sysex - hoping for the best\n");
-				}
-				buf = event->midi_buffer + 1;
-				len = event->midi_buffer_length - 1;
-			} else {
-				if (unterminatedSysex != NULL) {
-					fprintf(stderr, "New sysex received with an unterminated sysex pending - ignoring unterminated\n");
-					delete[] unterminatedSysex;
-					unterminatedSysex = NULL;
-					unterminatedSysexLen = 0;
-				}
-				buf = event->midi_buffer;
-				len = event->midi_buffer_length;
-			}
-			if (addUnterminated) {
-				unsigned char *newUnterminatedSysex = new unsigned char[unterminatedSysexLen + len];
-				if(unterminatedSysex != NULL) {
-					memcpy(newUnterminatedSysex, unterminatedSysex, unterminatedSysexLen);
-					delete[] unterminatedSysex;
-				}
-				memcpy(newUnterminatedSysex + unterminatedSysexLen, buf, len);
-				unterminatedSysex = newUnterminatedSysex;
-				unterminatedSysexLen += len;
-				buf = unterminatedSysex;
-				len = unterminatedSysexLen;
-			}
-			if (!unterminated) {
-				state.service.playSysex(buf, len);
-				if (addUnterminated) {
-					delete[] unterminatedSysex;
-					unterminatedSysex = NULL;
-					unterminatedSysexLen = 0;
-				}
-			}
-		} else {
-			if (event->midi_buffer_length > 3) {
-				fprintf(stderr, "Got message with unusual length: %d\n", event->midi_buffer_length);
-				for (int i = 0; i < event->midi_buffer_length; i++) {
-					fprintf(stderr, " %02x", event->midi_buffer[i]);
-				}
-				fprintf(stderr, "\n");
-			} else {
-				MT32Emu::Bit32u msg = 0;
-				for (int i = 0; i < event->midi_buffer_length; i++) {
-					msg |= (event->midi_buffer[i] << (8 * i));
-				}
-				state.service.playMsg(msg);
+static bool makeShortMessage(const smf_event_t *event, MT32Emu::Bit32u &msg, bool logErrors) {
+	if (event->midi_buffer_length > 3) {
+		if (logErrors) {
+			fprintf(stderr, "Got message with unusual length: %d\n", event->midi_buffer_length);
+			for (int i = 0; i < event->midi_buffer_length; i++) {
+				fprintf(stderr, " %02x", event->midi_buffer[i]);
 			}
+			fprintf(stderr, "\n");
 		}
+		return false;
+	}
+	msg = 0;
+	for (int i = 0; i < event->midi_buffer_length; i++) {
+		msg |= (event->midi_buffer[i] << (8 * i));
 	}
+	return true;
+}
+
+// Computes the length of the span to render before the event is played, so that the timeline is the same in all modes.
+static unsigned int getRenderLengthBeforeEvent(smf_event_t *event, unsigned long renderedFrames, unsigned long totalRenderedFrames, const Options &options) {
+	unsigned long eventFrameIx = secondsToSamples(event->time_seconds, options.sampleRate);
+	unsigned int renderLength = (eventFrameIx > renderedFrames) ? eventFrameIx - renderedFrames : 1;
+	if (totalRenderedFrames + renderLength > options.renderMaxFrames) {
+		renderLength = options.renderMaxFrames - totalRenderedFrames;
+	}
+	return renderLength;
+}
+
+static void finishSMF(const Options &options, State &state) {
 	flushSilence(MIDI_ENDED, options, state);
 	if (options.sendAllNotesOff) {
 		for (unsigned char channel = 0; channel < 16; channel++) {
@@ -792,9 +825,141 @@ static void playSMF(smf_t *smf, const Options &options, State &state) {
 	if (!state.service.isActive()) {
 		state.unwrittenSilentFrames = 0;
 	}
-	delete[] unterminatedSysex;
 }
 
+// Returns the number of frames playSMF() renders before the MIDI file ends, given the number of frames rendered before.
+static unsigned long getSMFRenderedFrames(smf_t *smf, const Options &options, unsigned long startFrames) {
+	unsigned long renderedFrames = 0;
+	smf_rewind(smf);
+	for (;;) {
+		smf_event_t *event = smf_get_next_event(smf);
+		if (event == NULL) break;
+		renderedFrames += getRenderLengthBeforeEvent(event, renderedFrames, startFrames + renderedFrames, options);
+		if (startFrames + renderedFrames == options.renderMaxFrames) break;
+	}
+	return renderedFrames;
+}
+
+// Supplies the MIDI file events to the synth as it renders, so that no event is enqueued ahead of time.
+// Each event is timestamped at the frame it is played at by the timeline computed in getSMFRenderedFrames().
+class SMFEventSource : public MT32Emu::IMidiEventSource {
+public:
+	SMFEventSource(smf_t *useSMF, const Options &useOptions, State &state) :
+		smf(useSMF), options(useOptions), service(state.service), startFrames(state.renderedFrames),
+		startTimestamp(state.service.getInternalRenderedSampleCount()), renderedFrames(0), eventPending(false), ended(false)
+	{
+		sysexAssembly.unterminatedSysexLen = 0;
+		sysexAssembly.unterminatedSysexCapacity = 0;
+		sysexAssembly.unterminatedSysex = NULL;
+		smf_rewind(smf);
+	}
+
+	~SMFEventSource() {
+		delete[] sysexAssembly.unterminatedSysex;
+	}
+
+	bool peekMidiEvent(MT32Emu::Bit32u &timestamp, MT32Emu::Bit32u &shortMessage, const MT32Emu::Bit8u *&sysexData, MT32Emu::Bit32u &sysexLength) {
+		if (!eventPending && !fetchEvent()) return false;
+		timestamp = eventTimestamp;
+		shortMessage = eventShortMessage;
+		sysexData = eventSysexData;
+		sysexLength = eventSysexLength;
+		return true;
+	}
+
+	void dropMidiEvent() {
+		eventPending = false;
+	}
+
+	// Enqueues the events due exactly at the end of the timeline once the event source is removed. Rendering stops
+	// right before such events, so they are to be played as soon as the rendering resumes.
+	void playPendingEvents() {
+		MT32Emu::Bit32u timestamp, shortMessage, sysexLength;
+		const MT32Emu::Bit8u *sysexData;
+		while (peekMidiEvent(timestamp, shortMessage, sysexData, sysexLength)) {
+			if (sysexData == NULL) {
+				service.playMsg(shortMessage);
+			} else {
+				service.playSysex(sysexData, sysexLength);
+			}
+			dropMidiEvent();
+		}
+	}
+
+private:
+	smf_t * const smf;
+	const Options &options;
+	MT32Emu::Service &service;
+	const unsigned long startFrames;
+	const MT32Emu::Bit32u startTimestamp;
+	SysexAssembly sysexAssembly;
+	unsigned long renderedFrames;
+	bool eventPending;
+	bool ended;
+	MT32Emu::Bit32u eventTimestamp;
+	MT32Emu::Bit32u eventShortMessage;
+	const MT32Emu::Bit8u *eventSysexData;
+	MT32Emu::Bit32u eventSysexLength;
+
+	// Advances to the next event that makes a MIDI message, printing the metadata events passed by.
+	bool fetchEvent() {
+		while (!ended) {
+			smf_event_t *event = smf_get_next_event(smf);
+
+			if (event == NULL) {
+				ended = true;
+				break;
+			}
+
+			assert(event->track->track_number >= 0);
+
+			renderedFrames += getRenderLengthBeforeEvent(event, renderedFrames, startFrames + renderedFrames, options);
+			if (startFrames + renderedFrames == options.renderMaxFrames) {
+				ended = true;
+				break;
+			}
+
+			if (smf_event_is_metadata(event)) {
+				char *decoded = smf_event_decode(event);
+				if (decoded && !options.quiet) {
+					fprintf(stdout, "Metadata: %s\n", decoded);
+				}
+				continue;
+			} else if (smf_event_is_sysex(event) || smf_event_is_sysex_continuation(event)) {
+				unsigned char *buf;
+				int len;
+				if (!assembleSysex(sysexAssembly, event, buf, len, true)) continue;
+				eventSysexData = buf;
+				eventSysexLength = len;
+			} else {
+				if (!makeShortMessage(event, eventShortMessage, true)) continue;
+				eventSysexData = NULL;
+				eventSysexLength = 0;
+			}
+			eventTimestamp = startTimestamp + service.convertOutputToSynthTimestamp(MT32Emu::Bit32u(renderedFrames));
+			eventPending = true;
+			return true;
+		}
+		return false;
+	}
+
+	SMFEventSource(const SMFEventSource &);            // prevent copy-construction
+	SMFEventSource& operator=(const SMFEventSource &); // prevent assignment
+};
+
+static void playSMF(smf_t *smf, const Options &options, State &state) {
+	const unsigned long smfFrames = getSMFRenderedFrames(smf, options, state.renderedFrames);
+	SMFEventSource eventSource(smf, options, state);
+	state.service.setMIDIEventSource(eventSource);
+	render(smfFrames, options, state);
+	const mt32emu_midi_event_source_i noMIDIEventSource = { NULL };
+	state.service.setMIDIEventSource(noMIDIEventSource, NULL);
+	eventSource.playPendingEvents();
+	finishSMF(options, state);
+}
+
+static bool playSMFInSegments(smf_t *smf, const MT32Emu::Bit8u *fileBuffer, gsize fileBufferLength, const Options &options, State &state);
+
 static bool playFile(const gchar *inputFilename, const gchar *displayInputFilename, const Options &options, State &state) {
 	MT32Emu::Bit8u *fileBuffer = NULL;
 	gsize fileBufferLength = 0;
@@ -812,7 +977,9 @@ static bool playFile(const gchar *inputFilename, const gchar *displayInputFilena
 			free(decoded);
 		}
 		assert(smf->number_of_tracks >= 1);
-		playSMF(smf, options, state);
+		if (options.parallelSegments < 2 || !playSMFInSegments(smf, fileBuffer, fileBufferLength, options, state)) {
+			playSMF(smf, options, state);
+		}
 		smf_delete(smf);
 		return true;
 	}
@@ -942,6 +1109,372 @@ static bool loadROMs(MT32Emu::Service &service, const Options &options) {
 	return res;
 }
 
+static bool openSynth(MT32Emu::Service &service, const Options &options) {
+	service.setStereoOutputSampleRate(options.sampleRate);
+	service.setSamplerateConversionQuality(options.srcQuality);
+	service.setPartialCount(options.partialCount);
+	service.setAnalogOutputMode(options.analogOutputMode);
+	service.selectRendererType(options.rendererType);
+	if (service.openSynth() != MT32EMU_RC_OK) {
+		return false;
+	}
+	service.setDACInputMode(options.dacInputMode);
+	if (!options.niceAmpRamp) {
+		service.setNiceAmpRampEnabled(false);
+	}
+	if (options.nicePanning) {
+		service.setNicePanningEnabled(true);
+	}
+	if (options.nicePartialMixing) {
+		service.setNicePartialMixingEnabled(true);
+	}
+	return true;
+}
+
+static void *allocateStereoBuffer(unsigned long frameCount, OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
+	if (outputSampleFormat == OUTPUT_SAMPLE_FORMAT_IEEE_FLOAT32) {
+		return new float[frameCount * 2];
+	} else {
+		return new MT32Emu::Bit16s[frameCount * 2];
+	}
+}
+
+static void freeStereoBuffer(void *stereoSampleBuffer, OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
+	if (outputSampleFormat == OUTPUT_SAMPLE_FORMAT_IEEE_FLOAT32) {
+		delete[] static_cast<float *>(stereoSampleBuffer);
+	} else {
+		delete[] static_cast<MT32Emu::Bit16s *>(stereoSampleBuffer);
+	}
+}
+
+static inline void *getStereoFrame(void *stereoSampleBuffer, unsigned long frameIx, OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
+	if (outputSampleFormat == OUTPUT_SAMPLE_FORMAT_IEEE_FLOAT32) {
+		return static_cast<float *>(stereoSampleBuffer) + frameIx * 2;
+	} else {
+		return static_cast<MT32Emu::Bit16s *>(stereoSampleBuffer) + frameIx * 2;
+	}
+}
+
+static inline double getSample(void *sampleBuffer, unsigned long sampleIx, OUTPUT_SAMPLE_FORMAT outputSampleFormat) {
+	if (outputSampleFormat == OUTPUT_SAMPLE_FORMAT_IEEE_FLOAT32) {
+		return static_cast<float *>(sampleBuffer)[sampleIx];
+	} else {
+		return static_cast<MT32Emu::Bit16s *>(sampleBuffer)[sampleIx];
+	}
+}
+
+static inline bool isNoteMessage(MT32Emu::Bit32u msg) {
+	MT32Emu::Bit32u status = msg & 0xF0;
+	return status == 0x80 || status == 0x90 || status == 0xA0;
+}
+
+// A time segment of the MIDI file rendered by a separate synth instance. Frames are counted from the start of the file.
+struct Segment {
+	const Options *options;
+	MT32Emu::Service *service;
+	smf_t *smf;
+	bool logEvents;
+	unsigned long warmUpFrame;
+	unsigned long startFrame;
+	unsigned long endFrame;
+	void *stereoSampleBuffer;
+	GThread *thread;
+};
+
+// Advances the synth instance to the specified frame. Only the frames within the segment are stored, the warm-up is discarded.
+static void renderSegmentUntil(Segment &segment, unsigned long &segmentFrame, unsigned long untilFrame, void *discardBuffer) {
+	const Options &options = *segment.options;
+	while (segmentFrame < untilFrame) {
+		unsigned long frameCount;
+		void *stereoSampleBuffer;
+		if (segmentFrame < segment.startFrame) {
+			frameCount = MIN(MIN(untilFrame, segment.startFrame) - segmentFrame, options.bufferFrameCount);
+			stereoSampleBuffer = discardBuffer;
+		} else {
+			frameCount = MIN(untilFrame - segmentFrame, options.bufferFrameCount);
+			stereoSampleBuffer = getStereoFrame(segment.stereoSampleBuffer, segmentFrame - segment.startFrame, options.outputSampleFormat);
+		}
+		renderStereo(*segment.service, stereoSampleBuffer, (unsigned int)frameCount, options.outputSampleFormat);
+		segmentFrame += frameCount;
+	}
+}
+
+// Replays the MIDI file following the same timeline as playSMF() does. Up to the warm-up window, only the control stream
+// is sent to the synth, without rendering and skipping the notes. Then, the synth is rendered up to the end of the segment.
+static gpointer renderSegment(gpointer data) {
+	Segment &segment = *static_cast<Segment *>(data);
+	const Options &options = *segment.options;
+	MT32Emu::Service &service = *segment.service;
+	SysexAssembly sysexAssembly = {0, 0, NULL};
+	void *discardBuffer = allocateStereoBuffer(options.bufferFrameCount, options.outputSampleFormat);
+	unsigned long renderedFrames = 0;
+	unsigned long segmentFrame = segment.warmUpFrame;
+	smf_rewind(segment.smf);
+	for (;;) {
+		smf_event_t *event = smf_get_next_event(segment.smf);
+
+		if (event == NULL) {
+			break;
+		}
+
+		renderedFrames += getRenderLengthBeforeEvent(event, renderedFrames, renderedFrames, options);
+		renderSegmentUntil(segment, segmentFrame, MIN(renderedFrames, segment.endFrame), discardBuffer);
+		if (renderedFrames > segment.endFrame || renderedFrames == options.renderMaxFrames) {
+			break;
+		}
+
+		bool preRoll = renderedFrames < segment.warmUpFrame;
+		if (smf_event_is_metadata(event)) {
+			if (segment.logEvents && !options.quiet) {
+				char *decoded = smf_event_decode(event);
+				if (decoded) {
+					fprintf(stdout, "Metadata: %s\n", decoded);
+				}
+			}
+		} else if (smf_event_is_sysex(event) || smf_event_is_sysex_continuation(event))  {
+			unsigned char *buf;
+			int len;
+			if (assembleSysex(sysexAssembly, event, buf, len, segment.logEvents)) {
+				if (preRoll) {
+					service.playSysexNow(buf, len);
+				} else {
+					service.playSysex(buf, len);
+				}
+			}
+		} else {
+			MT32Emu::Bit32u msg;
+			if (makeShortMessage(event, msg, segment.logEvents)) {
+				if (!preRoll) {
+					service.playMsg(msg);
+				} else if (!isNoteMessage(msg)) {
+					service.playMsgNow(msg);
+				}
+			}
+		}
+	}
+	freeStereoBuffer(discardBuffer, options.outputSampleFormat);
+	delete[] sysexAssembly.unterminatedSysex;
+	return NULL;
+}
+
+// Compares the segment with the corresponding part of the sequential rendering and returns the max deviation found.
+static double verifySegment(const Segment &segment, unsigned int segmentIx, const Segment &sequential, const Options &options) {
+	void *sequentialSamples = getStereoFrame(sequential.stereoSampleBuffer, segment.startFrame, options.outputSampleFormat);
+	unsigned long sampleCount = (segment.endFrame - segment.startFrame) * 2;
+	double maxDeviation = 0;
+	for (unsigned long sampleIx = 0; sampleIx < sampleCount; sampleIx++) {
+		double deviation = fabs(getSample(segment.stereoSampleBuffer, sampleIx, options.outputSampleFormat)
+			- getSample(sequentialSamples, sampleIx, options.outputSampleFormat));
+		if (maxDeviation < deviation) maxDeviation = deviation;
+	}
+	if (maxDeviation > 0) {
+		fprintf(stderr, "Segment %u (frames %lu-%lu) does not match sequential rendering, max deviation: %g\n",
+			segmentIx + 1, segment.startFrame, segment.endFrame, maxDeviation);
+	} else if (!options.quiet) {
+		printf("Segment %u (frames %lu-%lu) matches sequential rendering\n", segmentIx + 1, segment.startFrame, segment.endFrame);
+	}
+	return maxDeviation;
+}
+
+// Returns the number of segments to render at a time, so that each is given a processor, sparing one for the reference rendering
+// when verifying.
+static unsigned int getSegmentWorkerCount(unsigned int segmentCount, bool verifySegments) {
+#if GLIB_CHECK_VERSION(2, 36, 0)
+	unsigned int processorCount = g_get_num_processors();
+#else
+	unsigned int processorCount = 2;
+#endif
+	if (verifySegments && processorCount > 1) processorCount--;
+	return MAX(1U, MIN(processorCount, segmentCount));
+}
+
+// Allocates the buffer for the rendered frames of the segment and starts rendering it in a new thread.
+static void startSegment(Segment &segment) {
+	segment.stereoSampleBuffer = allocateStereoBuffer(segment.endFrame - segment.startFrame, segment.options->outputSampleFormat);
+	segment.thread = g_thread_new("smf2wav-segment", renderSegment, &segment);
+}
+
+// Renders the MIDI file in time segments concurrently and writes each segment out in order as soon as it is complete, releasing
+// its buffer, then finishes as playSMF() does. A new segment is only started when a preceding one has been written out, so that
+// the number of segment buffers allocated at a time is bounded by the number of workers. The last segment is rendered
+// by the main synth instance, so that it is in the right state to render the tail.
+// Returns false if the segments cannot be set up, in which case the file is left for sequential rendering.
+static bool playSMFInSegments(smf_t *smf, const MT32Emu::Bit8u *fileBuffer, gsize fileBufferLength, const Options &options, State &state) {
+	const unsigned int segmentCount = options.parallelSegments;
+	const unsigned long totalFrames = getSMFRenderedFrames(smf, options, 0);
+	if (totalFrames < segmentCount) {
+		return false;
+	}
+	const unsigned long warmUpFrames = options.segmentWarmUpFrames < 0 ? DEFAULT_SEGMENT_WARM_UP_SECONDS * options.sampleRate : options.segmentWarmUpFrames;
+
+	// When verifying, an extra job renders the whole MIDI file sequentially, for reference.
+	const unsigned int jobCount = options.verifySegments ? segmentCount + 1 : segmentCount;
+	const unsigned int lastSegmentIx = segmentCount - 1;
+	Segment *jobs = new Segment[jobCount];
+	bool jobsReady = true;
+	for (unsigned int jobIx = 0; jobIx < jobCount; jobIx++) {
+		Segment &job = jobs[jobIx];
+		job.options = &options;
+		job.logEvents = jobIx == lastSegmentIx;
+		job.thread = NULL;
+		if (jobIx < segmentCount) {
+			job.startFrame = (unsigned long)(double(totalFrames) * jobIx / segmentCount);
+			job.endFrame = jobIx == lastSegmentIx ? totalFrames : (unsigned long)(double(totalFrames) * (jobIx + 1) / segmentCount);
+			job.warmUpFrame = job.startFrame > warmUpFrames ? job.startFrame - warmUpFrames : 0;
+		} else {
+			job.startFrame = 0;
+			job.endFrame = totalFrames;
+			job.warmUpFrame = 0;
+		}
+		job.stereoSampleBuffer = NULL;
+		if (jobIx == lastSegmentIx) {
+			job.service = &state.service;
+			job.smf = smf;
+			continue;
+		}
+		job.service = new MT32Emu::Service;
+		job.smf = smf_load_from_memory(fileBuffer, int(fileBufferLength));
+		job.service->createContext();
+		if (job.smf == NULL || !loadROMs(*job.service, options) || !openSynth(*job.service, options)) {
+			jobsReady = false;
+		}
+	}
+	if (jobsReady) {
+		const unsigned int workerCount = getSegmentWorkerCount(segmentCount, options.verifySegments != 0);
+		if (!options.quiet) {
+			printf("Rendering %lu frames in %u segments, %u at a time, with warm-up of %lu frames\n", totalFrames, segmentCount, workerCount, warmUpFrames);
+		}
+		if (options.verifySegments) {
+			startSegment(jobs[segmentCount]);
+		}
+		// The main thread is only busy writing the output, so the last segment is rendered in a thread as well.
+		for (unsigned int segmentIx = 0; segmentIx < workerCount; segmentIx++) {
+			startSegment(jobs[segmentIx]);
+		}
+		if (options.verifySegments) {
+			// The reference is needed in full to verify any segment.
+			g_thread_join(jobs[segmentCount].thread);
+			jobs[segmentCount].thread = NULL;
+		}
+		double maxDeviation = 0;
+		unsigned int mismatchedSegmentCount = 0;
+		for (unsigned int segmentIx = 0; segmentIx < segmentCount; segmentIx++) {
+			Segment &segment = jobs[segmentIx];
+			g_thread_join(segment.thread);
+			segment.thread = NULL;
+			if (options.verifySegments) {
+				double segmentMaxDeviation = verifySegment(segment, segmentIx, jobs[segmentCount], options);
+				if (segmentMaxDeviation > 0) mismatchedSegmentCount++;
+				if (maxDeviation < segmentMaxDeviation) maxDeviation = segmentMaxDeviation;
+			}
+			writeStereo(segment.stereoSampleBuffer, segment.endFrame - segment.startFrame, options, state);
+			freeStereoBuffer(segment.stereoSampleBuffer, options.outputSampleFormat);
+			segment.stereoSampleBuffer = NULL;
+			if (segmentIx + workerCount < segmentCount) {
+				startSegment(jobs[segmentIx + workerCount]);
+			}
+		}
+		if (options.verifySegments) {
+			printf("Verified %u segments against sequential rendering: %u mismatched, max deviation: %g\n", segmentCount, mismatchedSegmentCount, maxDeviation);
+		}
+		state.renderedFrames += totalFrames;
+	} else {
+		fprintf(stderr, "Failed to set up synth instances for parallel segments, rendering sequentially\n");
+	}
+	for (unsigned int jobIx = 0; jobIx < jobCount; jobIx++) {
+		Segment &job = jobs[jobIx];
+		if (job.stereoSampleBuffer != NULL) {
+			freeStereoBuffer(job.stereoSampleBuffer, options.outputSampleFormat);
+		}
+		if (jobIx == lastSegmentIx) continue;
+		if (job.smf != NULL) {
+			smf_delete(job.smf);
+		}
+		delete job.service;
+	}
+	delete[] jobs;
+	if (jobsReady) {
+		finishSMF(options, state);
+	}
+	return jobsReady;
+}
+
+// Renders the MIDI file in blocks of each benchmark size, with and without the low-latency rendering mode, discarding the output.
+// The synth is re-opened before each run, so that all runs start from the same state.
+static bool benchmarkSMF(smf_t *smf, const Options &options, MT32Emu::Service &service) {
+	const size_t blockSizeCount = sizeof(BENCHMARK_BLOCK_SIZES) / sizeof(BENCHMARK_BLOCK_SIZES[0]);
+	Options benchmarkOptions = options;
+	benchmarkOptions.quiet = true;
+	State state = {NULL, {NULL, NULL, NULL, NULL, NULL, NULL}, service, NULL, false, false, 0, 0, 0};
+	const unsigned long smfFrames = getSMFRenderedFrames(smf, benchmarkOptions, 0);
+	if (smfFrames == 0) return true;
+	void *stereoSampleBuffer = allocateStereoBuffer(BENCHMARK_BLOCK_SIZES[blockSizeCount - 1], options.outputSampleFormat);
+	const mt32emu_midi_event_source_i noMIDIEventSource = { NULL };
+	bool success = true;
+	for (size_t blockSizeIx = 0; success && blockSizeIx < blockSizeCount; blockSizeIx++) {
+		const unsigned int blockSize = BENCHMARK_BLOCK_SIZES[blockSizeIx];
+		for (int lowLatency = 0; lowLatency < 2; lowLatency++) {
+			service.closeSynth();
+			if (!openSynth(service, options)) {
+				fprintf(stderr, "Error re-opening MT32Emu synthesizer.\n");
+				success = false;
+				break;
+			}
+			service.setLowLatencyRenderingEnabled(lowLatency != 0);
+			SMFEventSource eventSource(smf, benchmarkOptions, state);
+			service.setMIDIEventSource(eventSource);
+			unsigned long callCount = 0;
+			gint64 startTime = g_get_monotonic_time();
+			for (unsigned long frameIx = 0; frameIx < smfFrames; frameIx += blockSize) {
+				renderStereo(service, stereoSampleBuffer, (unsigned int)MIN(blockSize, smfFrames - frameIx), options.outputSampleFormat);
+				callCount++;
+			}
+			gint64 elapsedTime = g_get_monotonic_time() - startTime;
+			service.setMIDIEventSource(noMIDIEventSource, NULL);
+			double renderedSeconds = double(smfFrames) / options.sampleRate;
+			printf("Block size %3u frames, low-latency rendering %s: %.3f usec per call, %.1fx real time\n", blockSize,
+				lowLatency ? "on " : "off", double(elapsedTime) / callCount, renderedSeconds * G_USEC_PER_SEC / MAX(elapsedTime, 1));
+		}
+	}
+	freeStereoBuffer(stereoSampleBuffer, options.outputSampleFormat);
+	return success;
+}
+
+static bool runBenchmark(const Options &options, MT32Emu::Service &service) {
+	service.createContext();
+	bool success = loadROMs(service, options);
+	if (success && !openSynth(service, options)) {
+		fprintf(stderr, "Error opening MT32Emu synthesizer.\n");
+		success = false;
+	}
+	if (success) {
+		Options benchmarkOptions = options;
+		benchmarkOptions.sampleRate = service.getActualStereoOutputSamplerate();
+		printf("Using output sample rate %d Hz\n", benchmarkOptions.sampleRate);
+		for (gchar **inputFilename = options.inputFilenames; success && *inputFilename != NULL; inputFilename++) {
+			char *inputFilenameUtf8 = g_filename_to_utf8(*inputFilename, strlen(*inputFilename), NULL, NULL, NULL);
+			char *inputFilenameLocale = g_locale_from_utf8(inputFilenameUtf8, strlen(inputFilenameUtf8), NULL, NULL, NULL);
+			MT32Emu::Bit8u *fileBuffer = NULL;
+			gsize fileBufferLength = 0;
+			if (loadFile(fileBuffer, fileBufferLength, *inputFilename, inputFilenameLocale)) {
+				smf_t *smf = fileBuffer[0] == 0xF0 ? NULL : smf_load_from_memory(fileBuffer, int(fileBufferLength));
+				if (smf != NULL) {
+					printf("Benchmarking '%s'\n", inputFilenameLocale);
+					success = benchmarkSMF(smf, benchmarkOptions, service);
+					smf_delete(smf);
+				} else {
+					fprintf(stderr, "Skipping file '%s' that is not an SMF file.\n", inputFilenameLocale);
+				}
+				g_free(fileBuffer);
+			}
+			g_free(inputFilenameLocale);
+			g_free(inputFilenameUtf8);
+		}
+	}
+	service.freeContext();
+	return success;
+}
+
 int main(int argc, char *argv[]) {
 	Options options;
 	MT32Emu::Service service;
@@ -958,6 +1491,11 @@ int main(int argc, char *argv[]) {
 	if (!parseOptions(argc, argv, &options)) {
 		return -1;
 	}
+	if (options.benchmark) {
+		int exitCode = runBenchmark(options, service) ? 0 : 1;
+		freeOptions(&options);
+		return exitCode;
+	}
 	gchar *outputFilename;
 	if (options.outputFilename != NULL) {
 		outputFilename = options.outputFilename;
@@ -986,22 +1524,7 @@ int main(int argc, char *argv[]) {
 		freeOptions(&options);
 		return 1;
 	}
-	service.setStereoOutputSampleRate(options.sampleRate);
-	service.setSamplerateConversionQuality(options.srcQuality);
-	service.setPartialCount(options.partialCount);
-	service.setAnalogOutputMode(options.analogOutputMode);
-	service.selectRendererType(options.rendererType);
-	if (service.openSynth() == MT32EMU_RC_OK) {
-		service.setDACInputMode(options.dacInputMode);
-		if (!options.niceAmpRamp) {
-			service.setNiceAmpRampEnabled(false);
-		}
-		if (options.nicePanning) {
-			service.setNicePanningEnabled(true);
-		}
-		if (options.nicePartialMixing) {
-			service.setNicePartialMixingEnabled(true);
-		}
+	if (openSynth(service, options)) {
 		options.sampleRate = service.getActualStereoOutputSamplerate();
 		printf("Using output sample rate %d Hz\n", options.sampleRate);
 
@@ -1029,7 +1552,7 @@ int main(int argc, char *argv[]) {
 #endif
 		}
 
-		clock_t startTime = clock();
+		gint64 startTime = g_get_monotonic_time();
 
 		if (outputFile != NULL) {
 			if (options.rawChannelCount > 0 || writeWAVEHeader(outputFile, options.sampleRate, options.outputSampleFormat)) {
@@ -1078,7 +1601,7 @@ int main(int argc, char *argv[]) {
 				fprintf(stderr, "Error writing WAVE header to '%s'\n", outputFilenameLocale);
 			}
 			fclose(outputFile);
-			printf("Elapsed time: %f sec\n", float(clock() - startTime) / CLOCKS_PER_SEC);
+			printf("Elapsed time: %f sec\n", float(g_get_monotonic_time() - startTime) / G_USEC_PER_SEC);
 		} else {
 			fprintf(stderr, "Error opening file '%s' for writing.\n", outputFilenameLocale);
 		}